@@ -0,0 +1,191 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Usage: renderer_bench [--filter <substring>] [--json <file>] [--min-time <seconds>] [--repetitions <n>]
+
+struct BenchEntry {
+    std::string name;
+    BenchFunction function;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;       // Median over repetitions
+    double nsPerOpMin;
+    double nsPerOpStddev;
+    double itemsPerSecond;
+    std::map<std::string, double> counters;
+};
+
+static std::vector<BenchEntry>& registry() {
+    static std::vector<BenchEntry> entries;
+    return entries;
+}
+
+void RegisterBenchmark(const char* name, BenchFunction function) {
+    registry().push_back({name, function});
+}
+
+static double runOnce(const BenchEntry& entry, Bench& bench) {
+    auto start = std::chrono::steady_clock::now();
+    entry.function(bench);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static BenchResult runBenchmark(const BenchEntry& entry, double minTime, int repetitions) {
+    // Calibrate: grow the iteration count until one run takes at least minTime
+    Bench bench;
+    double elapsed = runOnce(entry, bench);
+    while (elapsed < minTime * 1e9 && bench.iterations < (1ull << 40)) {
+        double scale = elapsed > 0.0 ? (minTime * 1e9 * 1.2) / elapsed : 10.0;
+        scale = std::clamp(scale, 1.5, 10.0);
+        bench.iterations = static_cast<uint64_t>(std::ceil(bench.iterations * scale));
+        bench.counters.clear();
+        elapsed = runOnce(entry, bench);
+    }
+
+    std::vector<double> samples;
+    std::map<std::string, double> counterSums;
+    for (int r = 0; r < repetitions; r++) {
+        bench.counters.clear();
+        samples.push_back(runOnce(entry, bench) / bench.iterations);
+        for (const auto& counter : bench.counters) {
+            counterSums[counter.first] += counter.second;
+        }
+    }
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    double mean = 0.0;
+    for (double s : samples) mean += s;
+    mean /= samples.size();
+    double variance = 0.0;
+    for (double s : samples) variance += (s - mean) * (s - mean);
+    variance /= samples.size();
+
+    BenchResult result;
+    result.name = entry.name;
+    result.iterations = bench.iterations;
+    result.nsPerOp = sorted[sorted.size() / 2];
+    result.nsPerOpMin = sorted.front();
+    result.nsPerOpStddev = std::sqrt(variance);
+    result.itemsPerSecond = bench.itemsPerIteration * 1e9 / result.nsPerOp;
+    for (const auto& sum : counterSums) {
+        result.counters[sum.first] = sum.second / repetitions;
+    }
+    return result;
+}
+
+static void writeJson(const std::string& path, const std::vector<BenchResult>& results,
+                      double minTime, int repetitions) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"optimized\": true,\n";
+#else
+    out << "    \"optimized\": false,\n";
+#endif
+    out << "    \"min_time_s\": " << minTime << ",\n";
+    out << "    \"repetitions\": " << repetitions << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << r.name << "\",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"ns_per_op\": " << r.nsPerOp << ",\n";
+        out << "      \"ns_per_op_min\": " << r.nsPerOpMin << ",\n";
+        out << "      \"ns_per_op_stddev\": " << r.nsPerOpStddev << ",\n";
+        out << "      \"items_per_second\": " << r.itemsPerSecond << ",\n";
+        out << "      \"counters\": {";
+        size_t c = 0;
+        for (const auto& counter : r.counters) {
+            out << (c++ == 0 ? "" : ", ") << "\"" << counter.first << "\": " << counter.second;
+        }
+        out << "}\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string jsonPath = "bench_results.json";
+    double minTime = 0.2;
+    int repetitions = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            minTime = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter <substring>] [--json <file>] [--min-time <seconds>] [--repetitions <n>]" << std::endl;
+            return 1;
+        }
+    }
+
+#ifndef NDEBUG
+    std::cerr << "Warning: renderer_bench was built without optimizations, numbers are not representative" << std::endl;
+#endif
+
+    std::vector<BenchEntry> entries = registry();
+    std::sort(entries.begin(), entries.end(), [](const BenchEntry& a, const BenchEntry& b) {
+        return a.name < b.name;
+    });
+
+    std::printf("%-36s %14s %14s %16s  %s\n", "Benchmark", "ns/op", "iterations", "items/s", "counters");
+    std::vector<BenchResult> results;
+    for (const BenchEntry& entry : entries) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        BenchResult r = runBenchmark(entry, minTime, repetitions);
+        std::string counters;
+        for (const auto& counter : r.counters) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%s=%g ", counter.first.c_str(), counter.second);
+            counters += buffer;
+        }
+        std::printf("%-36s %14.1f %14llu %16.4g  %s\n", r.name.c_str(), r.nsPerOp,
+                    static_cast<unsigned long long>(r.iterations), r.itemsPerSecond, counters.c_str());
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    writeJson(jsonPath, results, minTime, repetitions);
+    std::printf("Results written to %s\n", jsonPath.c_str());
+    return 0;
+}
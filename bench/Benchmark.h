@@ -0,0 +1,47 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Minimal micro-benchmark harness for renderer_bench.
+// A benchmark is a function that runs its kernel bench.iterations times.
+// The harness calibrates the iteration count, repeats the measurement and
+// reports ns/op, items/s and any counters the benchmark sets.
+class Bench {
+public:
+    uint64_t iterations = 1;
+
+    // Work items processed per iteration (points, samples, chunks...)
+    double itemsPerIteration = 1.0;
+
+    // Extra values reported as-is (averaged over repetitions)
+    std::map<std::string, double> counters;
+};
+
+typedef void (*BenchFunction)(Bench& bench);
+
+void RegisterBenchmark(const char* name, BenchFunction function);
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, BenchFunction function) {
+        RegisterBenchmark(name, function);
+    }
+};
+
+#define RENDERER_BENCHMARK(function) \
+    static BenchRegistrar benchRegistrar_##function(#function, function)
+
+// Keep the compiler from discarding a computed value
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+#endif // BENCHMARK_H
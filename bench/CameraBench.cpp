@@ -0,0 +1,29 @@
+#include "Benchmark.h"
+#include "../include/Camera.h"
+#include <cmath>
+
+// Camera view-projection construction (the per-frame CPU side of Camera::Matrix)
+
+static void CameraMatrix(Bench& bench) {
+    Camera camera(1300, 900, glm::vec3(0.0f, 80.0f, 2.0f));
+    float angle = 0.0f;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        angle += 0.001f;
+        camera.Orientation = glm::vec3(std::cos(angle), -0.2f, std::sin(angle));
+        glm::mat4 matrix = camera.GetMatrix(45.0f, 0.1f, 100.0f);
+        DoNotOptimize(matrix);
+    }
+}
+RENDERER_BENCHMARK(CameraMatrix);
+
+static void CameraInverseViewProjection(Bench& bench) {
+    Camera camera(1300, 900, glm::vec3(0.0f, 80.0f, 2.0f));
+    float angle = 0.0f;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        angle += 0.001f;
+        camera.Orientation = glm::vec3(std::cos(angle), -0.2f, std::sin(angle));
+        glm::mat4 inverse = glm::inverse(camera.GetMatrix(45.0f, 0.1f, 100.0f));
+        DoNotOptimize(inverse);
+    }
+}
+RENDERER_BENCHMARK(CameraInverseViewProjection);
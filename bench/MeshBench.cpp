@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include "../include/BlockMesher.h"
+#include "../include/EndTerrain.h"
+#include <vector>
+
+// Section meshing: greedy vs one quad per face on voxelized End terrain
+
+// Padded 18^3 solid flags of one section, as BlockRenderer builds them
+struct Section {
+    std::vector<uint8_t> blocks;
+    int solid = 0;
+};
+
+static Section voxelizeSection(int chunkX, int sectionY, int chunkZ) {
+    EndTerrain terrain;
+    Section section;
+    section.blocks.resize(BlockMesher::PADDED * BlockMesher::PADDED * BlockMesher::PADDED);
+    for (int y = -1; y <= BlockMesher::SIZE; y++) {
+        for (int z = -1; z <= BlockMesher::SIZE; z++) {
+            for (int x = -1; x <= BlockMesher::SIZE; x++) {
+                float density = terrain.Density(chunkX * 16.0f + x + 0.5f, sectionY * 16.0f + y + 0.5f,
+                                                chunkZ * 16.0f + z + 0.5f);
+                section.blocks[BlockMesher::Index(x, y, z)] = density > 0.0f ? 1 : 0;
+                bool inside = x >= 0 && x < BlockMesher::SIZE && y >= 0 && y < BlockMesher::SIZE &&
+                              z >= 0 && z < BlockMesher::SIZE;
+                section.solid += inside && density > 0.0f;
+            }
+        }
+    }
+    return section;
+}
+
+// Counters: quads emitted, exposed faces (one quad each without merging) and
+// the reduction over those and over six faces per solid block
+static void runMeshSection(Bench& bench, const Section& section, bool greedy) {
+    BlockMesher::Mesh mesh;
+    bench.itemsPerIteration = 1;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        BlockMesher::MeshSection(section.blocks.data(), greedy, mesh);
+        DoNotOptimize(mesh.vertices.data());
+    }
+    double quads = mesh.quads > 0 ? mesh.quads : 1.0;
+    bench.counters["quads"] = mesh.quads;
+    bench.counters["faces"] = mesh.faces;
+    bench.counters["face_reduction"] = mesh.faces / quads;
+    bench.counters["block_face_reduction"] = section.solid * 6.0 / quads;
+}
+
+// Top of the main island
+static const Section& mainIslandSection() {
+    static const Section section = voxelizeSection(-18, 4, -2);
+    return section;
+}
+static void MeshSection_MainIslandGreedy(Bench& bench) { runMeshSection(bench, mainIslandSection(), true); }
+static void MeshSection_MainIslandNaive(Bench& bench) { runMeshSection(bench, mainIslandSection(), false); }
+RENDERER_BENCHMARK(MeshSection_MainIslandGreedy);
+RENDERER_BENCHMARK(MeshSection_MainIslandNaive);
+
+// Small, noisy outer island
+static const Section& outerIslandSection() {
+    static const Section section = voxelizeSection(94, 3, 102);
+    return section;
+}
+static void MeshSection_OuterIslandGreedy(Bench& bench) { runMeshSection(bench, outerIslandSection(), true); }
+static void MeshSection_OuterIslandNaive(Bench& bench) { runMeshSection(bench, outerIslandSection(), false); }
+RENDERER_BENCHMARK(MeshSection_OuterIslandGreedy);
+RENDERER_BENCHMARK(MeshSection_OuterIslandNaive);
@@ -0,0 +1,66 @@
+#include "Benchmark.h"
+#include "../include/EndNoise.h"
+#include <vector>
+
+// Noise kernels on a fixed batch of pseudo-random points
+
+static const int BATCH_SIZE = 1024;
+
+static const std::vector<float>& samplePoints() {
+    static std::vector<float> points;
+    if (points.empty()) {
+        uint32_t state = 12345u;
+        points.resize(BATCH_SIZE * 3);
+        for (float& p : points) {
+            state = state * 1664525u + 1013904223u;
+            p = (state >> 8) * (1.0f / 16777216.0f) * 200.0f - 100.0f;
+        }
+    }
+    return points;
+}
+
+static void Simplex2D(Bench& bench) {
+    const std::vector<float>& p = samplePoints();
+    bench.itemsPerIteration = BATCH_SIZE;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float sum = 0.0f;
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            sum += EndNoise::simplex2D(p[i * 3], p[i * 3 + 1]);
+        }
+        DoNotOptimize(sum);
+    }
+}
+RENDERER_BENCHMARK(Simplex2D);
+
+static void Simplex3D(Bench& bench) {
+    const std::vector<float>& p = samplePoints();
+    bench.itemsPerIteration = BATCH_SIZE;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float sum = 0.0f;
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            sum += EndNoise::simplex3D(p[i * 3], p[i * 3 + 1], p[i * 3 + 2]);
+        }
+        DoNotOptimize(sum);
+    }
+}
+RENDERER_BENCHMARK(Simplex3D);
+
+static void runFbm(Bench& bench, int octaves) {
+    const std::vector<float>& p = samplePoints();
+    bench.itemsPerIteration = BATCH_SIZE;
+    bench.counters["octaves"] = octaves;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float sum = 0.0f;
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            sum += EndNoise::fbm3D(p[i * 3], p[i * 3 + 1], p[i * 3 + 2], octaves);
+        }
+        DoNotOptimize(sum);
+    }
+}
+
+static void Fbm3D_2Octaves(Bench& bench) { runFbm(bench, 2); }
+static void Fbm3D_4Octaves(Bench& bench) { runFbm(bench, 4); }
+static void Fbm3D_6Octaves(Bench& bench) { runFbm(bench, 6); }
+RENDERER_BENCHMARK(Fbm3D_2Octaves);
+RENDERER_BENCHMARK(Fbm3D_4Octaves);
+RENDERER_BENCHMARK(Fbm3D_6Octaves);
@@ -0,0 +1,103 @@
+#include "Benchmark.h"
+#include "../include/ChunkSection.h"
+#include "../include/EndTerrain.h"
+#include <vector>
+
+// Palette-compressed chunk sections: random access, iteration and memory
+
+// Voxelized main island flank, two palette entries (1 bit per block)
+static const ChunkSection& terrainSection() {
+    static const ChunkSection section = [] {
+        EndTerrain terrain;
+        std::vector<ChunkSection::BlockId> blocks(ChunkSection::VOLUME);
+        for (int y = 0; y < ChunkSection::SIZE; y++) {
+            for (int z = 0; z < ChunkSection::SIZE; z++) {
+                for (int x = 0; x < ChunkSection::SIZE; x++) {
+                    float density = terrain.Density(-18 * 16.0f + x + 0.5f, 64.0f + y + 0.5f, -2 * 16.0f + z + 0.5f);
+                    blocks[ChunkSection::Index(x, y, z)] = density > 0.0f ? ChunkSection::END_STONE : ChunkSection::AIR;
+                }
+            }
+        }
+        return ChunkSection::FromBlocks(blocks.data());
+    }();
+    return section;
+}
+
+// 12 distinct ids scattered at random, 4 bits per block
+static const ChunkSection& mixedSection() {
+    static const ChunkSection section = [] {
+        std::vector<ChunkSection::BlockId> blocks(ChunkSection::VOLUME);
+        uint32_t state = 7u;
+        for (auto& block : blocks) {
+            state = state * 1664525u + 1013904223u;
+            block = static_cast<ChunkSection::BlockId>((state >> 16) % 12);
+        }
+        return ChunkSection::FromBlocks(blocks.data());
+    }();
+    return section;
+}
+
+static void runRandomAccess(Bench& bench, const ChunkSection& section) {
+    std::vector<int> indices(4096);
+    uint32_t state = 1u;
+    for (int& index : indices) {
+        state = state * 1664525u + 1013904223u;
+        index = (state >> 8) % ChunkSection::VOLUME;
+    }
+    bench.itemsPerIteration = static_cast<double>(indices.size());
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        uint32_t sum = 0;
+        for (int index : indices) {
+            sum += section.GetIndex(index);
+        }
+        DoNotOptimize(sum);
+    }
+    bench.counters["bits_per_entry"] = section.GetBitsPerEntry();
+    bench.counters["bytes"] = static_cast<double>(section.GetMemoryBytes());
+    bench.counters["float_ratio"] = ChunkSection::VOLUME * sizeof(float) / static_cast<double>(section.GetMemoryBytes());
+}
+
+static void runUnpack(Bench& bench, const ChunkSection& section) {
+    std::vector<ChunkSection::BlockId> blocks(ChunkSection::VOLUME);
+    bench.itemsPerIteration = ChunkSection::VOLUME;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        section.Unpack(blocks.data());
+        DoNotOptimize(blocks.data());
+    }
+}
+
+static void SectionGet_Terrain(Bench& bench) { runRandomAccess(bench, terrainSection()); }
+static void SectionGet_Mixed(Bench& bench) { runRandomAccess(bench, mixedSection()); }
+static void SectionUnpack_Terrain(Bench& bench) { runUnpack(bench, terrainSection()); }
+static void SectionUnpack_Mixed(Bench& bench) { runUnpack(bench, mixedSection()); }
+RENDERER_BENCHMARK(SectionGet_Terrain);
+RENDERER_BENCHMARK(SectionGet_Mixed);
+RENDERER_BENCHMARK(SectionUnpack_Terrain);
+RENDERER_BENCHMARK(SectionUnpack_Mixed);
+
+// Building from a voxelized block array and editing single blocks
+static void SectionFromBlocks_Terrain(Bench& bench) {
+    std::vector<ChunkSection::BlockId> blocks(ChunkSection::VOLUME);
+    terrainSection().Unpack(blocks.data());
+    bench.itemsPerIteration = ChunkSection::VOLUME;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        ChunkSection section = ChunkSection::FromBlocks(blocks.data());
+        DoNotOptimize(section);
+    }
+}
+RENDERER_BENCHMARK(SectionFromBlocks_Terrain);
+
+static void SectionSet_Terrain(Bench& bench) {
+    ChunkSection section = terrainSection();
+    bench.itemsPerIteration = ChunkSection::VOLUME;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        for (int index = 0; index < ChunkSection::VOLUME; index++) {
+            int x = index & 15;
+            int z = (index >> 4) & 15;
+            int y = index >> 8;
+            section.Set(x, y, z, section.Get(x, y, z) == ChunkSection::AIR ? ChunkSection::END_STONE : ChunkSection::AIR);
+        }
+        DoNotOptimize(section);
+    }
+}
+RENDERER_BENCHMARK(SectionSet_Terrain);
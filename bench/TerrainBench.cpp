@@ -0,0 +1,112 @@
+#include "Benchmark.h"
+#include "../include/EndTerrain.h"
+#include <cmath>
+#include <vector>
+
+// End density field: point batches per region, column scans and full chunk fills
+
+static const int BATCH_SIZE = 4096;
+
+// Points spread over an annulus [minRadius, maxRadius) around the origin
+static std::vector<float> makeBatch(float minRadius, float maxRadius, uint32_t seed) {
+    std::vector<float> points(BATCH_SIZE * 3);
+    uint32_t state = seed;
+    auto next = [&state] {
+        state = state * 1664525u + 1013904223u;
+        return (state >> 8) * (1.0f / 16777216.0f);
+    };
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        float angle = next() * 6.2831853f;
+        float radius = minRadius + next() * (maxRadius - minRadius);
+        points[i * 3] = radius * std::cos(angle);
+        points[i * 3 + 1] = EndTerrain::MIN_Y + next() * (EndTerrain::MAX_Y - EndTerrain::MIN_Y);
+        points[i * 3 + 2] = radius * std::sin(angle);
+    }
+    return points;
+}
+
+static void runDensityBatch(Bench& bench, const std::vector<float>& points) {
+    EndTerrain terrain;
+    bench.itemsPerIteration = BATCH_SIZE;
+    int solid = 0;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float sum = 0.0f;
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            float d = terrain.Density(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]);
+            sum += d;
+            solid += d > 0.0f;
+        }
+        DoNotOptimize(sum);
+    }
+    bench.counters["solid_fraction"] = static_cast<double>(solid) / (BATCH_SIZE * bench.iterations);
+}
+
+static void EndDensity_MainIsland(Bench& bench) {
+    static const std::vector<float> points = makeBatch(0.0f, EndTerrain::MAIN_ISLAND_RADIUS, 1u);
+    runDensityBatch(bench, points);
+}
+RENDERER_BENCHMARK(EndDensity_MainIsland);
+
+static void EndDensity_ExclusionZone(Bench& bench) {
+    static const std::vector<float> points = makeBatch(EndTerrain::EXCLUSION_ZONE_START, EndTerrain::EXCLUSION_ZONE_END, 2u);
+    runDensityBatch(bench, points);
+}
+RENDERER_BENCHMARK(EndDensity_ExclusionZone);
+
+static void EndDensity_OuterIslands(Bench& bench) {
+    static const std::vector<float> points = makeBatch(EndTerrain::EXCLUSION_ZONE_END, 20000.0f, 3u);
+    runDensityBatch(bench, points);
+}
+RENDERER_BENCHMARK(EndDensity_OuterIslands);
+
+static void SampleColumn_MainIsland(Bench& bench) {
+    EndTerrain terrain;
+    bench.itemsPerIteration = 256;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float sum = 0.0f;
+        for (int i = 0; i < 256; i++) {
+            sum += terrain.SampleColumn(-128.0f + i, 37.0f).topY;
+        }
+        DoNotOptimize(sum);
+    }
+}
+RENDERER_BENCHMARK(SampleColumn_MainIsland);
+
+static void SampleColumn_OuterIslands(Bench& bench) {
+    EndTerrain terrain;
+    bench.itemsPerIteration = 256;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float sum = 0.0f;
+        for (int i = 0; i < 256; i++) {
+            sum += terrain.SampleColumn(3000.0f + i * 4.0f, 2000.0f).topY;
+        }
+        DoNotOptimize(sum);
+    }
+}
+RENDERER_BENCHMARK(SampleColumn_OuterIslands);
+
+// Chunk generation: density at every block of a 16 x 128 x 16 chunk
+static void runChunkFill(Bench& bench, int chunkX, int chunkZ) {
+    EndTerrain terrain;
+    std::vector<float> density(16 * 128 * 16);
+    bench.itemsPerIteration = static_cast<double>(density.size());
+    int solid = 0;
+    for (uint64_t it = 0; it < bench.iterations; it++) {
+        float* out = density.data();
+        for (int y = 0; y < 128; y++) {
+            for (int z = 0; z < 16; z++) {
+                for (int x = 0; x < 16; x++) {
+                    *out++ = terrain.Density(chunkX * 16.0f + x, static_cast<float>(y), chunkZ * 16.0f + z);
+                }
+            }
+        }
+        for (float d : density) solid += d > 0.0f;
+        DoNotOptimize(density.data());
+    }
+    bench.counters["solid_blocks"] = static_cast<double>(solid) / bench.iterations;
+}
+
+static void ChunkGeneration_MainIsland(Bench& bench) { runChunkFill(bench, 3, -2); }
+static void ChunkGeneration_OuterIslands(Bench& bench) { runChunkFill(bench, 100, 82); }
+RENDERER_BENCHMARK(ChunkGeneration_MainIsland);
+RENDERER_BENCHMARK(ChunkGeneration_OuterIslands);
@@ -0,0 +1,89 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Set to 0 (CMake RENDERER_ALLOC_TRACKING=OFF) to keep the default global
+// operator new and compile the scopes below out
+#ifndef ALLOC_TRACKING_ENABLED
+#define ALLOC_TRACKING_ENABLED 1
+#endif
+
+// Heap allocation counters fed by a replacement global operator new.
+// Every allocation is charged to the calling thread's current tag
+// (ALLOC_SCOPE), and EndFrame turns the running totals into per-frame
+// numbers. Allocations made directly through malloc (GLFW, drivers) are
+// not seen.
+namespace AllocTracker {
+    static const int MAX_TAGS = 32;
+
+    struct TagStats {
+        const char* name;
+        uint64_t count;         // Last frame
+        uint64_t bytes;
+        double averageCount;    // Over roughly the last second
+        double averageBytes;
+        uint64_t peakCount;
+    };
+
+    // Returns the tag index for name (deduplicated), 0 = "untagged"
+    int RegisterTag(const char* name);
+
+    // Charges this thread's allocations to tag for the scope's lifetime
+    class TagScope {
+    public:
+        explicit TagScope(int tag);
+        ~TagScope();
+
+        TagScope(const TagScope&) = delete;
+        TagScope& operator=(const TagScope&) = delete;
+
+    private:
+        int previous;
+    };
+
+    // Allocations on this thread inside the scope are violations
+    class NoAllocScope {
+    public:
+        explicit NoAllocScope(const char* region);
+        ~NoAllocScope();
+
+        NoAllocScope(const NoAllocScope&) = delete;
+        NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+    private:
+        const char* previous;
+    };
+
+    // Violations assert() on the allocating thread (debug builds) instead
+    // of only being counted and logged at the end of the frame
+    void SetAssertOnViolation(bool enabled);
+
+    void EndFrame();
+
+    int GetTagCount();
+    const TagStats& GetTagStats(int tag);
+    uint64_t GetFrameAllocations();
+    uint64_t GetFrameBytes();
+    uint64_t GetTotalViolations();
+
+    // "Allocations" window: per-tag counts and bytes per frame
+    void DrawWindow(bool* open);
+}
+
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+
+#if ALLOC_TRACKING_ENABLED
+#define ALLOC_SCOPE(name) \
+    static const int ALLOC_CONCAT(allocTag_, __LINE__) = AllocTracker::RegisterTag("" name); \
+    AllocTracker::TagScope ALLOC_CONCAT(allocScope_, __LINE__)(ALLOC_CONCAT(allocTag_, __LINE__))
+#define NO_ALLOC_SCOPE(region) \
+    AllocTracker::NoAllocScope ALLOC_CONCAT(noAllocScope_, __LINE__)("" region)
+#else
+#define ALLOC_SCOPE(name) ((void)0)
+#define NO_ALLOC_SCOPE(region) ((void)0)
+#endif
+
+#endif // ALLOC_TRACKER_H
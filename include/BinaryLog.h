@@ -0,0 +1,109 @@
+#ifndef BINARY_LOG_H
+#define BINARY_LOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Compact binary log file (.blog), written by Logger when the binary file
+// format is selected and turned back into text or JSON by log_decode.
+//
+// Layout: "ELB1", int64 wall clock offset (wall = monotonic + offset, ns),
+// int64 monotonic start time (ns), then records:
+//   SITE    tag, varint id, uint8 level, varint line, string file, string format
+//   MESSAGE tag, varint site id, varint ns since previous record, string packed args
+// Strings are a varint length followed by the bytes. A call site is
+// described once; every message after that only carries its id, the
+// timestamp delta and the LogArgs-packed arguments.
+namespace BinaryLog {
+    enum RecordTag : uint8_t {
+        SITE = 1,
+        MESSAGE = 2
+    };
+
+    // Format used for messages that were logged as a plain string
+    extern const char* const PLAIN_FORMAT;
+}
+
+class BinaryLogWriter {
+public:
+    // Maps a source file to the path stored in the log (called once per site)
+    std::function<std::string(const char*)> fileDisplayName;
+
+    bool Open(const std::string& path, int64_t wallClockOffsetNs, int64_t startNs);
+    bool IsOpen() const { return file.is_open(); }
+    uint64_t GetBytesWritten() const { return bytesWritten; }
+
+    // format == nullptr means packedArgs is not packed, but the plain message text
+    void Write(uint8_t level, const char* sourceFile, int line, const char* format,
+               const std::string& message, int64_t timeNs);
+    void Flush();
+    void Close();
+
+private:
+    struct SiteKey {
+        const char* file;
+        const char* format;
+        int line;
+        uint8_t level;
+        bool operator==(const SiteKey& other) const {
+            return file == other.file && format == other.format && line == other.line && level == other.level;
+        }
+    };
+    struct SiteKeyHash {
+        size_t operator()(const SiteKey& key) const {
+            size_t hash = std::hash<const void*>()(key.file) ^ (std::hash<const void*>()(key.format) << 1);
+            return hash ^ (static_cast<size_t>(key.line) << 8) ^ key.level;
+        }
+    };
+
+    std::ofstream file;
+    std::unordered_map<SiteKey, uint32_t, SiteKeyHash> sites;
+    std::string buffer;
+    std::string packed;
+    int64_t lastTimeNs = 0;
+    uint64_t bytesWritten = 0;
+};
+
+// Reads plain or gzip-compressed (rotated) .blog files
+class BinaryLogReader {
+public:
+    struct Entry {
+        uint8_t level;
+        const std::string* file;
+        int line;
+        const std::string* format;
+        std::string packedArgs;
+        int64_t monotonicNs;
+        int64_t wallClockNs;
+    };
+
+    BinaryLogReader() = default;
+    ~BinaryLogReader();
+    BinaryLogReader(const BinaryLogReader&) = delete;
+    BinaryLogReader& operator=(const BinaryLogReader&) = delete;
+
+    bool Open(const std::string& path);
+
+    // Returns false at the end of the file or on a truncated record.
+    // The file/format pointers stay valid until the next call.
+    bool Next(Entry& entry);
+
+private:
+    struct Site {
+        uint8_t level;
+        int line;
+        std::string file;
+        std::string format;
+    };
+
+    void* file = nullptr;   // gzFile
+    std::vector<Site> sites;
+    int64_t wallClockOffsetNs = 0;
+    int64_t timeNs = 0;
+};
+
+#endif // BINARY_LOG_H
@@ -0,0 +1,36 @@
+#ifndef BLOCK_MESHER_H
+#define BLOCK_MESHER_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+// Face meshes of 16^3 chunk sections of solid/air blocks.
+// Greedy meshing merges coplanar exposed faces into rectangles slice by
+// slice (Lysenko, "Meshing in a Minecraft Game"); the block pattern is
+// restored per block in shaders/block.frag from the world position.
+class BlockMesher {
+public:
+    static const int SIZE = 16;             // Blocks per side of a section
+    static const int PADDED = SIZE + 2;     // With a one-block border from the neighbours
+    static const int FLOATS_PER_VERTEX = 4; // Section-local x, y, z and face (0..5 = +x -x +y -y +z -z)
+
+    struct Mesh {
+        std::vector<GLfloat> vertices;      // Four per quad, counter-clockwise seen from outside
+        std::vector<GLuint> indices;        // Six per quad
+        int quads = 0;
+        int faces = 0;                      // Exposed block faces, the quads naive meshing emits
+    };
+
+    // Solid flags of a padded section, x fastest then z then y, so the
+    // sections of a padded column are contiguous slices of it
+    static int Index(int x, int y, int z) { return (x + 1) + PADDED * ((z + 1) + PADDED * (y + 1)); }
+
+    // greedy = false emits one quad per exposed face
+    static void MeshSection(const uint8_t* blocks, bool greedy, Mesh& mesh);
+
+private:
+    static void EmitQuad(Mesh& mesh, int axis, int side, int slice, int i, int j, int width, int height);
+};
+
+#endif // BLOCK_MESHER_H
@@ -0,0 +1,154 @@
+#ifndef BLOCK_RENDERER_H
+#define BLOCK_RENDERER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "BlockMesher.h"
+#include "Camera.h"
+#include "ChunkSection.h"
+#include "EBO.h"
+#include "GpuProfiler.h"
+#include "shaderClass.h"
+#include "ThreadPool.h"
+#include "VAO.h"
+#include "VBO.h"
+#include "VoxelVolume.h"
+
+// Minecraft-style block view of the End (shaders/block.*).
+// The density is voxelized at block centres into 16^3 chunk sections, which
+// BlockMesher turns into quads on worker threads; chunk columns within
+// viewRadius are streamed nearest first and dropped once out of range.
+// Resident columns keep their blocks as palette-compressed ChunkSections.
+// With voxelTrace the same blocks are ray traced exactly through a
+// VoxelVolume (shaders/block_dda.frag) instead of drawing the meshes; only
+// columns within VoxelVolume::WINDOW / 2 chunks of the camera are traced.
+class BlockRenderer {
+public:
+    static const int SECTIONS_PER_COLUMN = 8;   // 16-block sections covering MIN_Y..MAX_Y
+
+    int viewRadius = 16;        // Chunks
+    int octaves = 4;
+    bool greedy = true;         // false = one quad per face, for comparison
+    int maxUploadsPerFrame = 8; // Columns
+    float fov = 60.0f;
+    glm::vec3 endStoneColor = glm::vec3(0.86f, 0.85f, 0.62f);
+    glm::vec3 skyColor = glm::vec3(0.02f, 0.01f, 0.04f);
+    glm::vec3 fogColor = glm::vec3(0.10f, 0.05f, 0.15f);
+    float fogDensity = 3.0f;
+    bool voxelTrace = false;    // DDA through the occupancy volume instead of rasterizing
+    int maxTraceSteps = 512;
+
+    // Optional, receives the "blocks" or "voxel trace" pass
+    GpuProfiler* profiler = nullptr;
+
+    explicit BlockRenderer(int workerThreads = 0);
+    ~BlockRenderer();
+
+    // Streams columns around the camera and draws them into the bound framebuffer
+    void Render(const Camera& camera, int width, int height);
+    void Delete();
+
+    // Statistics
+    int GetResidentColumns() const { return residentColumns; }
+    int GetInFlightCount() const { return inFlightCount; }
+    int GetDrawnSections() const { return drawnSections; }
+    int GetQuadCount() const { return quadCount; }
+    int GetFaceCount() const { return faceCount; }     // Quads naive meshing would need
+    size_t GetVoxelBytes() const { return voxelBytes; }
+    size_t GetVoxelFloatBytes() const {     // The same columns as one density float per block
+        return static_cast<size_t>(residentColumns) * SECTIONS_PER_COLUMN * ChunkSection::VOLUME * sizeof(float);
+    }
+    double GetMeshMs() const { return meshedColumns > 0 ? meshNs.load() * 1e-6 / meshedColumns : 0.0; }  // Per column, packing and meshing without the density
+
+private:
+    enum class ColumnState {
+        BAKING,
+        READY,
+        RESIDENT
+    };
+
+    // GL buffers of one non-empty section
+    struct SectionMesh {
+        int y;
+        VAO vao;
+        VBO vbo;
+        EBO ebo;
+        GLsizei indexCount;
+
+        SectionMesh(int y, BlockMesher::Mesh& mesh);
+        void Delete();
+    };
+
+    struct Column {
+        int x;
+        int z;
+        int generation;
+        ColumnState state;
+        bool cancelled;
+        std::vector<std::pair<int, BlockMesher::Mesh>> pending;    // Section y and mesh, written by the worker
+        std::vector<SectionMesh> sections;
+        std::vector<ChunkSection> voxels;       // SECTIONS_PER_COLUMN sections, bottom up
+        int quads;
+        int faces;
+    };
+
+    Shader shader;
+    Shader traceShader;
+    VAO screenVao;
+    VBO screenVbo;
+    ThreadPool workers;
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Column> columns;
+
+    // Columns within viewRadius, nearest first, rebuilt when the camera changes chunk
+    std::vector<std::pair<int, uint64_t>> wanted;
+    size_t wantedCursor;
+    glm::ivec2 cameraChunk;
+    int streamedRadius;
+    int streamedOctaves;
+    bool streamedGreedy;
+    int generation;
+
+    // Which column each volume slot holds, synced from the resident columns
+    struct VolumeSlot {
+        uint64_t key;
+        bool filled;
+    };
+    VoxelVolume volume;
+    std::vector<VolumeSlot> volumeSlots;
+    glm::ivec2 volumeWindowMin;
+    bool volumeDirty;
+
+    int residentColumns;
+    int inFlightCount;
+    int maxInFlight;
+    int drawnSections;
+    int quadCount;
+    int faceCount;
+    size_t voxelBytes;
+    std::atomic<int64_t> meshNs;
+    std::atomic<int> meshedColumns;
+
+    static uint64_t MakeKey(int chunkX, int chunkZ);
+
+    void Update(const glm::vec3& cameraPos);
+    void Recenter(const glm::ivec2& chunk);
+    void UploadColumn(Column& column);
+    void ReleaseColumn(Column& column);
+    void SyncVolume();
+    void Draw(const Camera& camera, int width, int height);
+    void Trace(const Camera& camera, int width, int height);
+
+    // Worker side
+    void ProcessColumn(uint64_t key, int generation);
+    void MeshColumn(int chunkX, int chunkZ, int octaves, bool greedy, std::vector<ChunkSection>& voxels,
+                    std::vector<std::pair<int, BlockMesher::Mesh>>& meshes);
+};
+
+#endif // BLOCK_RENDERER_H
@@ -0,0 +1,127 @@
+#ifndef BRICK_MAP_H
+#define BRICK_MAP_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "ThreadPool.h"
+
+// Sparse brickmap of the End density field for end_raymarch.frag.
+// A top-level grid (GL_R32UI, GRID_SIZE x 8 x GRID_SIZE, toroidal in x/z)
+// holds one cell per 16-block brick of the chunk columns around the camera:
+// 0 = not streamed, 1 = empty, 2 = full, otherwise 3 + the slot of its
+// 9^3 density samples (8^3 cells) in a 3D texture atlas sized by budgetMB.
+// Empty and full are only claimed where the Lipschitz bound proves them
+// between samples too; anything else is stored as data.
+// Chunk columns are baked on worker threads nearest first; once the atlas is
+// full the least recently viewed columns are evicted.
+class BrickMap {
+public:
+    static const int BRICK_SAMPLES = 9;         // Samples per side, 8 cells of 2 blocks
+    static const int BRICKS_PER_COLUMN = 8;     // 16-block bricks covering MIN_Y..MAX_Y
+    static const int GRID_SIZE = 256;           // Chunk columns per side of the top grid, power of two
+
+    enum Cell : uint32_t {
+        CELL_UNKNOWN = 0,
+        CELL_EMPTY = 1,
+        CELL_FULL = 2,
+        CELL_FIRST_SLOT = 3
+    };
+
+    explicit BrickMap(int workerThreads = 0);
+    ~BrickMap();
+
+    // Call once per frame: recentres the grid, requests columns within
+    // viewDistance nearest first, uploads finished ones. A change of octaves
+    // or lipschitz drops everything.
+    void Update(const glm::vec3& cameraPos, float viewDistance, int octaves, float lipschitz);
+
+    void Bind(GLuint gridUnit, GLuint atlasUnit) const;
+    void Shutdown();
+
+    bool IsValid() const { return gridTexture != 0; }
+    glm::ivec2 GetWindowMin() const { return windowMin; }  // World chunk of the grid's minimum corner
+    glm::ivec3 GetAtlasSlots() const { return atlasSlots; }
+
+    // Statistics
+    int GetCapacity() const { return atlasSlots.x * atlasSlots.y * atlasSlots.z; }
+    int GetUsedSlots() const { return GetCapacity() - static_cast<int>(freeSlots.size()); }
+    int GetResidentColumns() const { return residentColumns; }
+    int GetInFlightCount() const { return inFlightCount; }
+    int GetEvictedCount() const { return evictedCount; }
+    int GetEmptyBricks() const { return emptyBricks; }     // Of the resident columns
+    int GetFullBricks() const { return fullBricks; }
+    int GetDataBricks() const { return dataBricks; }        // Holding an atlas slot
+
+    int budgetMB;
+    int maxUploadsPerFrame;     // Columns
+
+private:
+    enum class ColumnState {
+        BAKING,
+        READY,
+        RESIDENT
+    };
+
+    struct Column {
+        int x;
+        int z;
+        int generation;
+        ColumnState state;
+        bool cancelled;
+        uint32_t cells[BRICKS_PER_COLUMN];
+        std::vector<float> samples;     // Mixed bricks only, in column order
+        uint64_t lastViewed;            // View stamp of the last time it was in range
+        bool inLru;
+        std::list<uint64_t>::iterator lruEntry;
+    };
+
+    ThreadPool workers;
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Column> columns;
+
+    GLuint gridTexture;
+    GLuint atlasTexture;
+    glm::ivec3 atlasSlots;
+    std::vector<uint32_t> freeSlots;
+    std::list<uint64_t> lru;            // Columns holding slots, most recently viewed first
+
+    // Columns within view distance, nearest first, rebuilt when the camera changes chunk
+    std::vector<std::pair<float, uint64_t>> wanted;
+    size_t wantedCursor;
+    glm::ivec2 cameraChunk;
+    glm::ivec2 windowMin;
+    uint64_t viewStamp;
+    int octaves;
+    float lipschitz;
+    int generation;
+
+    int residentColumns;
+    int inFlightCount;
+    int maxInFlight;
+    int evictedCount;
+    int emptyBricks;
+    int fullBricks;
+    int dataBricks;
+
+    static uint64_t MakeKey(int chunkX, int chunkZ);
+
+    void CreateTextures();
+    void Recenter(const glm::ivec2& chunk, float viewDistance);
+    bool AllocateSlot(uint32_t& slot);
+    void UploadColumn(uint64_t key, Column& column);
+    void ReleaseColumn(Column& column);
+    void CountBricks(const Column& column, int delta);
+    void WriteCells(const Column& column, const uint32_t* cells);
+
+    // Worker side
+    void ProcessColumn(uint64_t key, int generation);
+    void BakeColumn(int chunkX, int chunkZ, int octaves, float lipschitz, uint32_t* cells, std::vector<float>& samples);
+};
+
+#endif // BRICK_MAP_H
@@ -28,6 +28,8 @@ class Camera{
 
   Camera(int width, int height, glm::vec3 position);
 
+  // Projection * view for the current position and orientation
+  glm::mat4 GetMatrix(float FOVdeg, float nearPlane, float farPlane) const;
   void Matrix(float FOVdeg, float nearPlane, float farPlane, Shader& shader, const char* uniform);
   void Inputs(GLFWwindow* window);
 };
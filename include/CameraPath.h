@@ -0,0 +1,40 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+
+// Per-frame camera poses for deterministic flythroughs.
+// Stored as a compact binary file: "ECP1", frame count, timestep, then
+// per frame 3 floats of position and an octahedral-encoded orientation
+// in two int16 (16 bytes per frame).
+class CameraPath {
+public:
+    struct Pose {
+        glm::vec3 position;
+        glm::vec3 orientation;
+    };
+
+    float timestep = 1.0f / 60.0f;   // Simulated seconds per frame on replay
+    std::vector<Pose> poses;
+
+    void Clear() { poses.clear(); }
+    void Append(const Camera& camera);
+    void Apply(size_t frame, Camera& camera) const;
+    size_t GetFrameCount() const { return poses.size(); }
+
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+    // Canonical benchmark flights
+    static CameraPath MainIslandOrbit(int frames = 1800);
+    static CameraPath OuterVoidDash(int frames = 1800);
+
+    // Loads a built-in flight by name ("orbit", "dash") or a recorded file
+    static bool Resolve(const std::string& nameOrPath, CameraPath& path);
+};
+
+#endif // CAMERA_PATH_H
@@ -0,0 +1,87 @@
+#ifndef CHUNK_SECTION_H
+#define CHUNK_SECTION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 16^3 blocks stored like a Minecraft chunk section: a palette of the block
+// ids present and one bit-packed palette index per block, entries never
+// straddling a 64-bit word. A section with a single block id (all air, all
+// end stone) keeps no index data at all. Not thread-safe.
+class ChunkSection {
+public:
+    typedef uint16_t BlockId;
+    static const BlockId AIR = 0;
+    static const BlockId END_STONE = 1;
+
+    static const int SIZE = 16;
+    static const int VOLUME = SIZE * SIZE * SIZE;
+
+    explicit ChunkSection(BlockId fill = AIR);
+
+    // blocks: VOLUME ids in Index order
+    static ChunkSection FromBlocks(const BlockId* blocks);
+
+    // y, then z, then x fastest, as in Minecraft
+    static int Index(int x, int y, int z) { return (y * SIZE + z) * SIZE + x; }
+
+    BlockId Get(int x, int y, int z) const { return GetIndex(Index(x, y, z)); }
+    inline BlockId GetIndex(int index) const;
+    void Set(int x, int y, int z, BlockId block);
+
+    // Calls visit(index, block) for every block in Index order, word by word
+    template <typename Visitor>
+    void ForEach(Visitor&& visit) const;
+    void Unpack(BlockId* blocks) const;
+
+    // Drops palette entries no block uses anymore, down to a single value
+    void Compact();
+
+    bool IsSingleValue() const { return bits == 0; }
+    int GetBitsPerEntry() const { return bits; }
+    int GetPaletteSize() const { return static_cast<int>(palette.size()); }
+    size_t GetMemoryBytes() const {
+        return sizeof(*this) + palette.capacity() * sizeof(BlockId) + data.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    int bits;                       // Per entry, 0 = single value palette[0]
+    int entriesPerWord;
+    uint64_t mask;
+    std::vector<BlockId> palette;
+    std::vector<uint64_t> data;
+
+    static int BitsFor(size_t paletteSize);
+    void Pack(const uint16_t* entries, int newBits);
+    void UnpackEntries(uint16_t* entries) const;
+    uint32_t PaletteIndex(BlockId block);
+};
+
+inline ChunkSection::BlockId ChunkSection::GetIndex(int index) const {
+    if (bits == 0) {
+        return palette[0];
+    }
+    int word = index / entriesPerWord;
+    int shift = (index - word * entriesPerWord) * bits;
+    return palette[(data[word] >> shift) & mask];
+}
+
+template <typename Visitor>
+void ChunkSection::ForEach(Visitor&& visit) const {
+    if (bits == 0) {
+        for (int index = 0; index < VOLUME; index++) {
+            visit(index, palette[0]);
+        }
+        return;
+    }
+    int index = 0;
+    for (uint64_t word : data) {
+        for (int entry = 0; entry < entriesPerWord && index < VOLUME; entry++, index++) {
+            visit(index, palette[word & mask]);
+            word >>= bits;
+        }
+    }
+}
+
+#endif // CHUNK_SECTION_H
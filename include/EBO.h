@@ -1,3 +1,6 @@
+#ifndef EBO_CLASS_H
+#define EBO_CLASS_H
+
 #include <GL/glew.h>
 
 class EBO{
@@ -9,3 +12,4 @@ class EBO{
     void Unbind();
     void Delete();
 };
+#endif
@@ -0,0 +1,17 @@
+#ifndef END_NOISE_H
+#define END_NOISE_H
+
+// CPU port of the noise functions in shaders/end_raymarch.frag.
+// Kept numerically identical to the GLSL (same hashes, skew factors and
+// weights) so CPU-side tools see the same terrain as the raymarcher.
+namespace EndNoise {
+
+float simplex2D(float x, float y);
+float simplex3D(float x, float y, float z);
+
+// Octave noise (FBM), normalised by the sum of amplitudes
+float fbm3D(float x, float y, float z, int octaves);
+
+}
+
+#endif // END_NOISE_H
@@ -0,0 +1,92 @@
+#ifndef END_RENDERER_H
+#define END_RENDERER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "BrickMap.h"
+#include "Camera.h"
+#include "FrameBuffer.h"
+#include "GpuProfiler.h"
+#include "IslandGrid.h"
+#include "NoiseVolume.h"
+#include "RaymarchCost.h"
+#include "SdfClipmap.h"
+#include "shaderClass.h"
+#include "VAO.h"
+#include "VBO.h"
+
+#include <memory>
+
+// Raymarch quality/cost parameters (uniforms of end_raymarch.frag)
+struct RaymarchSettings {
+    int maxSteps = 256;
+    float stepMultiplier = 1.0f;
+    int octaves = 4;
+    int refineSteps = 4;        // Binary search iterations on hit
+    float maxDistance = 2000.0f;
+    float renderScale = 1.0f;   // Raymarch resolution relative to the window
+    bool bakedNoise = true;     // Sample the NoiseVolume instead of procedural simplex3D
+    bool sphereTrace = true;    // Lipschitz sphere tracing instead of the heuristic step
+    float lipschitz = 4.5f;     // Density gradient bound (tools/lipschitz_estimate)
+    float relaxation = 1.6f;    // Sphere tracing over-relaxation, 1 = off
+    bool islandGrid = true;     // Skip empty chunk columns using the IslandGrid
+    bool sdfClipmap = false;    // Sphere trace the baked SdfClipmap (procedural noise only)
+    bool sdfShadows = true;     // Soft shadows and AO from the SdfClipmap
+    bool brickMap = false;      // Stream the BrickMap and march its baked bricks (procedural noise only)
+};
+
+// What the cost shader variant shows, matches uCostView
+enum class RaymarchCostView {
+    SHADED,         // Normal image, counters only
+    STEPS,
+    DENSITY_EVALS,
+    REFINE_STEPS
+};
+
+// Full-screen raymarch of the End terrain (shaders/end_raymarch.*).
+// The march runs into an offscreen framebuffer at renderScale and is then
+// upsampled to the default framebuffer.
+class EndRenderer {
+public:
+    RaymarchSettings settings;
+    float fov = 60.0f;
+    glm::vec3 endStoneColor = glm::vec3(0.86f, 0.85f, 0.62f);
+    glm::vec3 skyColor = glm::vec3(0.02f, 0.01f, 0.04f);
+    glm::vec3 fogColor = glm::vec3(0.10f, 0.05f, 0.15f);
+    float fogDensity = 3.0f;
+
+    // Optional, receives "raymarch" and "upsample" passes
+    GpuProfiler* profiler = nullptr;
+
+    // Switches to the instrumented shader (built on first use) that counts
+    // steps, density evaluations and refine iterations per ray
+    bool measureCost = false;
+    RaymarchCostView costView = RaymarchCostView::STEPS;
+
+    EndRenderer(int width, int height);
+
+    // Draws into destinationFBO (0 = default framebuffer) at width x height
+    void Render(const Camera& camera, int width, int height, float time, GLuint destinationFBO = 0);
+    void Delete();
+
+    const RaymarchCost& GetCost() const { return cost; }
+    const BrickMap& GetBricks() const { return bricks; }
+    const IslandGrid& GetIslandGrid() const { return islandGrid; }
+
+private:
+    Shader shader;
+    VAO vao;
+    VBO vbo;
+    Framebuffer target;
+    NoiseVolume noise;
+    IslandGrid islandGrid;
+    SdfClipmap sdf;
+    BrickMap bricks;
+    RaymarchCost cost;
+    std::unique_ptr<Shader> costShader;
+
+    void SetUniforms(GLuint program, const Camera& camera, int width, int height, float time);
+};
+
+#endif // END_RENDERER_H
@@ -0,0 +1,63 @@
+#ifndef END_TERRAIN_H
+#define END_TERRAIN_H
+
+// CPU port of the End density field from shaders/end_raymarch.frag.
+// Used by tools that need to reason about the terrain without the GPU
+// (map baking, benchmarks, acceleration structures).
+class EndTerrain {
+public:
+    static constexpr float MAIN_ISLAND_RADIUS = 500.0f;
+    static constexpr float EXCLUSION_ZONE_START = 500.0f;
+    static constexpr float EXCLUSION_ZONE_END = 1024.0f;
+    static constexpr float SEA_LEVEL = 64.0f;
+
+    // Solid terrain never extends outside this y-range
+    static constexpr float MIN_Y = 0.0f;
+    static constexpr float MAX_Y = 128.0f;
+
+    // Outer island placed in a 16x16 chunk
+    struct Island {
+        float centerX;
+        float centerZ;
+        float radius;
+        float height;
+    };
+
+    // Top surface of a single column
+    struct Column {
+        bool solid;
+        float topY;
+    };
+
+    int octaves;
+
+    EndTerrain(int octaves = 4);
+
+    // Main density function, > 0 means solid
+    float Density(float x, float y, float z) const;
+
+    float MainIslandHeight(float dist) const;
+    float MainIslandDensity(float x, float y, float z, float horizDist) const;
+    float OuterIslandDensity(float x, float y, float z, float horizDist) const;
+
+    // Lower bound on the distance from (x, y, z) to solid terrain given the
+    // density there and a Lipschitz bound of the density field. Mirrors
+    // distanceBound in end_raymarch.frag.
+    float DistanceBound(float x, float y, float z, float density, float lipschitz) const;
+
+    // Returns false if the chunk has no outer island
+    bool IslandForChunk(int chunkX, int chunkZ, Island& island) const;
+
+    // Conservative vertical extents of solid terrain, noise included
+    void IslandHeightRange(const Island& island, float& minY, float& maxY) const;
+    float MainIslandMaxY(float horizDist) const;
+
+    // y-range that can hold solid terrain in the 16x16 column of a chunk,
+    // returns false if the column is empty
+    bool ChunkHeightRange(int chunkX, int chunkZ, float& minY, float& maxY) const;
+
+    // Scan a column from the top down and refine the first solid crossing
+    Column SampleColumn(float x, float z) const;
+};
+
+#endif // END_TERRAIN_H
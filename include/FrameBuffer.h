@@ -18,8 +18,10 @@ public:
     void Bind();
     void Unbind();
     void Resize(int w, int h);
+    void Delete() { DeleteFramebuffer(); }
 
     GLuint GetTexture() const { return colorTexture; }
+    GLuint GetFBO() const { return fbo; }
     int GetWidth() const { return width; }
     int GetHeight() const { return height; }
 
@@ -0,0 +1,129 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Asynchronous frame capture.
+// Frames are read back into a ring of pixel-pack buffers, mapped a frame or two
+// later once their fence has signalled, and handed to an encoder thread that
+// writes PNG screenshots/sequences or a raw Y4M video stream straight from the
+// mapped buffer. The render thread never waits: when every slot is still being
+// read back or encoded the frame is dropped and counted.
+class FrameCapture {
+public:
+    enum class Format {
+        PNG,
+        Y4M
+    };
+
+    explicit FrameCapture(int ringSize = 8);
+    ~FrameCapture();
+
+    // Capture the next frame to a single PNG file
+    void Screenshot(const std::string& path);
+
+    // Capture every frame until StopSequence() is called.
+    // PNG writes <basePath>_000000.png, ..., Y4M writes <basePath>.y4m
+    bool StartSequence(const std::string& basePath, Format format, int fps = 60);
+    void StopSequence();
+    bool IsRecording() const { return recording; }
+    int GetRecordedFrames() const { return sequenceFrame; }
+    int GetDroppedFrames() const { return droppedFrames; }
+
+    // Call once per frame with the framebuffer that should be captured bound for reading
+    void CaptureFrame(int width, int height);
+
+    // Returns "captures/<prefix>_YYYYMMDD_HHMMSS" for naming new captures
+    static std::string TimestampedPath(const std::string& prefix);
+
+    // Wait for every in-flight frame to be encoded
+    void Flush();
+    void Shutdown();
+
+private:
+    enum class JobType {
+        SCREENSHOT,
+        SEQUENCE_PNG,
+        SEQUENCE_Y4M,
+        CLOSE_STREAM
+    };
+
+    struct Job {
+        JobType type;
+        std::string path;
+        int width = 0;
+        int height = 0;
+        int fps = 0;
+        std::string screenshotPath;         // Extra PNG requested while recording
+        int slot = -1;                      // Ring slot holding the pixels
+        const uint8_t* pixels = nullptr;    // Its mapped buffer, RGBA, bottom-up rows as returned by GL
+    };
+
+    enum class SlotState {
+        FREE,
+        READING,    // Waiting for the readback fence
+        ENCODING    // Mapped, owned by the encoder until `encoded`
+    };
+
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        GLsizeiptr capacity = 0;
+        SlotState state = SlotState::FREE;
+        bool encoded = false;   // Guarded by queueMutex
+        Job job;
+    };
+
+    std::vector<Slot> slots;
+    int writeIndex;
+    int readIndex;
+    int pendingCount;
+    bool glInitialized;
+
+    std::string screenshotPath;
+    bool recording;
+    Format sequenceFormat;
+    std::string sequenceBase;
+    int sequenceFps;
+    int sequenceFrame;
+    int droppedFrames;
+
+    // Encoder thread state
+    std::thread encoderThread;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::condition_variable idleCondition;
+    std::deque<Job> jobQueue;
+    bool encoderBusy;
+    bool stopEncoder;
+
+    // Only touched by the encoder thread
+    FILE* y4mFile;
+    int y4mWidth;
+    int y4mHeight;
+    std::vector<uint8_t> scratch;
+    std::vector<uint8_t> compressed;
+
+    void InitializeGL();
+    void DeleteGL();
+    void Submit(Slot& slot, int width, int height);
+    bool HandOff(Slot& slot, int index, bool wait);
+    void Collect(bool wait);
+    void DrainPending();
+
+    void EncoderLoop();
+    void Encode(Job& job);
+    bool WritePNG(const Job& job, const std::string& path, int level);
+    bool WriteY4MFrame(const Job& job);
+    void CloseStream();
+};
+
+#endif // FRAME_CAPTURE_H
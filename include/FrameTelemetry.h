@@ -0,0 +1,118 @@
+#ifndef FRAME_TELEMETRY_H
+#define FRAME_TELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Log-linear latency histogram in the style of HdrHistogram.
+// Values are stored in microseconds with 32 sub-buckets per power of two,
+// so any percentile is within ~3% of the true value while the whole
+// histogram stays a fixed 960 counters (1 us .. ~4 h).
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAX_EXPONENT = 33;
+    static const int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    LatencyHistogram() { Reset(); }
+
+    void Record(double ms);
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    uint64_t GetCount() const { return count; }
+    double GetMax() const { return maxMs; }
+
+    // percentile in [0, 100], result in ms (0 when empty)
+    double Percentile(double percentile) const;
+
+private:
+    uint32_t buckets[BUCKET_COUNT];
+    uint64_t count;
+    double maxMs;
+
+    static int BucketIndex(uint64_t us);
+    static double BucketValue(int index);
+};
+
+// Per-frame CPU, GPU and present-interval telemetry.
+// Frames land in one histogram set per wall-clock second (kept for a
+// minute) for the rolling windows shown in ImGui, and in a separate set
+// that is appended to a JSON-lines file every exportInterval seconds and
+// then cleared.
+class FrameTelemetry {
+public:
+    struct MetricStats {
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    struct WindowStats {
+        int seconds = 0;
+        uint64_t frames = 0;
+        uint64_t hitches = 0;
+        MetricStats cpu;
+        MetricStats gpu;
+        MetricStats present;
+    };
+
+    static const int HISTORY_SECONDS = 60;
+    static const int SHORT_WINDOW = 10;
+
+    // A present interval longer than hitchFactor x the short-window p50 is a hitch
+    float hitchFactor = 2.0f;
+    float exportInterval = 10.0f;   // Seconds between JSON lines, <= 0 disables the export
+    std::string exportPath = "telemetry/frames.jsonl";
+    std::string renderer;           // GL_RENDERER, tagged on every exported line
+
+    FrameTelemetry();
+    ~FrameTelemetry();
+
+    void BeginFrame();
+    void EndFrame();                // CPU work done, about to present
+    void Presented();               // After SwapBuffers returns
+    void RecordGpu(double ms);      // GPU frame times arrive a few frames late
+
+    const WindowStats& GetShortWindow() const { return windows[0]; }
+    const WindowStats& GetLongWindow() const { return windows[1]; }
+
+    void DrawWindow(bool* open);
+
+    // Appends whatever was recorded since the last export
+    void Flush();
+
+private:
+    struct Second {
+        LatencyHistogram cpu;
+        LatencyHistogram gpu;
+        LatencyHistogram present;
+        uint64_t frames;
+        uint64_t hitches;
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    Second history[HISTORY_SECONDS];
+    Second pending;                 // Since the last export
+    int64_t currentSecond;
+    Clock::time_point startTime;
+    Clock::time_point frameStart;
+    Clock::time_point lastPresent;
+    Clock::time_point lastExport;
+    bool havePresent;
+    WindowStats windows[2];         // SHORT_WINDOW and HISTORY_SECONDS, refreshed once a second
+
+    Second& Current();
+    void Advance();
+    void RefreshWindows();
+    void WriteLine(const Second& second, double seconds);
+
+    static void ClearSecond(Second& second);
+    static MetricStats Stats(const LatencyHistogram& histogram);
+};
+
+#endif // FRAME_TELEMETRY_H
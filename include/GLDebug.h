@@ -0,0 +1,34 @@
+#ifndef GL_DEBUG_H
+#define GL_DEBUG_H
+
+#include <GL/glew.h>
+#include <string>
+
+// OpenGL debug output (KHR_debug / GL 4.3) routed through Logger.
+// Replaces glGetError polling: the driver reports errors and performance
+// warnings through a callback, rate limited per message ID. Debug builds
+// request a debug context, use synchronous output so messages arrive on
+// the offending call, and label the GL objects created by the wrappers.
+namespace GLDebug {
+    // Call once after glewInit(). Returns false if debug output is not available.
+    bool Initialize();
+    bool IsActive();
+
+    // Messages below this severity are discarded by the driver
+    // (GL_DEBUG_SEVERITY_HIGH / MEDIUM / LOW / NOTIFICATION)
+    void SetMinimumSeverity(GLenum severity);
+
+    // Drop a message ID, e.g. a vendor's informational spam
+    void IgnoreMessage(GLuint id);
+
+    // glObjectLabel when supported; use GL_OBJECT_LABEL so release builds skip it
+    void Label(GLenum identifier, GLuint name, const std::string& label);
+}
+
+#ifdef NDEBUG
+#define GL_OBJECT_LABEL(identifier, name, label) ((void)0)
+#else
+#define GL_OBJECT_LABEL(identifier, name, label) GLDebug::Label(identifier, name, label)
+#endif
+
+#endif // GL_DEBUG_H
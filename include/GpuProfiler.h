@@ -0,0 +1,113 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-pass GPU timings from GL_TIMESTAMP queries.
+// Every BeginPass/EndPass drops a timestamp into the current frame's query
+// set. Frames rotate through a ring of FRAME_RING_SIZE sets and a set is
+// only read when it comes around again, i.e. FRAME_RING_SIZE - 1 frames
+// later. If the GPU is further behind than that the frame is skipped
+// instead of waiting on it.
+class GpuProfiler {
+public:
+    static const int FRAME_RING_SIZE = 4;
+    static const int HISTORY_SIZE = 240;      // Frames shown in the graphs
+    static const int CSV_HISTORY = 3600;      // Frames kept for DumpCsv
+
+    // Brackets a pass for the lifetime of the object; no-op with a null profiler
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler* profiler;
+    };
+
+    bool enabled = true;
+
+    GpuProfiler();
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Passes may nest; name must outlive the frame (string literals)
+    void BeginPass(const char* name);
+    void EndPass();
+
+    // Latest resolved frame time and its rolling average, in ms
+    float GetFrameMs() const { return lastFrameMs; }
+    float GetAverageFrameMs() const;
+
+    size_t GetSkippedFrames() const { return skippedFrames; }
+
+    // Increments whenever a new GetFrameMs() value is available
+    uint64_t GetResolvedFrames() const { return resolvedFrames; }
+
+    // "GPU Profiler" window with per-pass table and frame-time graph
+    void DrawWindow(bool* open);
+
+    // One row per resolved frame, one column per pass (ms)
+    bool DumpCsv(const std::string& path) const;
+
+    void Delete();
+
+private:
+    struct PassQuery {
+        const char* name;
+        int depth;
+        int begin;      // Query indices into Frame::queries
+        int end;
+    };
+
+    struct Frame {
+        std::vector<GLuint> queries;
+        int usedQueries = 0;
+        std::vector<PassQuery> passes;
+        uint64_t index = 0;
+        bool pending = false;
+    };
+
+    struct PassStats {
+        std::string name;
+        int depth;
+        float history[HISTORY_SIZE];
+        float lastMs;
+    };
+
+    struct FrameRecord {
+        uint64_t index;
+        float frameMs;
+        std::vector<std::pair<int, float>> passes;  // PassStats index, ms
+    };
+
+    Frame frames[FRAME_RING_SIZE];
+    int current;
+    uint64_t frameIndex;
+    bool inFrame;
+    std::vector<int> openPasses;
+    std::vector<GLuint64> resolveTimes;
+
+    std::vector<PassStats> passStats;
+    float frameHistory[HISTORY_SIZE];
+    int historyOffset;
+    int historyCount;
+    float lastFrameMs;
+    size_t skippedFrames;
+    uint64_t resolvedFrames;
+    std::vector<FrameRecord> records;   // Ring of CSV_HISTORY
+    size_t recordStart;
+
+    int IssueTimestamp();
+    void Resolve(Frame& frame);
+    int FindOrAddPass(const char* name, int depth);
+};
+
+#endif // GPU_PROFILER_H
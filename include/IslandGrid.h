@@ -0,0 +1,63 @@
+#ifndef ISLAND_GRID_H
+#define ISLAND_GRID_H
+
+#include <GL/glew.h>
+
+#include "EndTerrain.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <vector>
+
+// Chunk-resolution min/max height grid around the camera for empty-space
+// skipping in end_raymarch.frag. Each level 0 texel covers one 16x16 chunk
+// column and holds the y-range that can contain terrain (main island height
+// profile or outer island slabs); empty columns hold an inverted range.
+// Coarser mips hold the union of their four children, so the raymarcher
+// can step over whole quadtree nodes the ray passes above or below.
+// Rebuilt on a worker thread when the camera drifts away from the grid
+// centre; until the first build finishes the grid is not valid.
+class IslandGrid {
+public:
+    static constexpr int SIZE = 512;            // Chunks per side, power of two
+    static constexpr int LEVELS = 10;           // Mips down to a single texel
+
+    IslandGrid();
+
+    // Uploads a finished build and starts a new one when the camera chunk is
+    // more than SIZE / 4 chunks from the grid centre. Call once per frame.
+    void Update(int cameraChunkX, int cameraChunkZ);
+
+    // Binds the grid to texture unit `unit`
+    void Bind(GLuint unit) const;
+
+    bool IsValid() const { return valid; }
+    bool IsBuilding() const { return building; }
+    int GetOriginX() const { return originX; }  // World chunk of texel (0, 0)
+    int GetOriginZ() const { return originZ; }
+
+    void Delete();
+
+private:
+    EndTerrain terrain;
+    GLuint texture = 0;
+    bool valid = false;
+    bool building = false;
+    int originX = 0;
+    int originZ = 0;
+    int requestedX = 0;     // Centre chunk of the current or last build
+    int requestedZ = 0;
+
+    std::vector<std::vector<float>> pending;    // RG (yMin, yMax) per level, written by the worker
+    int pendingX = 0;
+    int pendingZ = 0;
+    std::atomic<bool> ready{false};
+
+    // Declared last so the worker is joined before the buffers it writes go away
+    ThreadPool pool;
+
+    void Build(int centerX, int centerZ);
+    void Upload();
+};
+
+#endif // ISLAND_GRID_H
@@ -0,0 +1,82 @@
+#ifndef LOG_ARGS_H
+#define LOG_ARGS_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Packing of raw log arguments for deferred formatting.
+// The producer appends each argument to a byte buffer as a one byte type
+// tag plus its value; integers are varints (signed ones zigzag encoded),
+// strings are copied. The writer thread later expands
+// the format string with Format(). Placeholders are "{}" or "{:spec}" where
+// spec is a printf conversion without the '%' (e.g. "{:.2f}", "{:08x}").
+// "{{" and "}}" are literal braces.
+namespace LogArgs {
+    enum Tag : uint8_t {
+        BOOL,
+        CHAR,
+        INT,
+        UINT,
+        DOUBLE,
+        STRING,
+        POINTER
+    };
+
+    template <typename T>
+    inline void PackScalar(std::string& buffer, Tag tag, T value) {
+        buffer.push_back(static_cast<char>(tag));
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    inline void PackVarint(std::string& buffer, Tag tag, uint64_t value) {
+        buffer.push_back(static_cast<char>(tag));
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    inline void PackString(std::string& buffer, std::string_view text) {
+        uint32_t length = static_cast<uint32_t>(text.size());
+        PackScalar(buffer, STRING, length);
+        buffer.append(text.data(), text.size());
+    }
+
+    template <typename T>
+    struct Unsupported : std::false_type {};
+
+    template <typename T>
+    inline void Pack(std::string& buffer, const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            PackScalar(buffer, BOOL, static_cast<uint8_t>(value));
+        } else if constexpr (std::is_same_v<T, char>) {
+            PackScalar(buffer, CHAR, value);
+        } else if constexpr (std::is_enum_v<T>) {
+            Pack(buffer, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            int64_t wide = static_cast<int64_t>(value);
+            PackVarint(buffer, INT, (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+        } else if constexpr (std::is_integral_v<T>) {
+            PackVarint(buffer, UINT, static_cast<uint64_t>(value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            PackScalar(buffer, DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>) {
+            PackString(buffer, value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            PackString(buffer, std::string_view(value));
+        } else if constexpr (std::is_pointer_v<T>) {
+            PackVarint(buffer, POINTER, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+        } else {
+            static_assert(Unsupported<T>::value, "Unsupported deferred log argument type");
+        }
+    }
+
+    // Expands format with the packed arguments into out (cleared first)
+    void Format(const char* format, const std::string& packed, std::string& out);
+}
+
+#endif // LOG_ARGS_H
@@ -13,17 +13,48 @@
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "GL/gl.h"
+#include "AllocTracker.h"
+#include "BinaryLog.h"
+#include "LogArgs.h"
+#include "MpscQueue.h"
+#include "ThreadPool.h"
 
-class Logger {
-private:
-    static Logger* instance;
-    std::ofstream logFile;
-    std::string logFileName;
-    std::string basePath;
-    bool initialized;
+// Levels below this are compiled out of the LOG_* macros entirely
+// (value of Logger::LogLevel: 0 = DEBUG ... 4 = FATAL)
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+// Per-call-site rate limiting state, one static instance per LOG_* statement.
+// Sites that ever get suppressed link themselves into a lock-free list so the
+// writer thread can report how many of their messages were dropped.
+struct LogSite {
+    const char* file;
+    int line;
+    std::atomic<uint32_t> window{0};      // Logger second the count belongs to
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> suppressed{0};
+    std::atomic<bool> registered{false};
+    LogSite* next = nullptr;
+
+    constexpr LogSite(const char* file, int line) : file(file), line(line) {}
+};
 
+// Messages are pushed into a lock-free ring buffer by the calling thread and
+// formatted/written by a background writer thread, so logging is cheap and
+// safe from any thread. FATAL messages and flush() wait until everything
+// queued so far has reached the console and the log file.
+class Logger {
+public:
     // Log level settings
     enum class LogLevel {
         DEBUG,
@@ -33,22 +64,121 @@ private:
         FATAL,
         TODO
     };
-    LogLevel currentLevel;
+
+    // Log file encoding; BINARY writes logs/<name>.blog (decode with log_decode)
+    enum class FileFormat {
+        TEXT,
+        BINARY
+    };
+
+    // What producers do when the ring buffer is full
+    enum class OverflowPolicy {
+        DROP,   // Discard the message and count it (reported later)
+        BLOCK   // Wait for the writer thread to free a slot
+    };
+
+private:
+    static Logger* instance;
+    std::ofstream logFile;
+    std::string logFileName;
+    std::string basePath;
+    FileFormat fileFormat;
+    BinaryLogWriter binaryLog;
+    std::atomic<bool> initialized;
+
+    // Rotation: the writer starts a new segment when the current one is too
+    // big or too old; closed segments are gzipped on the compressor thread
+    uint64_t maxSegmentBytes;
+    int64_t maxSegmentAgeNs;
+    int maxRetainedFiles;
+    std::string logFilePath;
+    uint64_t segmentBytes;
+    int64_t segmentStartNs;
+    int segmentIndex;
+    std::unique_ptr<ThreadPool> compressor;
+    std::mutex initMutex;
+
+    std::atomic<LogLevel> currentLevel;
 
     // Display settings
-    bool showTimestamps;
-    bool showSourceInfo;
-    bool useColors;
+    std::atomic<bool> showTimestamps;
+    std::atomic<bool> showSourceInfo;
+    std::atomic<bool> useColors;
+
+    // One queued message; slots are reused so message keeps its capacity.
+    // With a format string, message holds the packed arguments (LogArgs).
+    struct LogRecord {
+        LogLevel level;
+        const char* file;
+        int line;
+        int64_t timeNs;     // steady_clock, captured by the producer
+        const char* format;
+        std::string message;
+    };
+
+    // Ring buffer and writer thread
+    size_t queueCapacity;
+    std::atomic<OverflowPolicy> overflowPolicy;
+    std::unique_ptr<MpscQueue<LogRecord>> queue;
+    std::thread writerThread;
+    std::atomic<bool> writerRunning;    // Producers push into the queue
+    std::atomic<bool> writerStopping;   // Writer drains the queue and exits
+    std::atomic<bool> writerSleeping;
+    std::atomic<size_t> writtenCount;   // Records written and flushed by the writer
+    std::atomic<uint64_t> droppedCount;
+    std::atomic<uint32_t> currentSecond;    // Coarse clock advanced by the writer thread
+    std::atomic<uint32_t> rateLimit;        // Messages per call site per second, 0 = off
+    std::atomic<LogSite*> suppressedSites;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable flushCondition;
+    std::mutex syncMutex;               // Direct writes while no writer thread runs
+
+    // Writer-side formatting state
+    std::string consoleLine;
+    std::string fileLine;
+    std::string formattedMessage;
+    int64_t timestampSecond;
+    std::string timestampText;
+    int64_t wallClockOffsetNs;          // system_clock - steady_clock
+    int64_t startNs;
+
+    // Writer-side repeat collapsing, keyed by call site
+    struct RepeatState {
+        LogLevel level;
+        const char* format;
+        std::string message;
+        uint32_t repeats;
+    };
+    struct SiteHash {
+        size_t operator()(const std::pair<const char*, int>& site) const {
+            return std::hash<const void*>()(site.first) ^ static_cast<size_t>(site.second);
+        }
+    };
+    std::unordered_map<std::pair<const char*, int>, RepeatState, SiteHash> lastMessages;
+    std::atomic<bool> deduplicate;
 
     Logger();
 
     // Helper functions
-    std::string getLogLevelString(LogLevel level);
-    std::string getCurrentTimestamp();
+    const char* getLogLevelString(LogLevel level, bool colored);
+    const std::string& formatTimestamp(int64_t timeNs);
     std::string createLogFileName();
+    bool openLogFile();
+    void rotateLogFile();
+    static void compressLogFile(const std::string& path);
+    static void enforceRetention(int maxFiles, const std::string& activePath);
 
     // Internal logging function
-    void logInternal(LogLevel level, const std::string& message, const char* file, int line);
+    void logInternal(LogLevel level, const std::string& message, const char* file, int line, const char* format = nullptr);
+
+    void writerLoop();
+    void writeRecord(const LogRecord& record);
+    void writeLine(const LogRecord& record);
+    void writeSummaries(int64_t timeNs);
+    void flushStreams();
+    void registerSuppressed(LogSite& site);
+    void wakeWriter();
 
 public:
     // Singleton access
@@ -65,7 +195,66 @@ public:
     void enableColors(bool enable);
     void setBasePath(const std::string& path);
 
+    // Only take effect before init()
+    void setFileFormat(FileFormat format);
+    // 0 disables the respective limit; retention counts segments, the active one included
+    void setRotation(uint64_t maxSegmentBytes, int maxSegmentAgeSeconds, int maxRetainedFiles);
+    // Ring buffer size in messages
+    void setQueueCapacity(size_t capacity);
+    void setOverflowPolicy(OverflowPolicy policy);
+    uint64_t getDroppedCount() const { return droppedCount.load(); }
+
+    // Per-call-site limit for the LOG_* macros; excess messages are counted
+    // and summarised once a second. FATAL is never limited.
+    void setRateLimit(uint32_t messagesPerSecond);
+    // Collapse identical consecutive messages from one call site into
+    // "last message repeated N times"
+    void enableDeduplication(bool enable);
+
+    // Block until every message logged so far has been written
+    void flush();
+    // Drain the queue and stop the writer thread (also registered with atexit)
+    void shutdown();
+
+    // Cheap check used by the LOG_* macros before evaluating their arguments
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= static_cast<int>(currentLevel.load(std::memory_order_relaxed));
+    }
+
+    // Rate limit check for one call site, lock-free
+    bool allow(LogSite& site, LogLevel level) {
+        uint32_t limit = rateLimit.load(std::memory_order_relaxed);
+        if (limit == 0 || level == LogLevel::FATAL) {
+            return true;
+        }
+        uint32_t second = currentSecond.load(std::memory_order_relaxed);
+        if (site.window.load(std::memory_order_relaxed) != second) {
+            // Racing resets at a window boundary only let a few extra messages through
+            site.window.store(second, std::memory_order_relaxed);
+            site.count.store(0, std::memory_order_relaxed);
+        }
+        if (site.count.fetch_add(1, std::memory_order_relaxed) < limit) {
+            return true;
+        }
+        if (site.suppressed.fetch_add(1, std::memory_order_relaxed) == 0) {
+            registerSuppressed(site);
+        }
+        return false;
+    }
+
     // Logging functions
+    void log(LogLevel level, const std::string& message, const char* file = nullptr, int line = 0);
+
+    // Deferred formatting: arguments are packed as-is and only formatted on
+    // the writer thread. format must outlive the logger (a string literal).
+    template <typename... Args>
+    void logFormat(LogLevel level, const char* file, int line, const char* format, const Args&... args) {
+        thread_local std::string packed;
+        packed.clear();
+        (LogArgs::Pack(packed, args), ...);
+        logInternal(level, packed, file, line, format);
+    }
+
     void debug(const std::string& message, const char* file = nullptr, int line = 0);
     void info(const std::string& message, const char* file = nullptr, int line = 0);
     void warning(const std::string& message, const char* file = nullptr, int line = 0);
@@ -76,21 +265,60 @@ public:
     std::string glErrorToString(GLenum error);
 };
 
-// Convenient macros for logging
-#define LOG_DEBUG(msg) Logger::getInstance()->debug(msg, __FILE__, __LINE__)
-#define LOG_INFO(msg) Logger::getInstance()->info(msg, __FILE__, __LINE__)
-#define LOG_WARNING(msg) Logger::getInstance()->warning(msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) Logger::getInstance()->error(msg, __FILE__, __LINE__)
-#define LOG_FATAL(msg) Logger::getInstance()->fatal(msg, __FILE__, __LINE__)
-#define LOG_TODO(msg) Logger::getInstance()->todo(msg, __FILE__, __LINE__)
+// Convenient macros for logging. The level and the call site's rate limit
+// are checked before the message expression is evaluated, and levels below
+// LOG_MIN_LEVEL generate no code.
+#define LOG_AT(level, msg) do { \
+    if constexpr (static_cast<int>(level) >= LOG_MIN_LEVEL) { \
+        static LogSite logSite_(__FILE__, __LINE__); \
+        Logger* logger_ = Logger::getInstance(); \
+        if (logger_->isEnabled(level) && logger_->allow(logSite_, level)) { \
+            ALLOC_SCOPE("logging"); \
+            logger_->log(level, msg, __FILE__, __LINE__); \
+        } \
+    } \
+} while (0)
 
-// Macro for OpenGL error logging
+#define LOG_DEBUG(msg) LOG_AT(Logger::LogLevel::DEBUG, msg)
+#define LOG_INFO(msg) LOG_AT(Logger::LogLevel::INFO, msg)
+#define LOG_WARNING(msg) LOG_AT(Logger::LogLevel::WARNING, msg)
+#define LOG_ERROR(msg) LOG_AT(Logger::LogLevel::ERROR, msg)
+#define LOG_FATAL(msg) LOG_AT(Logger::LogLevel::FATAL, msg)
+#define LOG_TODO(msg) LOG_AT(Logger::LogLevel::TODO, msg)
+
+// Deferred-format variants: LOG_INFOF("Chunk {} {} took {:.2f} ms", x, z, ms)
+// The format has to be a string literal.
+#define LOG_FORMAT_AT(level, fmt, ...) do { \
+    if constexpr (static_cast<int>(level) >= LOG_MIN_LEVEL) { \
+        static LogSite logSite_(__FILE__, __LINE__); \
+        Logger* logger_ = Logger::getInstance(); \
+        if (logger_->isEnabled(level) && logger_->allow(logSite_, level)) { \
+            ALLOC_SCOPE("logging"); \
+            logger_->logFormat(level, __FILE__, __LINE__, "" fmt, ##__VA_ARGS__); \
+        } \
+    } \
+} while (0)
+
+#define LOG_DEBUGF(fmt, ...) LOG_FORMAT_AT(Logger::LogLevel::DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_INFOF(fmt, ...) LOG_FORMAT_AT(Logger::LogLevel::INFO, fmt, ##__VA_ARGS__)
+#define LOG_WARNINGF(fmt, ...) LOG_FORMAT_AT(Logger::LogLevel::WARNING, fmt, ##__VA_ARGS__)
+#define LOG_ERRORF(fmt, ...) LOG_FORMAT_AT(Logger::LogLevel::ERROR, fmt, ##__VA_ARGS__)
+#define LOG_FATALF(fmt, ...) LOG_FORMAT_AT(Logger::LogLevel::FATAL, fmt, ##__VA_ARGS__)
+
+// Macro for OpenGL error logging. glGetError can stall the driver, so this is
+// compiled out of release builds (GLDebug reports errors there).
+#ifdef NDEBUG
+#define LOG_GLERROR(context) ((void)0)
+#else
 #define LOG_GLERROR(context) { \
     GLenum glErr = glGetError(); \
-    if (glErr != GL_NO_ERROR) { \
+    static LogSite logSite_(__FILE__, __LINE__); \
+    if (glErr != GL_NO_ERROR && Logger::getInstance()->allow(logSite_, Logger::LogLevel::ERROR)) { \
+        ALLOC_SCOPE("logging"); \
         std::string errorMsg = std::string(context) + ": " + Logger::getInstance()->glErrorToString(glErr); \
-        Logger::getInstance()->error(errorMsg, __FILE__, __LINE__); \
+        Logger::getInstance()->log(Logger::LogLevel::ERROR, errorMsg, __FILE__, __LINE__); \
     } \
 }
+#endif
 
 #endif
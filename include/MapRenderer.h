@@ -0,0 +1,46 @@
+#ifndef MAP_RENDERER_H
+#define MAP_RENDERER_H
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "Camera2D.h"
+#include "MapTileCache.h"
+#include "shaderClass.h"
+#include "VAO.h"
+#include "VBO.h"
+
+// Top-down End map drawn through Camera2D.
+// Map space is (block x, -block z); one map unit is one block.
+class MapRenderer {
+public:
+    glm::vec3 endStoneColor = glm::vec3(0.86f, 0.85f, 0.62f);
+    glm::vec3 voidColor = glm::vec3(0.03f, 0.02f, 0.06f);
+    float panSpeed = 600.0f;  // Screen pixels per second
+
+    MapRenderer(MapTileCache& cache);
+
+    void Inputs(GLFWwindow* window, Camera2D& camera, float deltaTime);
+    void Draw(Camera2D& camera);
+    void Delete();
+
+    // Pyramid level used for the last drawn frame
+    int GetLevel() const { return currentLevel; }
+    int GetVisibleTiles() const { return visibleTiles; }
+
+    // Block coordinates under a screen position
+    static glm::vec2 ScreenToBlock(Camera2D& camera, const glm::vec2& screenPos);
+
+private:
+    MapTileCache& cache;
+    Shader shader;
+    VAO vao;
+    VBO vbo;
+    int currentLevel;
+    int visibleTiles;
+    bool dragging;
+    glm::vec2 lastCursor;
+};
+
+#endif // MAP_RENDERER_H
@@ -0,0 +1,94 @@
+#ifndef MAP_TILE_CACHE_H
+#define MAP_TILE_CACHE_H
+
+#include <GL/glew.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EndTerrain.h"
+#include "ThreadPool.h"
+
+// Quadtree pyramid of top-down End map tiles.
+// Level 0 tiles cover 256x256 blocks, every level above doubles the blocks per texel.
+// Tiles are baked lazily on worker threads, persisted to an on-disk pyramid and
+// only kept resident on the GPU while they are being drawn.
+class MapTileCache {
+public:
+    static const int TILE_SIZE = 256;
+    static const int MAX_LEVEL = 10;
+
+    MapTileCache(const EndTerrain& terrain, const std::string& cacheDir = "mapcache", int workerThreads = 0);
+    ~MapTileCache();
+
+    // Mark a tile as needed this frame. Lower priority values are baked first.
+    // Returns the tile texture (GL_RG8: top height, coverage) or 0 if not resident yet.
+    GLuint Request(int level, int tileX, int tileZ, float priority);
+
+    // Call once per frame after all requests: uploads finished tiles,
+    // dispatches new bake jobs and evicts tiles that were not requested
+    void Update();
+    void Shutdown();
+
+    static float TileWorldSize(int level) { return static_cast<float>(TILE_SIZE << level); }
+
+    // Statistics
+    int GetResidentCount() const { return residentCount; }
+    int GetInFlightCount() const { return inFlightCount; }
+    int GetBakedCount() const { return bakedCount.load(); }
+    int GetLoadedCount() const { return loadedCount.load(); }
+
+    int maxUploadsPerFrame;
+    int residentSlack;  // Recently used tiles kept resident after leaving the view
+
+private:
+    enum class TileState {
+        QUEUED,
+        BAKING,
+        READY,
+        RESIDENT
+    };
+
+    struct Tile {
+        int level;
+        int x;
+        int z;
+        TileState state;
+        GLuint texture;
+        std::vector<uint8_t> pixels;
+        uint64_t lastUsedFrame;
+        float priority;
+        bool cancelled;
+    };
+
+    const EndTerrain& terrain;
+    std::string cacheDir;
+    ThreadPool workers;
+
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Tile> tiles;
+    std::vector<GLuint> freeTextures;
+    uint64_t frame;
+    int residentCount;
+    int inFlightCount;
+    int maxInFlight;
+    std::atomic<int> bakedCount;
+    std::atomic<int> loadedCount;
+
+    static uint64_t MakeKey(int level, int tileX, int tileZ);
+    std::string TilePath(int level, int tileX, int tileZ) const;
+
+    // Worker side
+    void ProcessTile(uint64_t key);
+    void BakeTile(int level, int tileX, int tileZ, std::vector<uint8_t>& pixels) const;
+    bool LoadTile(const std::string& path, std::vector<uint8_t>& pixels) const;
+    void SaveTile(const std::string& path, const std::vector<uint8_t>& pixels) const;
+
+    void UploadTile(Tile& tile);
+    void ReleaseTexture(Tile& tile);
+};
+
+#endif // MAP_TILE_CACHE_H
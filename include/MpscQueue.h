@@ -0,0 +1,101 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free multi-producer / single-consumer ring buffer.
+// Every slot carries a sequence number telling whether it is free for the
+// producer claiming that position or published for the consumer (Vyukov's
+// bounded queue). Slots are written and read in place through callbacks, so
+// a T that owns memory (e.g. std::string) keeps its capacity across reuse.
+template <typename T>
+class MpscQueue {
+public:
+    // capacity is rounded up to a power of two
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Claims a slot and calls fill(T&) on it. Returns false if the queue is full.
+    template <typename Fill>
+    bool TryPush(Fill&& fill) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->data);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only: calls consume(T&) on the oldest published slot.
+    // Returns false if nothing is published yet.
+    template <typename Consume>
+    bool TryPop(Consume&& consume) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &cells[pos & mask];
+        if (cell->sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+
+        consume(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Empty() const {
+        size_t pos = dequeuePos.load(std::memory_order_acquire);
+        return cells[pos & mask].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    size_t Capacity() const { return mask + 1; }
+
+    // Total slots claimed / consumed so far
+    size_t PushCount() const { return enqueuePos.load(std::memory_order_acquire); }
+    size_t PopCount() const { return dequeuePos.load(std::memory_order_acquire); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // Producers and the consumer on separate cache lines
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+};
+
+#endif // MPSC_QUEUE_H
@@ -0,0 +1,48 @@
+#ifndef NOISE_VOLUME_H
+#define NOISE_VOLUME_H
+
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+// Tileable 3D gradient noise baked into a GL_REPEAT 3D texture, sampled by
+// end_raymarch.frag in place of the procedural simplex3D. The lattice hash
+// wraps every `period` cells so the volume tiles seamlessly; values are
+// rescaled to the RMS of EndNoise::simplex3D so density thresholds still
+// hold. Bakes are cached in cacheDir keyed by size/period/channels.
+class NoiseVolume {
+public:
+    int size = 128;             // Voxels per side
+    int period = 32;            // Noise units per tile (lattice cells)
+    bool gradients = false;     // RGBA = value + analytic gradient, otherwise R only
+
+    // Loads the cached bake or bakes and saves it, needs a current context
+    void Initialize(const std::string& cacheDir = "cache");
+
+    // Binds the volume to texture unit `unit`
+    void Bind(GLuint unit) const;
+
+    GLuint GetTexture() const { return texture; }
+
+    // Largest gradient magnitude of the baked noise and of simplex3D, per noise unit
+    float GetMaxGradient() const { return maxGradient; }
+    float GetReferenceGradient() const { return referenceGradient; }
+
+    void Delete();
+
+    // CPU reference of one baked voxel: value and (optionally) gradient
+    static void Sample(float x, float y, float z, int period, float out[4]);
+
+private:
+    GLuint texture = 0;
+    float maxGradient = 0.0f;
+    float referenceGradient = 0.0f;
+
+    std::string CachePath(const std::string& cacheDir) const;
+    bool Load(const std::string& path, std::vector<float>& voxels);
+    void Save(const std::string& path, const std::vector<float>& voxels) const;
+    void Bake(std::vector<float>& voxels);
+    int Channels() const { return gradients ? 4 : 1; }
+};
+
+#endif // NOISE_VOLUME_H
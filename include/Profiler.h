@@ -0,0 +1,106 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+// Set to 0 (CMake RENDERER_PROFILE_ZONES=OFF) to compile PROFILE_ZONE out entirely
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+// Static description of one PROFILE_ZONE call site
+struct ProfileSite {
+    const char* name;
+    const char* file;
+    int line;
+};
+
+// CPU zone profiler. Every thread records finished zones into its own ring
+// buffer (single writer, no locks); ExportChromeTrace copies the recent part
+// of every ring into a Chrome trace_event JSON file (chrome://tracing, Perfetto).
+namespace Profiler {
+    // Fields are relaxed atomics so the exporter may read a slot while its
+    // owner overwrites it; such slots are detected and dropped
+    struct Event {
+        std::atomic<const ProfileSite*> site;
+        std::atomic<uint64_t> begin;
+        std::atomic<uint64_t> end;
+    };
+
+    struct ThreadBuffer {
+        static const uint64_t CAPACITY = 1 << 15;   // Events kept per thread
+
+        Event events[CAPACITY];
+        std::atomic<uint64_t> head{0};              // Events written so far
+        uint32_t threadId = 0;
+        std::string name;
+    };
+
+    ThreadBuffer* RegisterThread();
+
+    inline ThreadBuffer* GetThreadBuffer() {
+        thread_local ThreadBuffer* buffer = RegisterThread();
+        return buffer;
+    }
+
+    // Zone clock in ticks: TSC on x86-64, steady_clock ns elsewhere.
+    // Ticks are converted to time only at export.
+    inline uint64_t Now() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    inline void Record(const ProfileSite* site, uint64_t begin, uint64_t end) {
+        ThreadBuffer* buffer = GetThreadBuffer();
+        uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        Event& event = buffer->events[head & (ThreadBuffer::CAPACITY - 1)];
+        event.site.store(site, std::memory_order_relaxed);
+        event.begin.store(begin, std::memory_order_relaxed);
+        event.end.store(end, std::memory_order_relaxed);
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Label for the calling thread in exported traces
+    void SetThreadName(const std::string& name);
+
+    // Writes zones that ended in the last `seconds` seconds
+    bool ExportChromeTrace(const std::string& path, double seconds = 10.0);
+}
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const ProfileSite* site) : site(site), begin(Profiler::Now()) {}
+    ~ProfileZone() { Profiler::Record(site, begin, Profiler::Now()); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const ProfileSite* site;
+    uint64_t begin;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Times the rest of the enclosing scope; name must be a string literal
+#if PROFILER_ENABLED
+#define PROFILE_ZONE(name) \
+    static constexpr ProfileSite PROFILE_CONCAT(profileSite_, __LINE__){"" name, __FILE__, __LINE__}; \
+    ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(&PROFILE_CONCAT(profileSite_, __LINE__))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
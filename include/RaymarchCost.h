@@ -0,0 +1,81 @@
+#ifndef RAYMARCH_COST_H
+#define RAYMARCH_COST_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+// Aggregate cost of the instrumented raymarch shader (RAY_COST variant).
+// With GL 4.3 the shader accumulates totals and a steps-per-ray histogram
+// in an SSBO with atomicAdd. Otherwise it writes per-pixel counts to an
+// RGBA16UI attachment that is read back through a PBO every
+// readbackInterval frames and reduced on the CPU. Either way results come
+// from a ring of buffers guarded by fences and are never waited on.
+class RaymarchCost {
+public:
+    static const int HISTOGRAM_BINS = 32;
+    static const int RING_SIZE = 3;
+
+    struct Stats {
+        uint64_t rays = 0;
+        uint64_t steps = 0;
+        uint64_t densityEvals = 0;
+        uint64_t refineSteps = 0;
+        uint64_t hits = 0;
+        uint32_t histogram[HISTOGRAM_BINS] = {};    // Rays by step count, bin width maxSteps / HISTOGRAM_BINS
+        int maxSteps = 0;
+    };
+
+    int readbackInterval = 8;
+
+    RaymarchCost();
+
+    // Picks the atomics or readback path, needs a current context
+    void Initialize();
+    bool IsInitialized() const { return initialized; }
+    bool UsesAtomics() const { return atomics; }
+
+    // #version line and defines for the instrumented shader variant
+    std::string ShaderPreamble() const;
+
+    // Around the instrumented draw, with the raymarch framebuffer bound
+    void BeginPass(int width, int height, int maxSteps);
+    void EndPass();
+
+    // Picks up finished samples without blocking
+    void Collect();
+
+    const Stats& GetStats() const { return latest; }
+    uint64_t GetSampleCount() const { return samples; }
+
+    void Delete();
+
+private:
+    struct Slot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        int width = 0;
+        int height = 0;
+        int maxSteps = 0;
+        bool pending = false;
+        size_t capacity = 0;
+    };
+
+    bool initialized;
+    bool atomics;
+    Slot slots[RING_SIZE];
+    int nextSlot;
+    int activeSlot;             // Slot being written this frame, -1 if none
+    GLuint scratchBuffer;       // Atomics target for frames that are not sampled
+    GLuint costTexture;         // Readback path attachment
+    int textureWidth;
+    int textureHeight;
+    int frameCounter;
+    Stats latest;
+    uint64_t samples;
+
+    void ReduceAtomics(const Slot& slot, const uint32_t* data);
+    void ReducePixels(const Slot& slot, const uint16_t* data);
+};
+
+#endif // RAYMARCH_COST_H
@@ -0,0 +1,34 @@
+#ifndef RAYMARCH_PRESETS_H
+#define RAYMARCH_PRESETS_H
+
+#include <string>
+#include <vector>
+
+#include "EndRenderer.h"
+
+// Named raymarch quality presets, stored as a small INI-style text file:
+//   [name]
+//   maxSteps = 256
+//   ...
+// gpuMs/ssim/psnr are informational values written by the tuner.
+struct RaymarchPreset {
+    std::string name;
+    RaymarchSettings settings;
+    float gpuMs = 0.0f;
+    float ssim = 0.0f;
+    float psnr = 0.0f;
+};
+
+class RaymarchPresets {
+public:
+    static const char* DEFAULT_PATH;
+
+    std::vector<RaymarchPreset> presets;
+
+    bool Load(const std::string& path = DEFAULT_PATH);
+    bool Save(const std::string& path = DEFAULT_PATH) const;
+
+    const RaymarchPreset* Find(const std::string& name) const;
+};
+
+#endif // RAYMARCH_PRESETS_H
@@ -0,0 +1,67 @@
+#ifndef RAYMARCH_TUNER_H
+#define RAYMARCH_TUNER_H
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CameraPath.h"
+#include "EndRenderer.h"
+#include "RaymarchPresets.h"
+
+// Offline quality/cost sweep of the End raymarcher.
+// A set of frames is sampled from camera flights and rendered once at
+// reference quality. Every parameter combination of the sweep grid is then
+// rendered over the same frames, timed with GL_TIME_ELAPSED queries and
+// compared to the reference (PSNR and SSIM). The Pareto front of
+// (GPU time, SSIM) is written out as named presets.
+class RaymarchTuner {
+public:
+    struct Result {
+        RaymarchSettings settings;
+        double gpuMs;   // Mean per frame
+        double psnr;    // dB, mean per frame
+        double ssim;    // Mean per frame
+    };
+
+    RaymarchTuner(GLFWwindow* window, EndRenderer& renderer, int width = 960, int height = 540, int framesPerFlight = 8);
+
+    // flights: built-in names or recorded files (see CameraPath::Resolve)
+    bool Run(const std::vector<std::string>& flights, RaymarchPresets& presets);
+
+    const std::vector<Result>& GetResults() const { return results; }
+
+    static RaymarchSettings ReferenceSettings();
+    static std::vector<RaymarchSettings> SweepGrid();
+
+    // Image metrics on tightly packed RGB8 images of the same size
+    static double Psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b);
+    static double Ssim(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int width, int height);
+
+    // Results that no other result beats in both time and SSIM, fastest first
+    static std::vector<Result> ParetoFront(std::vector<Result> candidates);
+
+private:
+    struct Sample {
+        Camera camera;
+        float time;
+        std::vector<uint8_t> reference;
+    };
+
+    GLFWwindow* window;
+    EndRenderer& renderer;
+    int width;
+    int height;
+    int framesPerFlight;
+    std::vector<Sample> samples;
+    std::vector<Result> results;
+
+    bool CollectSamples(const std::vector<std::string>& flights);
+    bool SettleIslandGrid(const Sample& sample, GLuint fbo);
+    double RenderTimed(const Sample& sample, GLuint fbo, GLuint query);
+    void ReadPixels(GLuint fbo, std::vector<uint8_t>& pixels) const;
+};
+
+#endif // RAYMARCH_TUNER_H
@@ -0,0 +1,73 @@
+#ifndef REPLAY_BENCHMARK_H
+#define REPLAY_BENCHMARK_H
+
+#include <GL/glew.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+#include "CameraPath.h"
+#include "RaymarchCost.h"
+
+// Drives a Camera from a recorded CameraPath at a fixed timestep and
+// measures per-frame CPU and GPU time. GPU times come from GL_TIME_ELAPSED
+// queries that are collected a few frames late so the replay never stalls.
+class ReplayBenchmark {
+public:
+    struct Summary {
+        double mean;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    ReplayBenchmark(const CameraPath& path, const std::string& name, int warmupFrames = 30);
+
+    bool IsFinished() const { return frame >= path.GetFrameCount(); }
+    size_t GetFrame() const { return frame; }
+    size_t GetFrameCount() const { return path.GetFrameCount(); }
+
+    // Simulated time of the current frame
+    float GetTime() const { return static_cast<float>(frame) * path.timestep; }
+
+    // Poses the camera for this frame and starts the timers
+    void BeginFrame(Camera& camera);
+    void EndFrame();
+
+    // Adds a ray cost sample to the "ray_cost" section, ignored during warmup
+    void AddRayCost(const RaymarchCost::Stats& stats);
+
+    // Collects outstanding GPU results, writes <outputDir>/<name>_<timestamp>.csv/.json
+    // and logs the percentile summary
+    void Finish(const std::string& outputDir = "replays");
+    void Delete();
+
+    static double Percentile(std::vector<double> values, double percentile);
+    static Summary Summarize(const std::vector<double>& values);
+
+private:
+    static const int QUERY_RING_SIZE = 4;
+
+    CameraPath path;
+    std::string name;
+    int warmupFrames;
+    size_t frame;
+
+    std::vector<double> cpuTimes;   // ms per frame
+    std::vector<double> gpuTimes;   // ms per frame, < 0 until available
+    std::chrono::steady_clock::time_point frameStart;
+
+    RaymarchCost::Stats rayCost;    // Summed over samples
+    uint64_t rayCostSamples;
+
+    GLuint queries[QUERY_RING_SIZE];
+    size_t queryFrame[QUERY_RING_SIZE];
+    bool queryPending[QUERY_RING_SIZE];
+    bool queriesCreated;
+
+    void CollectQueries(bool wait);
+};
+
+#endif // REPLAY_BENCHMARK_H
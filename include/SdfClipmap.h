@@ -0,0 +1,80 @@
+#ifndef SDF_CLIPMAP_H
+#define SDF_CLIPMAP_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <vector>
+
+// Nested camera-centred 3D distance field clipmaps of the End terrain for
+// end_raymarch.frag. Level k covers resolution^3 voxels of voxelSize * 2^k
+// blocks; textures are addressed toroidally (GL_REPEAT on world voxel
+// coordinates) so moving a level only bakes the newly exposed slabs.
+//
+// Stored values are conservative lower bounds on the distance to solid
+// terrain that stay valid under trilinear filtering: exact Euclidean
+// distance to voxels that can hold terrain (inside their columns' y-range
+// and not proven empty by the Lipschitz bound), up to `band` voxels,
+// combined with -density / lipschitz, minus half a voxel diagonal.
+// Bakes run on worker threads from the CPU port of the density field.
+class SdfClipmap {
+public:
+    static constexpr int LEVELS = 5;
+
+    int resolution = 64;        // Voxels per side of every level
+    float voxelSize = 2.0f;     // Blocks per voxel at level 0, doubles per level
+    int band = 8;               // Distances beyond this many voxels are clamped
+
+    SdfClipmap();
+
+    // Uploads finished bakes and recentres levels on the camera. A change of
+    // octaves or lipschitz rebakes everything. Call once per frame.
+    void Update(const glm::vec3& cameraPos, int octaves, float lipschitz);
+
+    // Binds level k to texture unit firstUnit + k
+    void Bind(GLuint firstUnit) const;
+
+    // True once every level holds a bake for the current parameters
+    bool IsValid() const;
+
+    // World voxel (in level units) of the level's minimum corner
+    glm::ivec3 GetOrigin(int level) const { return levels[level].origin; }
+
+    void Delete();
+
+private:
+    // Region of world voxels and its baked values, x fastest
+    struct Box {
+        glm::ivec3 min;
+        glm::ivec3 size;
+        std::vector<float> values;
+    };
+
+    struct Level {
+        GLuint texture = 0;
+        glm::ivec3 origin = glm::ivec3(0);
+        bool valid = false;
+        bool baking = false;
+        int generation = 0;             // Parameters the pending bake used
+        glm::ivec3 pendingOrigin = glm::ivec3(0);
+        std::vector<Box> pending;       // Written by the worker
+        std::atomic<bool> ready{false};
+    };
+
+    Level levels[LEVELS];
+    int octaves = -1;
+    float lipschitz = 0.0f;
+    int generation = 0;
+
+    // Declared last so workers are joined before the levels they write go away
+    ThreadPool pool;
+
+    glm::ivec3 TargetOrigin(int level, const glm::vec3& cameraPos) const;
+    void Bake(Box& box, int level, int octaves, float lipschitz) const;
+    void Upload(int level, const Box& box);
+};
+
+#endif // SDF_CLIPMAP_H
@@ -0,0 +1,46 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads consuming a FIFO job queue.
+// Callers that need prioritisation keep their own ordered request list and
+// only feed the pool a bounded number of jobs at a time.
+class ThreadPool {
+public:
+    // threadCount <= 0 uses hardware_concurrency() - 1 (at least one worker).
+    // Workers show up as "<name> <index>" in profiler traces.
+    explicit ThreadPool(int threadCount = 0, const std::string& name = "worker");
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    // Block until the queue is empty and every worker is idle
+    void WaitIdle();
+    void Shutdown();
+
+    int GetThreadCount() const { return static_cast<int>(workers.size()); }
+    int GetPendingJobs();
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable jobCondition;
+    std::condition_variable idleCondition;
+    int activeJobs;
+    bool stopping;
+
+    void WorkerLoop(std::string name);
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,48 @@
+#ifndef VOXEL_VOLUME_H
+#define VOXEL_VOLUME_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "ChunkSection.h"
+
+// Block occupancy of the chunk columns around the camera for
+// shaders/block_dda.frag, as three GL_R8UI 3D textures over a toroidal
+// window of WINDOW x WINDOW columns (texel = world cell mod window size):
+//   blocks   - 2x2x2 blocks per texel, one bit each (x | y << 1 | z << 2)
+//   cells    - 1 if any block of a 4^3 cell is solid
+//   sections - 1 if any block of a 16^3 section is solid
+class VoxelVolume {
+public:
+    static const int WINDOW = 64;       // Chunk columns per side, power of two
+    static const int SECTIONS = 8;      // Per column, MIN_Y..MAX_Y
+
+    VoxelVolume();
+
+    void Create();
+    bool IsValid() const { return blockTexture != 0; }
+
+    // Writes a column's sections into its slot, or clears the slot
+    void WriteColumn(int chunkX, int chunkZ, const std::vector<ChunkSection>& sections);
+    void ClearColumn(int chunkX, int chunkZ);
+
+    // Blocks, cells and sections on firstUnit, +1, +2
+    void Bind(GLuint firstUnit) const;
+    void Delete();
+
+private:
+    GLuint blockTexture;
+    GLuint cellTexture;
+    GLuint sectionTexture;
+
+    // Staging for one column, x fastest then y then z as GL expects
+    std::vector<uint8_t> blocks;
+    std::vector<uint8_t> cells;
+    uint8_t sections[SECTIONS];
+
+    void Upload(int chunkX, int chunkZ);
+};
+
+#endif // VOXEL_VOLUME_H
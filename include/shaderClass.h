@@ -14,6 +14,10 @@ class Shader{
     GLuint ID;
     Shader(const char* vertexFile, const char* fragmentFile);
 
+    // Variant build: preamble replaces the #version line if it starts with
+    // one, otherwise it is inserted right after it (e.g. "#define X\n")
+    Shader(const char* vertexFile, const char* fragmentFile, const std::string& preamble);
+
     void Activate();
     void Delete();
 };
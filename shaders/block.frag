@@ -0,0 +1,51 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 vLocalPos;
+in vec3 vViewOffset;
+flat in int vFace;
+
+uniform ivec3 uSectionBlock;            // World block of the section origin
+uniform vec3 uEndStoneColor;
+uniform vec3 uFogColor;
+uniform float uFogDensity;
+
+const vec3 FACE_NORMALS[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0));
+
+// Minecraft's fixed per-face brightness
+const float FACE_SHADE[6] = float[6](0.6, 0.6, 1.0, 0.5, 0.8, 0.8);
+
+uint hashBlock(ivec3 p) {
+    uvec3 u = uvec3(p);
+    uint h = (u.x * 73856093u) ^ (u.y * 19349663u) ^ (u.z * 83492791u);
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return h;
+}
+
+void main() {
+    // Greedy quads span many blocks, so the block pattern comes from the
+    // position: the block is half a block behind the face
+    vec3 normal = FACE_NORMALS[vFace];
+    ivec3 block = ivec3(floor(vLocalPos - normal * 0.5)) + uSectionBlock;
+    vec3 inBlock = fract(vLocalPos);
+    vec2 uv = vFace < 2 ? inBlock.zy : (vFace < 4 ? inBlock.xz : inBlock.xy);
+
+    // Per-block tint, 16x16 texel speckle and darkened block edges
+    uint blockHash = hashBlock(block);
+    float tint = 0.94 + 0.12 * float(blockHash & 255u) / 255.0;
+    ivec2 texel = ivec2(uv * 16.0);
+    float speckle = 0.9 + 0.1 * float(hashBlock(ivec3(texel, int(blockHash & 0xFFFFu))) & 255u) / 255.0;
+    float edge = min(min(uv.x, 1.0 - uv.x), min(uv.y, 1.0 - uv.y));
+    float border = mix(0.8, 1.0, smoothstep(0.0, 1.0 / 16.0, edge));
+
+    vec3 color = uEndStoneColor * tint * speckle * border * FACE_SHADE[vFace];
+
+    // Same fog as end_raymarch.frag
+    float fogFactor = 1.0 - exp(-length(vViewOffset) * uFogDensity * 0.0001);
+    FragColor = vec4(mix(color, uFogColor, fogFactor), 1.0);
+}
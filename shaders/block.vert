@@ -0,0 +1,21 @@
+#version 330 core
+
+// Greedy-meshed chunk section quads (BlockMesher)
+layout(location = 0) in vec3 aPos;      // Section-local block coordinates
+layout(location = 1) in float aFace;    // 0..5 = +x -x +y -y +z -z
+
+uniform mat4 uViewProj;                 // Camera-chunk-relative
+uniform vec3 uCameraPos;                // Camera-chunk-relative
+uniform vec3 uSectionOffset;            // Section origin relative to the camera chunk
+
+out vec3 vLocalPos;
+out vec3 vViewOffset;
+flat out int vFace;
+
+void main() {
+    vec3 pos = uSectionOffset + aPos;
+    vLocalPos = aPos;
+    vViewOffset = pos - uCameraPos;
+    vFace = int(aFace + 0.5);
+    gl_Position = uViewProj * vec4(pos, 1.0);
+}
@@ -0,0 +1,143 @@
+#version 330 core
+
+// Exact block view: Amanatides-Woo traversal of the VoxelVolume occupancy,
+// hierarchical over 16^3 sections, 4^3 cells and blocks. An empty cell is
+// crossed in one step; the walk descends into occupied ones and climbs back
+// up when it leaves its parent cell.
+
+layout(location = 0) out vec4 FragColor;
+
+in vec2 vScreenPos;
+in vec3 vRayDir;
+
+uniform vec3 uCameraPos;            // Camera-chunk-relative
+uniform ivec3 uChunkOrigin;         // Camera chunk
+uniform float uMaxDistance;
+uniform int uMaxSteps;
+
+uniform usampler3D uVoxelBlocks;    // 2x2x2 blocks per texel, bit x | y << 1 | z << 2
+uniform usampler3D uVoxelCells;     // 1 per 4^3 cell holding any block
+uniform usampler3D uVoxelSections;  // 1 per 16^3 section holding any block
+uniform ivec2 uVolumeWindowMin;     // World chunk of the window's minimum corner
+uniform int uVolumeSize;            // Chunk columns per side, texel = world cell mod size
+
+uniform vec3 uEndStoneColor;
+uniform vec3 uSkyColor;
+uniform vec3 uFogColor;
+uniform float uFogDensity;
+
+const int COLUMN_HEIGHT = 128;
+
+// Same block look as block.frag
+const float FACE_SHADE[6] = float[6](0.6, 0.6, 1.0, 0.5, 0.8, 0.8);
+
+uint hashBlock(ivec3 p) {
+    uvec3 u = uvec3(p);
+    uint h = (u.x * 73856093u) ^ (u.y * 19349663u) ^ (u.z * 83492791u);
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    return h;
+}
+
+vec3 shadeBlock(ivec3 block, int face, vec2 uv, float t) {
+    uint blockHash = hashBlock(block);
+    float tint = 0.94 + 0.12 * float(blockHash & 255u) / 255.0;
+    ivec2 texel = ivec2(uv * 16.0);
+    float speckle = 0.9 + 0.1 * float(hashBlock(ivec3(texel, int(blockHash & 0xFFFFu))) & 255u) / 255.0;
+    float edge = min(min(uv.x, 1.0 - uv.x), min(uv.y, 1.0 - uv.y));
+    float border = mix(0.8, 1.0, smoothstep(0.0, 1.0 / 16.0, edge));
+    vec3 color = uEndStoneColor * tint * speckle * border * FACE_SHADE[face];
+
+    float fogFactor = 1.0 - exp(-t * uFogDensity * 0.0001);
+    return mix(color, uFogColor, fogFactor);
+}
+
+// Whether the level's cell around world block b holds any block
+// (level 0 = the block itself, 1 = its 4^3 cell, 2 = its section)
+bool occupied(ivec3 b, int level) {
+    int mask = uVolumeSize * 16 - 1;
+    ivec3 wrapped = ivec3(b.x & mask, b.y, b.z & mask);
+    if (level == 2) {
+        return texelFetch(uVoxelSections, wrapped >> 4, 0).r != 0u;
+    }
+    if (level == 1) {
+        return texelFetch(uVoxelCells, wrapped >> 2, 0).r != 0u;
+    }
+    uint bits = texelFetch(uVoxelBlocks, wrapped >> 1, 0).r;
+    int bit = (b.x & 1) | ((b.y & 1) << 1) | ((b.z & 1) << 2);
+    return (bits & (1u << uint(bit))) != 0u;
+}
+
+vec4 traceVoxels(vec3 rayOrigin, vec3 rayDir) {
+    // Axis-parallel rays never cross that axis' cell walls
+    vec3 safeDir = mix(rayDir, vec3(1e-6), lessThan(abs(rayDir), vec3(1e-6)));
+    vec3 invDir = 1.0 / safeDir;
+    ivec3 blockOrigin = uChunkOrigin * 16;
+
+    // Clip to the window, camera-local
+    vec3 boxMin = vec3(ivec3(uVolumeWindowMin.x * 16, 0, uVolumeWindowMin.y * 16) - blockOrigin);
+    vec3 boxMax = boxMin + vec3(uVolumeSize * 16, COLUMN_HEIGHT, uVolumeSize * 16);
+    vec3 tLow = min((boxMin - rayOrigin) * invDir, (boxMax - rayOrigin) * invDir);
+    vec3 tHigh = max((boxMin - rayOrigin) * invDir, (boxMax - rayOrigin) * invDir);
+    float tEnter = max(max(tLow.x, tLow.y), tLow.z);
+    float tExit = min(min(min(tHigh.x, tHigh.y), tHigh.z), uMaxDistance);
+    if (max(tEnter, 0.0) >= tExit) {
+        return vec4(uSkyColor, 1.0);
+    }
+
+    // Axis of the last cell wall crossed, -1 while still in the camera's cell
+    int axis = -1;
+    float t = 0.0;
+    if (tEnter > 0.0) {
+        t = tEnter;
+        axis = tEnter == tLow.x ? 0 : (tEnter == tLow.y ? 1 : 2);
+    }
+    int level = 2;
+
+    for (int i = 0; i < uMaxSteps; i++) {
+        vec3 pos = rayOrigin + rayDir * t;
+        ivec3 local = ivec3(floor(pos));
+        if (axis >= 0) {
+            // Exactly on the wall just crossed, pick the cell being entered
+            local[axis] = int(round(pos[axis])) - (rayDir[axis] < 0.0 ? 1 : 0);
+        }
+        ivec3 block = local + blockOrigin;
+        if (block.y < 0 || block.y >= COLUMN_HEIGHT) break;
+
+        if (occupied(block, level)) {
+            if (level > 0) {
+                level--;
+                continue;
+            }
+            int face = axis < 0 ? 2 : axis * 2 + (rayDir[axis] > 0.0 ? 1 : 0);
+            vec3 inBlock = pos - vec3(local);
+            vec2 uv = axis == 0 ? inBlock.zy : (axis == 1 ? inBlock.xz : inBlock.xy);
+            return vec4(shadeBlock(block, face, clamp(uv, 0.0, 1.0), t), 1.0);
+        }
+
+        // Step over the empty cell
+        int size = level == 2 ? 16 : (level == 1 ? 4 : 1);
+        ivec3 cellMin = block - (block & (size - 1));
+        vec3 exitPlane = vec3(cellMin - blockOrigin) + step(vec3(0.0), rayDir) * float(size);
+        vec3 exitT = (exitPlane - rayOrigin) * invDir;
+        t = min(exitT.x, min(exitT.y, exitT.z));
+        axis = t == exitT.x ? 0 : (t == exitT.y ? 1 : 2);
+        if (t >= tExit) break;
+
+        // Leaving the parent cell as well: continue a level up
+        if (level < 2) {
+            int parentSize = size * 4;
+            int wall = cellMin[axis] + (rayDir[axis] > 0.0 ? size : 0);
+            if ((wall & (parentSize - 1)) == 0) {
+                level++;
+            }
+        }
+    }
+
+    return vec4(uSkyColor, 1.0);
+}
+
+void main() {
+    FragColor = traceVoxels(uCameraPos, normalize(vRayDir));
+}
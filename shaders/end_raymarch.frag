@@ -3,7 +3,7 @@
 // End Dimension Ray Marching Fragment Shader
 // This shader renders Minecraft's End dimension terrain using ray marching
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
 
 // From vertex shader
 in vec2 vScreenPos;
@@ -26,6 +26,10 @@ uniform float uTime;              // For subtle animation effects
 // Quality settings
 uniform int uOctaves;             // Noise octaves (LOD-adjusted)
 uniform float uStepMultiplier;    // Step size multiplier (LOD-adjusted)
+uniform int uRefineSteps;         // Binary search iterations on hit
+uniform int uSphereTrace;         // 0 = heuristic march, 1 = Lipschitz sphere tracing
+uniform float uLipschitz;         // Bound on |grad endDensity|, see tools/lipschitz_estimate
+uniform float uRelaxation;        // Over-relaxation factor for sphere tracing (1 = none)
 
 // Colors
 uniform vec3 uEndStoneColor;      // Base color for end stone
@@ -33,6 +37,72 @@ uniform vec3 uSkyColor;           // Background color (dark void)
 uniform vec3 uFogColor;           // Distance fog color
 uniform float uFogDensity;        // Fog density factor
 
+// Baked noise (NoiseVolume): tileable 3D noise repeating every uNoisePeriod units
+uniform int uBakedNoise;          // 0 = procedural simplex3D, 1 = texture lookups
+uniform sampler3D uNoiseVolume;
+uniform float uNoisePeriod;
+
+// Empty-space skipping (IslandGrid): one level 0 texel per chunk, rg = y-range
+// that can hold terrain (inverted if none), mips hold the union of children
+uniform int uUseIslandGrid;
+uniform sampler2D uIslandGrid;
+uniform ivec2 uIslandGridOrigin;  // World chunk of texel (0, 0)
+uniform int uIslandGridSize;
+uniform int uIslandGridLevels;
+
+// Distance field clipmap (SdfClipmap): level k has voxels of uSdfVoxelSize * 2^k
+// blocks, texel = world voxel mod uSdfResolution
+const int SDF_LEVELS = 5;
+uniform int uUseSdf;
+uniform int uSdfShadows;
+uniform sampler3D uSdfLevels[SDF_LEVELS];
+uniform ivec3 uSdfOrigin[SDF_LEVELS];  // World voxel of each level's minimum corner
+uniform float uSdfVoxelSize;
+uniform int uSdfResolution;
+
+// Sparse brickmap (BrickMap): one grid cell per 16-block brick, texel = world
+// chunk mod uBrickGridSize; 0 = not streamed, 1 = empty, 2 = full, otherwise
+// 3 + atlas slot of its 9^3 density samples
+const int BRICKS_PER_COLUMN = 8;
+const uint BRICK_UNKNOWN = 0u;
+const uint BRICK_EMPTY = 1u;
+const uint BRICK_FULL = 2u;
+const uint BRICK_FIRST_SLOT = 3u;
+uniform int uUseBricks;
+uniform usampler3D uBrickGrid;
+uniform sampler3D uBrickAtlas;
+uniform int uBrickGridSize;
+uniform ivec2 uBrickWindowMin;    // World chunk of the grid window's minimum corner
+uniform ivec3 uBrickAtlasSlots;
+
+// ============================================================================
+// COST INSTRUMENTATION (variant built by EndRenderer with RAY_COST defined)
+// ============================================================================
+
+#ifdef RAY_COST
+uniform int uCostView;            // 0 = shaded, 1 = steps, 2 = density evaluations, 3 = refine steps
+
+#ifdef RAY_COST_ATOMICS
+// Frame totals (steps, density evaluations, refine steps, hits) and rays by step count
+layout(std430, binding = 0) buffer RayCost {
+    uint costTotals[4];
+    uint costHistogram[RAY_COST_BINS];
+};
+#else
+// Per-pixel counts, read back and reduced on the CPU
+layout(location = 1) out uvec4 CostOutput;
+#endif
+
+int costSteps = 0;
+int costDensityEvals = 0;
+int costRefineSteps = 0;
+int costHit = 0;
+
+#define COST_COUNT(counter) counter++
+#else
+#define COST_COUNT(counter)
+#endif
+
 // ============================================================================
 // NOISE FUNCTIONS
 // ============================================================================
@@ -116,6 +186,15 @@ float simplex2D(vec2 p) {
     return 70.0 * (w.x * dot(g0, x0) + w.y * dot(g1, x1) + w.z * dot(g2, x2));
 }
 
+// 3D noise from the baked volume (one filtered tap) or computed procedurally.
+// textureLod because the march loop is non-uniform control flow.
+float noise3D(vec3 p) {
+    if (uBakedNoise != 0) {
+        return textureLod(uNoiseVolume, p / uNoisePeriod, 0.0).r;
+    }
+    return simplex3D(p);
+}
+
 // Octave noise (FBM)
 float fbm3D(vec3 p, int octaves) {
     float value = 0.0;
@@ -124,7 +203,7 @@ float fbm3D(vec3 p, int octaves) {
     float maxValue = 0.0;
     
     for (int i = 0; i < octaves; i++) {
-        value += simplex3D(p * frequency) * amplitude;
+        value += noise3D(p * frequency) * amplitude;
         maxValue += amplitude;
         amplitude *= 0.5;
         frequency *= 2.0;
@@ -142,6 +221,10 @@ const float EXCLUSION_ZONE_START = 500.0;
 const float EXCLUSION_ZONE_END = 1024.0;
 const float SEA_LEVEL = 64.0;
 
+// Solid terrain never extends outside this y-range (EndTerrain::MIN_Y/MAX_Y)
+const float TERRAIN_MIN_Y = 0.0;
+const float TERRAIN_MAX_Y = 128.0;
+
 // Height profile for main island
 float mainIslandHeight(float dist) {
     if (dist > MAIN_ISLAND_RADIUS) return -100.0;
@@ -163,7 +246,7 @@ float mainIslandDensity(vec3 pos, float horizDist) {
     baseDensity += noise * 8.0;
     
     // Detail noise
-    float detail = simplex3D(pos * 0.05) * 2.0;
+    float detail = noise3D(pos * 0.05) * 2.0;
     baseDensity += detail;
     
     // Floor cutoff
@@ -241,6 +324,7 @@ float outerIslandDensity(vec3 pos, float horizDist) {
 
 // Main density function
 float endDensity(vec3 worldPos) {
+    COST_COUNT(costDensityEvals);
     float horizDist = length(worldPos.xz);
     
     if (horizDist < EXCLUSION_ZONE_START) {
@@ -254,6 +338,21 @@ float endDensity(vec3 worldPos) {
     return outerIslandDensity(worldPos, horizDist);
 }
 
+// Lower bound on the distance to solid terrain (EndTerrain::DistanceBound)
+float distanceBound(vec3 worldPos, float density) {
+    float bound = -density / uLipschitz;
+    
+    // Solid terrain is confined to TERRAIN_MIN_Y..TERRAIN_MAX_Y
+    bound = max(bound, max(TERRAIN_MIN_Y - worldPos.y, worldPos.y - TERRAIN_MAX_Y));
+    
+    // Nothing inside the exclusion ring, distance to its walls is horizontal
+    float horizDist = length(worldPos.xz);
+    if (horizDist >= EXCLUSION_ZONE_START && horizDist < EXCLUSION_ZONE_END) {
+        bound = max(bound, min(horizDist - EXCLUSION_ZONE_START, EXCLUSION_ZONE_END - horizDist));
+    }
+    return bound;
+}
+
 // ============================================================================
 // SURFACE NORMAL CALCULATION
 // ============================================================================
@@ -268,6 +367,75 @@ vec3 calculateNormal(vec3 pos) {
     ));
 }
 
+// ============================================================================
+// SDF CLIPMAP
+// ============================================================================
+
+float sdfVoxelSize(int level) {
+    return uSdfVoxelSize * float(1 << level);
+}
+
+// Finest level whose box holds worldPos with room for trilinear filtering, -1 if none
+int sdfLevel(vec3 worldPos) {
+    for (int level = 0; level < SDF_LEVELS; level++) {
+        vec3 voxel = worldPos / sdfVoxelSize(level) - vec3(uSdfOrigin[level]);
+        if (all(greaterThanEqual(voxel, vec3(1.0))) && all(lessThanEqual(voxel, vec3(float(uSdfResolution) - 1.0)))) {
+            return level;
+        }
+    }
+    return -1;
+}
+
+// Lower bound on the distance to terrain, biased low by half a voxel diagonal
+float sampleSdf(int level, vec3 worldPos) {
+    vec3 uvw = worldPos / (sdfVoxelSize(level) * float(uSdfResolution));
+    if (level == 0) return textureLod(uSdfLevels[0], uvw, 0.0).r;
+    if (level == 1) return textureLod(uSdfLevels[1], uvw, 0.0).r;
+    if (level == 2) return textureLod(uSdfLevels[2], uvw, 0.0).r;
+    if (level == 3) return textureLod(uSdfLevels[3], uvw, 0.0).r;
+    return textureLod(uSdfLevels[4], uvw, 0.0).r;
+}
+
+// Unbiased estimate for shading, 1e3 outside the clipmap
+float shadingSdf(vec3 worldPos) {
+    int level = sdfLevel(worldPos);
+    return level < 0 ? 1e3 : sampleSdf(level, worldPos) + sdfVoxelSize(level) * 0.866;
+}
+
+// Soft shadow towards the light by sphere tracing the clipmap (Quilez), 1 = lit
+float sdfSoftShadow(vec3 worldPos, vec3 normal, vec3 lightDir) {
+    float voxel = sdfVoxelSize(max(sdfLevel(worldPos), 0));
+    vec3 start = worldPos + normal * voxel;
+    float result = 1.0;
+    float t = voxel;
+    
+    for (int i = 0; i < 32 && result > 0.0; i++) {
+        vec3 pos = start + lightDir * t;
+        int level = sdfLevel(pos);
+        if (level < 0 || pos.y > TERRAIN_MAX_Y) break;
+        float bound = sampleSdf(level, pos) + sdfVoxelSize(level) * 0.866;
+        result = min(result, 8.0 * bound / t);
+        t += max(bound, sdfVoxelSize(level) * 0.5);
+    }
+    
+    return clamp(result, 0.0, 1.0);
+}
+
+// Occlusion from free space along the normal, 1 = open
+float sdfAmbientOcclusion(vec3 worldPos, vec3 normal) {
+    float voxel = sdfVoxelSize(max(sdfLevel(worldPos), 0));
+    float occlusion = 0.0;
+    float weight = 1.0;
+    
+    for (int i = 1; i <= 5; i++) {
+        float h = voxel * float(i);
+        occlusion += max(h - shadingSdf(worldPos + normal * h), 0.0) * weight;
+        weight *= 0.7;
+    }
+    
+    return clamp(1.0 - occlusion / (voxel * 3.0), 0.0, 1.0);
+}
+
 // ============================================================================
 // LIGHTING
 // ============================================================================
@@ -277,19 +445,24 @@ vec3 shade(vec3 pos, vec3 normal) {
     vec3 lightDir = normalize(vec3(0.3, 1.0, 0.2));
     float diffuse = max(dot(normal, lightDir), 0.0);
     
-    // Ambient occlusion approximation based on position
+    // Shadows and ambient occlusion need the distance field
     float ao = 1.0;
+    float shadow = 1.0;
+    if (uUseSdf != 0 && uSdfShadows != 0) {
+        ao = sdfAmbientOcclusion(pos, normal);
+        shadow = sdfSoftShadow(pos, normal, lightDir);
+    }
     
     // Combine lighting
     vec3 color = uEndStoneColor;
     
     // Add some variation based on position
-    float variation = simplex3D(pos * 0.03) * 0.1;
+    float variation = noise3D(pos * 0.03) * 0.1;
     color += vec3(variation, variation * 0.5, 0.0);
     
     // Apply lighting
     float ambient = 0.3;
-    color *= ambient + diffuse * 0.7;
+    color *= ambient + diffuse * shadow * 0.7;
     color *= ao;
     
     return color;
@@ -299,12 +472,51 @@ vec3 shade(vec3 pos, vec3 normal) {
 // RAY MARCHING
 // ============================================================================
 
-vec4 rayMarch(vec3 rayOrigin, vec3 rayDir) {
-    float t = 0.0;
-    float maxDist = uMaxDistance;
-    float baseStep = 1.0 * uStepMultiplier;
+// Binary search for the surface between tLow (outside) and tHigh (inside),
+// then shade and fog the hit
+vec4 shadeHit(vec3 rayOrigin, vec3 rayDir, float tLow, float tHigh) {
+    for (int j = 0; j < uRefineSteps; j++) {
+        COST_COUNT(costRefineSteps);
+        float tMid = (tLow + tHigh) * 0.5;
+        vec3 midPos = rayOrigin + rayDir * tMid;
+        vec3 midWorld = midPos + vec3(uChunkOrigin) * 16.0;
+        
+        if (endDensity(midWorld) > 0.0) {
+            tHigh = tMid;
+        } else {
+            tLow = tMid;
+        }
+    }
+    
+    COST_COUNT(costHit);
+    float t = tHigh;
+    vec3 hitPos = rayOrigin + rayDir * t;
+    vec3 hitWorld = hitPos + vec3(uChunkOrigin) * 16.0;
+    
+    // Calculate normal and shade
+    vec3 normal = calculateNormal(hitWorld);
+    vec3 color = shade(hitWorld, normal);
+    
+    // Apply distance fog
+    float fogFactor = 1.0 - exp(-t * uFogDensity * 0.0001);
+    color = mix(color, uFogColor, fogFactor);
     
-    for (int i = 0; i < uMaxSteps; i++) {
+    return vec4(color, 1.0);
+}
+
+// Marches [tStart, tEnd] with the heuristic step or, with uSphereTrace,
+// sphere tracing on distanceBound with over-relaxation (Keinert et al.).
+// Sphere tracing never steps below the heuristic base step, so features
+// thinner than that can still be stepped over. steps is shared by all
+// segments of a ray. Returns true and the shaded colour on a hit.
+bool marchSegment(vec3 rayOrigin, vec3 rayDir, float tStart, float tEnd, inout int steps, out vec4 color) {
+    float t = tStart;
+    float prevT = tStart;
+    float prevRadius = 0.0;
+    float omega = uRelaxation;
+    
+    for (; steps < uMaxSteps; steps++) {
+        COST_COUNT(costSteps);
         vec3 pos = rayOrigin + rayDir * t;
         
         // Convert to world coordinates (add chunk origin)
@@ -313,54 +525,281 @@ vec4 rayMarch(vec3 rayOrigin, vec3 rayDir) {
         float density = endDensity(worldPos);
         
         if (density > 0.0) {
-            // Hit! Refine position with binary search
-            float tLow = t - baseStep;
-            float tHigh = t;
+            // Hit! prevT was outside, refine in between
+            color = shadeHit(rayOrigin, rayDir, prevT, t);
+            steps++;
+            return true;
+        }
+        
+        // Base step, scaled with distance from camera for LOD
+        float minStep = uStepMultiplier * (1.0 + t * 0.001);
+        float stepSize;
+        
+        if (uSphereTrace != 0) {
+            float radius = distanceBound(worldPos, density);
             
-            for (int j = 0; j < 4; j++) {
-                float tMid = (tLow + tHigh) * 0.5;
-                vec3 midPos = rayOrigin + rayDir * tMid;
-                vec3 midWorld = midPos + vec3(uChunkOrigin) * 16.0;
-                
-                if (endDensity(midWorld) > 0.0) {
-                    tHigh = tMid;
-                } else {
-                    tLow = tMid;
-                }
+            // Over-relaxed step overshot: the bounding spheres of the last two
+            // samples do not overlap, so part of the step was never proven
+            // empty. Redo it unrelaxed from the previous sample.
+            if (omega > 1.0 && radius + prevRadius < t - prevT) {
+                t = prevT + max(prevRadius * uStepMultiplier, uStepMultiplier * (1.0 + prevT * 0.001));
+                omega = 1.0;
+                continue;
             }
             
-            t = tHigh;
-            vec3 hitPos = rayOrigin + rayDir * t;
-            vec3 hitWorld = hitPos + vec3(uChunkOrigin) * 16.0;
-            
-            // Calculate normal and shade
-            vec3 normal = calculateNormal(hitWorld);
-            vec3 color = shade(hitWorld, normal);
+            prevRadius = radius;
             
-            // Apply distance fog
-            float fogFactor = 1.0 - exp(-t * uFogDensity * 0.0001);
-            color = mix(color, uFogColor, fogFactor);
+            // Proven empty up to the end of the segment
+            if (t + max(radius, minStep) > tEnd) break;
             
-            return vec4(color, 1.0);
+            stepSize = max(radius * omega * uStepMultiplier, minStep);
+        } else {
+            // Larger steps when far from surfaces (large negative density)
+            // Smaller steps when close to surfaces
+            float adaptiveFactor = 1.0 + clamp(-density * 0.1, 0.0, 5.0);
+            stepSize = minStep * adaptiveFactor;
+        }
+        
+        prevT = t;
+        t += stepSize;
+        
+        if (t > tEnd) break;
+    }
+    
+    return false;
+}
+
+// Ray parameter range inside the horizontal slab lo <= y <= hi, empty if x > y.
+// An inverted slab (lo > hi, as stored for empty columns) is always missed.
+vec2 slabInterval(float originY, float dirY, float lo, float hi) {
+    if (lo > hi) {
+        return vec2(1.0, 0.0);
+    }
+    if (abs(dirY) < 1e-6) {
+        return (originY >= lo && originY <= hi) ? vec2(0.0, 1e30) : vec2(1.0, 0.0);
+    }
+    float t0 = (lo - originY) / dirY;
+    float t1 = (hi - originY) / dirY;
+    return vec2(min(t0, t1), max(t0, t1));
+}
+
+// Quadtree traversal of the island grid min/max pyramid, as in Hi-Z / quadtree
+// displacement mapping: a node the ray passes entirely above or below is
+// stepped over and the next one is tried a level coarser, otherwise the walk
+// descends. Level 0 columns the ray does cross are marched, clipped to their
+// y-range. Past the grid edge the rest of the ray is marched normally.
+bool traceIslandGrid(vec3 rayOrigin, vec3 rayDir, float tStart, float tEnd, inout int steps, out vec4 color) {
+    float worldY = rayOrigin.y + float(uChunkOrigin.y) * 16.0;
+    // Axis-parallel rays never cross that axis' cell walls
+    vec2 safeDir = mix(rayDir.xz, vec2(1e-6), lessThan(abs(rayDir.xz), vec2(1e-6)));
+    int topLevel = uIslandGridLevels - 1;
+    int level = min(3, topLevel);
+    float t = tStart;
+    
+    for (int i = 0; i < uIslandGridSize * 2 && t < tEnd && steps < uMaxSteps; i++) {
+        vec3 pos = rayOrigin + rayDir * t;
+        ivec2 cell = ivec2(floor(pos.xz / 16.0)) + uChunkOrigin.xz - uIslandGridOrigin;
+        if (any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, ivec2(uIslandGridSize)))) {
+            return marchSegment(rayOrigin, rayDir, t, tEnd, steps, color);
         }
         
-        // Adaptive step size
-        // Larger steps when far from surfaces (large negative density)
-        // Smaller steps when close to surfaces
-        float adaptiveFactor = 1.0 + clamp(-density * 0.1, 0.0, 5.0);
+        // Exit of the ray from this node's column (camera-local coordinates)
+        ivec2 node = cell >> level;
+        float nodeSize = float(16 << level);
+        vec2 nodeMin = vec2((node << level) + uIslandGridOrigin - uChunkOrigin.xz) * 16.0;
+        vec2 exitPlane = nodeMin + step(vec2(0.0), rayDir.xz) * nodeSize;
+        vec2 exitT = (exitPlane - pos.xz) / safeDir;
+        float nodeExit = t + min(exitT.x, exitT.y);
         
-        // Also scale with distance from camera for LOD
-        float distanceFactor = 1.0 + t * 0.001;
+        vec2 bounds = texelFetch(uIslandGrid, node, level).rg;
+        vec2 slab = slabInterval(worldY, rayDir.y, bounds.x, bounds.y);
+        float segmentStart = max(t, slab.x);
+        float segmentEnd = min(min(nodeExit, slab.y), tEnd);
         
-        t += baseStep * adaptiveFactor * distanceFactor;
+        if (segmentStart >= segmentEnd) {
+            // Ray misses this node's height range
+            t = nodeExit + 1e-3;
+            level = min(level + 1, topLevel);
+            continue;
+        }
+        if (level > 0) {
+            // Nothing in this node before the ray enters its height range
+            t = segmentStart;
+            level--;
+            continue;
+        }
+        if (marchSegment(rayOrigin, rayDir, segmentStart, segmentEnd, steps, color)) {
+            return true;
+        }
+        t = nodeExit + 1e-3;
+        level = min(level + 1, topLevel);
+    }
+    
+    // Out of node steps (long maxDistance): march whatever is left
+    if (t < tEnd && steps < uMaxSteps) {
+        return marchSegment(rayOrigin, rayDir, t, tEnd, steps, color);
+    }
+    return false;
+}
+
+// Sphere traces the SDF clipmap with one fetch per step. Within a voxel of a
+// surface the density march resolves the hit over a short window, so hits
+// and shading match the other paths. Past the outermost level the rest of
+// the ray goes through the island grid or the plain march.
+bool traceSdf(vec3 rayOrigin, vec3 rayDir, float tStart, float tEnd, inout int steps, out vec4 color) {
+    float t = tStart;
+    
+    for (; steps < uMaxSteps && t < tEnd; steps++) {
+        COST_COUNT(costSteps);
+        vec3 worldPos = rayOrigin + rayDir * t + vec3(uChunkOrigin) * 16.0;
+        int level = sdfLevel(worldPos);
+        if (level < 0) {
+            return uUseIslandGrid != 0 ? traceIslandGrid(rayOrigin, rayDir, t, tEnd, steps, color)
+                                       : marchSegment(rayOrigin, rayDir, t, tEnd, steps, color);
+        }
         
-        if (t > maxDist) break;
+        float voxel = sdfVoxelSize(level);
+        float bound = sampleSdf(level, worldPos);
+        if (bound < voxel) {
+            float windowEnd = min(t + voxel * 4.0, tEnd);
+            if (marchSegment(rayOrigin, rayDir, t, windowEnd, steps, color)) {
+                return true;
+            }
+            t = windowEnd;
+        } else {
+            t += bound;
+        }
+    }
+    
+    return false;
+}
+
+// Trilinear density from a brick's atlas slot, local in blocks (0..16)
+float brickDensity(uint slot, vec3 local) {
+    uint slotsX = uint(uBrickAtlasSlots.x);
+    uint slotsXY = slotsX * uint(uBrickAtlasSlots.y);
+    vec3 slotCoord = vec3(uvec3(slot % slotsX, (slot % slotsXY) / slotsX, slot / slotsXY));
+    vec3 texel = slotCoord * 9.0 + clamp(local, 0.0, 16.0) * 0.5 + 0.5;
+    return textureLod(uBrickAtlas, texel / vec3(uBrickAtlasSlots * 9), 0.0).r;
+}
+
+// 3D DDA over the brickmap: empty bricks are stepped over, mixed bricks are
+// marched on their baked samples with only the hit refinement and normal
+// evaluating the density, and full bricks are a hit on entry. Bricks not
+// streamed yet are marched procedurally; past the window the rest of the ray
+// goes through the island grid or the plain march.
+bool traceBricks(vec3 rayOrigin, vec3 rayDir, float tStart, float tEnd, inout int steps, out vec4 color) {
+    vec3 safeDir = mix(rayDir, vec3(1e-6), lessThan(abs(rayDir), vec3(1e-6)));
+    float t = tStart;
+    float lastEmpty = tStart;  // Last ray parameter known to be outside terrain
+
+    for (int i = 0; i < uBrickGridSize * 4 && t < tEnd && steps < uMaxSteps; i++) {
+        vec3 pos = rayOrigin + rayDir * t;
+        ivec3 brick = ivec3(floor(pos / 16.0)) + uChunkOrigin;
+        ivec2 local = brick.xz - uBrickWindowMin;
+        if (any(lessThan(local, ivec2(0))) || any(greaterThanEqual(local, ivec2(uBrickGridSize)))) {
+            return uUseIslandGrid != 0 ? traceIslandGrid(rayOrigin, rayDir, t, tEnd, steps, color)
+                                       : marchSegment(rayOrigin, rayDir, t, tEnd, steps, color);
+        }
+
+        vec3 brickMin = vec3(brick - uChunkOrigin) * 16.0;
+        vec3 exitT = (brickMin + step(vec3(0.0), rayDir) * 16.0 - pos) / safeDir;
+        float brickExit = min(t + min(exitT.x, min(exitT.y, exitT.z)), tEnd);
+
+        uint cell = BRICK_EMPTY;
+        if (brick.y >= 0 && brick.y < BRICKS_PER_COLUMN) {
+            ivec3 texel = ivec3(brick.x & (uBrickGridSize - 1), brick.y, brick.z & (uBrickGridSize - 1));
+            cell = texelFetch(uBrickGrid, texel, 0).r;
+        }
+
+        if (cell == BRICK_UNKNOWN) {
+            if (marchSegment(rayOrigin, rayDir, t, brickExit, steps, color)) {
+                return true;
+            }
+        } else if (cell == BRICK_FULL) {
+            color = shadeHit(rayOrigin, rayDir, lastEmpty, t);
+            return true;
+        } else if (cell >= BRICK_FIRST_SLOT) {
+            uint slot = cell - BRICK_FIRST_SLOT;
+            for (; steps < uMaxSteps && t < brickExit; steps++) {
+                COST_COUNT(costSteps);
+                float density = brickDensity(slot, rayOrigin + rayDir * t - brickMin);
+                if (density > 0.0) {
+                    color = shadeHit(rayOrigin, rayDir, lastEmpty, t);
+                    steps++;
+                    return true;
+                }
+                lastEmpty = t;
+                t += max(-density / uLipschitz, 0.5) * uStepMultiplier;
+            }
+        }
+
+        lastEmpty = brickExit;
+        t = brickExit + 1e-3;
+    }
+
+    return false;
+}
+
+vec4 traceRay(vec3 rayOrigin, vec3 rayDir) {
+    // Clip to the y-range that can hold terrain
+    vec2 slab = slabInterval(rayOrigin.y + float(uChunkOrigin.y) * 16.0, rayDir.y, TERRAIN_MIN_Y, TERRAIN_MAX_Y);
+    float tStart = max(slab.x, 0.0);
+    float tEnd = min(slab.y, uMaxDistance);
+    
+    vec4 color;
+    int steps = 0;
+    if (tStart < tEnd) {
+        bool hit = uUseSdf != 0        ? traceSdf(rayOrigin, rayDir, tStart, tEnd, steps, color) :
+                   uUseBricks != 0     ? traceBricks(rayOrigin, rayDir, tStart, tEnd, steps, color) :
+                   uUseIslandGrid != 0 ? traceIslandGrid(rayOrigin, rayDir, tStart, tEnd, steps, color) :
+                                         marchSegment(rayOrigin, rayDir, tStart, tEnd, steps, color);
+        if (hit) {
+            return color;
+        }
     }
     
     // No hit - return sky color
     return vec4(uSkyColor, 1.0);
 }
 
+#ifdef RAY_COST
+// Blue -> cyan -> green -> yellow -> red
+vec3 heatmap(float x) {
+    x = clamp(x, 0.0, 1.0) * 4.0;
+    vec3 c0 = vec3(0.05, 0.05, 0.4);
+    vec3 c1 = vec3(0.0, 0.7, 0.9);
+    vec3 c2 = vec3(0.1, 0.85, 0.2);
+    vec3 c3 = vec3(0.95, 0.9, 0.1);
+    vec3 c4 = vec3(0.9, 0.1, 0.05);
+    if (x < 1.0) return mix(c0, c1, x);
+    if (x < 2.0) return mix(c1, c2, x - 1.0);
+    if (x < 3.0) return mix(c2, c3, x - 2.0);
+    return mix(c3, c4, x - 3.0);
+}
+
+void recordCost() {
+    if (uCostView != 0) {
+        // Density evaluations include the refine search and the 6 normal samples
+        float value = uCostView == 1 ? float(costSteps) / float(max(uMaxSteps, 1)) :
+                      uCostView == 2 ? float(costDensityEvals) / float(max(uMaxSteps + uRefineSteps + 6, 1)) :
+                                       float(costRefineSteps) / float(max(uRefineSteps, 1));
+        FragColor.rgb = mix(FragColor.rgb, heatmap(value), 0.8);
+    }
+
+#ifdef RAY_COST_ATOMICS
+    atomicAdd(costTotals[0], uint(costSteps));
+    atomicAdd(costTotals[1], uint(costDensityEvals));
+    atomicAdd(costTotals[2], uint(costRefineSteps));
+    atomicAdd(costTotals[3], uint(costHit));
+    int bin = min(costSteps * RAY_COST_BINS / max(uMaxSteps, 1), RAY_COST_BINS - 1);
+    atomicAdd(costHistogram[bin], 1u);
+#else
+    CostOutput = uvec4(costSteps, costDensityEvals, costRefineSteps, costHit);
+#endif
+}
+#endif
+
 // ============================================================================
 // MAIN
 // ============================================================================
@@ -372,7 +811,7 @@ void main() {
     vec3 rayOrigin = uCameraPos;
     
     // Ray march through the scene
-    FragColor = rayMarch(rayOrigin, rayDir);
+    FragColor = traceRay(rayOrigin, rayDir);
     
     // Optional: Add subtle star effect for deep void
     if (FragColor.rgb == uSkyColor) {
@@ -380,4 +819,8 @@ void main() {
         float star = step(0.998, simplex2D(starCoord));
         FragColor.rgb += vec3(star * 0.3);
     }
+
+#ifdef RAY_COST
+    recordCost();
+#endif
 }
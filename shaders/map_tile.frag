@@ -0,0 +1,30 @@
+#version 330 core
+
+// Colorizes a baked map tile (R = top surface height, G = island coverage)
+
+in vec2 texCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D uTile;
+uniform float uMaxY;              // Height that maps to R = 1.0
+uniform float uBlocksPerTexel;
+uniform vec3 uEndStoneColor;
+uniform vec3 uVoidColor;
+
+void main() {
+    vec2 tileData = texture(uTile, texCoord).rg;
+    float height = tileData.r * uMaxY;
+    float coverage = tileData.g;
+
+    // Hillshade from the neighbouring heights
+    float hx = textureOffset(uTile, texCoord, ivec2(1, 0)).r - textureOffset(uTile, texCoord, ivec2(-1, 0)).r;
+    float hz = textureOffset(uTile, texCoord, ivec2(0, 1)).r - textureOffset(uTile, texCoord, ivec2(0, -1)).r;
+    vec3 normal = normalize(vec3(-hx * uMaxY, 2.0 * uBlocksPerTexel, -hz * uMaxY));
+    float light = 0.35 + 0.65 * max(dot(normal, normalize(vec3(-0.4, 1.0, -0.6))), 0.0);
+
+    // Higher ground is brighter
+    vec3 color = uEndStoneColor * mix(0.55, 1.1, clamp(height / uMaxY, 0.0, 1.0)) * light;
+
+    FragColor = vec4(mix(uVoidColor, color, coverage), 1.0);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+
+// Top-down map tile quad
+// aPos is the tile corner in [0, 1], uTileRect places it in block coordinates
+
+layout(location = 0) in vec2 aPos;
+
+out vec2 texCoord;
+
+uniform mat4 projection2D;
+uniform mat4 view2D;
+uniform vec4 uTileRect;   // xy = tile origin (block x, z), z = size in blocks
+
+void main() {
+    vec2 block = uTileRect.xy + aPos * uTileRect.z;
+
+    // Map space is (x, -z) so that north (-z) points up on screen
+    gl_Position = projection2D * view2D * vec4(block.x, -block.y, 0.0, 1.0);
+    texCoord = aPos;
+}
@@ -0,0 +1,272 @@
+#include "../include/AllocTracker.h"
+#include "../include/Logger.h"
+#include "imGUI1/imgui.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+// Everything the hooks touch is constant-initialised, so allocations made
+// during static initialisation or thread teardown are safe to count
+static std::atomic<uint64_t> tagCounts[AllocTracker::MAX_TAGS];
+static std::atomic<uint64_t> tagBytes[AllocTracker::MAX_TAGS];
+static std::atomic<uint64_t> violationCount{0};
+static std::atomic<uint64_t> lastViolationSize{0};
+static std::atomic<const char*> lastViolationRegion{nullptr};
+static std::atomic<bool> assertOnViolation{false};
+
+static thread_local int currentTag = 0;
+static thread_local const char* noAllocRegion = nullptr;
+
+static std::mutex tagMutex;
+static const char* tagNames[AllocTracker::MAX_TAGS] = {"untagged"};
+static std::atomic<int> tagCount{1};
+
+// Main-thread frame bookkeeping (EndFrame / DrawWindow)
+static AllocTracker::TagStats frameStats[AllocTracker::MAX_TAGS];
+static uint64_t previousCounts[AllocTracker::MAX_TAGS];
+static uint64_t previousBytes[AllocTracker::MAX_TAGS];
+static uint64_t previousViolations = 0;
+static uint64_t frameAllocations = 0;
+static uint64_t frameBytes = 0;
+
+static void recordAllocation(std::size_t size) {
+    int tag = currentTag;
+    tagCounts[tag].fetch_add(1, std::memory_order_relaxed);
+    tagBytes[tag].fetch_add(size, std::memory_order_relaxed);
+
+    if (noAllocRegion != nullptr) {
+        violationCount.fetch_add(1, std::memory_order_relaxed);
+        lastViolationSize.store(size, std::memory_order_relaxed);
+        lastViolationRegion.store(noAllocRegion, std::memory_order_relaxed);
+        assert(!assertOnViolation.load(std::memory_order_relaxed) && "heap allocation inside NO_ALLOC_SCOPE");
+    }
+}
+
+int AllocTracker::RegisterTag(const char* name) {
+    std::lock_guard<std::mutex> lock(tagMutex);
+    int count = tagCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (std::strcmp(tagNames[i], name) == 0) {
+            return i;
+        }
+    }
+    if (count == MAX_TAGS) {
+        return 0;
+    }
+    tagNames[count] = name;
+    tagCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+AllocTracker::TagScope::TagScope(int tag) : previous(currentTag) {
+    currentTag = tag;
+}
+
+AllocTracker::TagScope::~TagScope() {
+    currentTag = previous;
+}
+
+AllocTracker::NoAllocScope::NoAllocScope(const char* region) : previous(noAllocRegion) {
+    noAllocRegion = region;
+}
+
+AllocTracker::NoAllocScope::~NoAllocScope() {
+    noAllocRegion = previous;
+}
+
+void AllocTracker::SetAssertOnViolation(bool enabled) {
+    assertOnViolation = enabled;
+}
+
+void AllocTracker::EndFrame() {
+    // Roughly one second of frames at 60 FPS
+    const double smoothing = 1.0 / 60.0;
+
+    int count = tagCount.load(std::memory_order_acquire);
+    frameAllocations = 0;
+    frameBytes = 0;
+    for (int i = 0; i < count; i++) {
+        uint64_t allocations = tagCounts[i].load(std::memory_order_relaxed);
+        uint64_t bytes = tagBytes[i].load(std::memory_order_relaxed);
+
+        TagStats& stats = frameStats[i];
+        stats.name = tagNames[i];
+        stats.count = allocations - previousCounts[i];
+        stats.bytes = bytes - previousBytes[i];
+        stats.averageCount += (static_cast<double>(stats.count) - stats.averageCount) * smoothing;
+        stats.averageBytes += (static_cast<double>(stats.bytes) - stats.averageBytes) * smoothing;
+        stats.peakCount = std::max(stats.peakCount, stats.count);
+
+        previousCounts[i] = allocations;
+        previousBytes[i] = bytes;
+        frameAllocations += stats.count;
+        frameBytes += stats.bytes;
+    }
+
+    uint64_t violations = violationCount.load(std::memory_order_relaxed);
+    if (violations != previousViolations) {
+        const char* region = lastViolationRegion.load(std::memory_order_relaxed);
+        LOG_WARNINGF("{} heap allocations inside no-alloc region '{}' (last {} bytes)",
+                     violations - previousViolations, region != nullptr ? region : "?",
+                     lastViolationSize.load(std::memory_order_relaxed));
+        previousViolations = violations;
+    }
+}
+
+int AllocTracker::GetTagCount() {
+    return tagCount.load(std::memory_order_acquire);
+}
+
+const AllocTracker::TagStats& AllocTracker::GetTagStats(int tag) {
+    return frameStats[tag];
+}
+
+uint64_t AllocTracker::GetFrameAllocations() {
+    return frameAllocations;
+}
+
+uint64_t AllocTracker::GetFrameBytes() {
+    return frameBytes;
+}
+
+uint64_t AllocTracker::GetTotalViolations() {
+    return violationCount.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::DrawWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(420, 280), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Allocations", open)) {
+        ImGui::End();
+        return;
+    }
+
+#if !ALLOC_TRACKING_ENABLED
+    ImGui::TextDisabled("Allocation tracking is compiled out (RENDERER_ALLOC_TRACKING=OFF)");
+#else
+    ImGui::Text("Last frame: %llu allocations, %llu bytes",
+                static_cast<unsigned long long>(frameAllocations), static_cast<unsigned long long>(frameBytes));
+    uint64_t violations = GetTotalViolations();
+    if (violations > 0) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "%llu allocations inside no-alloc regions",
+                           static_cast<unsigned long long>(violations));
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV;
+    if (ImGui::BeginTable("tags", 5, flags)) {
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Allocs");
+        ImGui::TableSetupColumn("Bytes");
+        ImGui::TableSetupColumn("Avg allocs");
+        ImGui::TableSetupColumn("Peak");
+        ImGui::TableHeadersRow();
+
+        int count = GetTagCount();
+        for (int i = 0; i < count; i++) {
+            const TagStats& stats = frameStats[i];
+            if (stats.name == nullptr) {
+                continue;
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(stats.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.count));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.bytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", stats.averageCount);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(stats.peakCount));
+        }
+        ImGui::EndTable();
+    }
+#endif
+
+    ImGui::End();
+}
+
+// ============================================================================
+// GLOBAL OPERATOR NEW / DELETE
+// ============================================================================
+
+#if ALLOC_TRACKING_ENABLED
+
+static void* allocate(std::size_t size) {
+    recordAllocation(size);
+    for (;;) {
+        void* pointer = std::malloc(size == 0 ? 1 : size);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+static void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    recordAllocation(size);
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    for (;;) {
+        void* pointer = nullptr;
+        if (posix_memalign(&pointer, align, size == 0 ? 1 : size) == 0) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+#endif
@@ -0,0 +1,207 @@
+#include "../include/BinaryLog.h"
+#include "../include/LogArgs.h"
+#include <algorithm>
+#include <zlib.h>
+
+static const char BINARY_LOG_MAGIC[4] = {'E', 'L', 'B', '1'};
+
+const char* const BinaryLog::PLAIN_FORMAT = "{}";
+
+static void writeVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static void writeString(std::string& out, const char* data, size_t size) {
+    writeVarint(out, size);
+    out.append(data, size);
+}
+
+static bool readBytes(gzFile in, void* data, size_t size) {
+    return size == 0 || gzread(in, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+}
+
+static bool readVarint(gzFile in, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = gzgetc(in);
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool readString(gzFile in, std::string& text) {
+    uint64_t size;
+    if (!readVarint(in, size) || size > (1u << 30)) {
+        return false;
+    }
+    text.resize(size);
+    return readBytes(in, &text[0], size);
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+bool BinaryLogWriter::Open(const std::string& path, int64_t wallClockOffsetNs, int64_t startNs) {
+    file.open(path, std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.write(BINARY_LOG_MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(&wallClockOffsetNs), sizeof(wallClockOffsetNs));
+    file.write(reinterpret_cast<const char*>(&startNs), sizeof(startNs));
+    lastTimeNs = startNs;
+    bytesWritten = 4 + sizeof(wallClockOffsetNs) + sizeof(startNs);
+    sites.clear();
+    return true;
+}
+
+void BinaryLogWriter::Write(uint8_t level, const char* sourceFile, int line, const char* format,
+                            const std::string& message, int64_t timeNs) {
+    const char* siteFormat = format != nullptr ? format : BinaryLog::PLAIN_FORMAT;
+    buffer.clear();
+
+    SiteKey key{sourceFile, siteFormat, line, level};
+    auto it = sites.find(key);
+    if (it == sites.end()) {
+        uint32_t id = static_cast<uint32_t>(sites.size());
+        it = sites.emplace(key, id).first;
+
+        std::string fileName;
+        if (sourceFile != nullptr) {
+            fileName = fileDisplayName ? fileDisplayName(sourceFile) : sourceFile;
+        }
+        buffer.push_back(static_cast<char>(BinaryLog::SITE));
+        writeVarint(buffer, id);
+        buffer.push_back(static_cast<char>(level));
+        writeVarint(buffer, static_cast<uint64_t>(line));
+        writeString(buffer, fileName.data(), fileName.size());
+        writeString(buffer, siteFormat, std::char_traits<char>::length(siteFormat));
+    }
+
+    // Plain messages become a single string argument of "{}"
+    const std::string* args = &message;
+    if (format == nullptr) {
+        packed.clear();
+        LogArgs::PackString(packed, message);
+        args = &packed;
+    }
+
+    // Records arrive in queue order, which can be slightly out of time order
+    // across producer threads; clamp so the delta stays unsigned
+    int64_t delta = timeNs > lastTimeNs ? timeNs - lastTimeNs : 0;
+    lastTimeNs += delta;
+
+    buffer.push_back(static_cast<char>(BinaryLog::MESSAGE));
+    writeVarint(buffer, it->second);
+    writeVarint(buffer, static_cast<uint64_t>(delta));
+    writeString(buffer, args->data(), args->size());
+
+    file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    bytesWritten += buffer.size();
+}
+
+void BinaryLogWriter::Flush() {
+    if (file.is_open()) {
+        file.flush();
+    }
+}
+
+void BinaryLogWriter::Close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+BinaryLogReader::~BinaryLogReader() {
+    if (file != nullptr) {
+        gzclose(static_cast<gzFile>(file));
+    }
+}
+
+bool BinaryLogReader::Open(const std::string& path) {
+    // gzread passes uncompressed files through unchanged
+    gzFile in = gzopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        return false;
+    }
+
+    char magic[4];
+    int64_t startNs = 0;
+    if (!readBytes(in, magic, 4) || !std::equal(magic, magic + 4, BINARY_LOG_MAGIC) ||
+        !readBytes(in, &wallClockOffsetNs, sizeof(wallClockOffsetNs)) ||
+        !readBytes(in, &startNs, sizeof(startNs))) {
+        gzclose(in);
+        return false;
+    }
+    if (file != nullptr) {
+        gzclose(static_cast<gzFile>(file));
+    }
+    file = in;
+    timeNs = startNs;
+    sites.clear();
+    return true;
+}
+
+bool BinaryLogReader::Next(Entry& entry) {
+    gzFile in = static_cast<gzFile>(file);
+    if (in == nullptr) {
+        return false;
+    }
+
+    for (;;) {
+        int tag = gzgetc(in);
+        if (tag == EOF) {
+            return false;
+        }
+
+        if (tag == BinaryLog::SITE) {
+            uint64_t id, line;
+            Site site;
+            int level = -1;
+            if (!readVarint(in, id) || (level = gzgetc(in)) == EOF || !readVarint(in, line) ||
+                !readString(in, site.file) || !readString(in, site.format) || id != sites.size()) {
+                return false;
+            }
+            site.level = static_cast<uint8_t>(level);
+            site.line = static_cast<int>(line);
+            sites.push_back(std::move(site));
+            continue;
+        }
+
+        if (tag != BinaryLog::MESSAGE) {
+            return false;
+        }
+
+        uint64_t id, delta;
+        if (!readVarint(in, id) || !readVarint(in, delta) || id >= sites.size() ||
+            !readString(in, entry.packedArgs)) {
+            return false;
+        }
+        timeNs += static_cast<int64_t>(delta);
+
+        const Site& site = sites[id];
+        entry.level = site.level;
+        entry.file = &site.file;
+        entry.line = site.line;
+        entry.format = &site.format;
+        entry.monotonicNs = timeNs;
+        entry.wallClockNs = timeNs + wallClockOffsetNs;
+        return true;
+    }
+}
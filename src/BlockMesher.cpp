@@ -0,0 +1,97 @@
+#include "../include/BlockMesher.h"
+#include <cstring>
+#include <utility>
+
+void BlockMesher::EmitQuad(Mesh& mesh, int axis, int side, int slice, int i, int j, int width, int height) {
+    // u, v are cyclic after the normal axis so u x v points along +axis
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    float corner[3];
+    corner[axis] = static_cast<float>(side == 0 ? slice + 1 : slice);
+    corner[u] = static_cast<float>(i);
+    corner[v] = static_cast<float>(j);
+
+    float du[3] = {0.0f, 0.0f, 0.0f};
+    float dv[3] = {0.0f, 0.0f, 0.0f};
+    du[u] = static_cast<float>(width);
+    dv[v] = static_cast<float>(height);
+    if (side == 1) {
+        // Negative faces wind the other way
+        std::swap(du[0], dv[0]);
+        std::swap(du[1], dv[1]);
+        std::swap(du[2], dv[2]);
+    }
+
+    GLuint base = static_cast<GLuint>(mesh.vertices.size() / FLOATS_PER_VERTEX);
+    const float weights[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+    float face = static_cast<float>(axis * 2 + side);
+    for (const auto& w : weights) {
+        for (int c = 0; c < 3; c++) {
+            mesh.vertices.push_back(corner[c] + du[c] * w[0] + dv[c] * w[1]);
+        }
+        mesh.vertices.push_back(face);
+    }
+    const GLuint order[6] = {0, 1, 2, 0, 2, 3};
+    for (GLuint index : order) {
+        mesh.indices.push_back(base + index);
+    }
+    mesh.quads++;
+}
+
+void BlockMesher::MeshSection(const uint8_t* blocks, bool greedy, Mesh& mesh) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.quads = 0;
+    mesh.faces = 0;
+
+    const int strides[3] = {1, PADDED * PADDED, PADDED};
+    const int origin = Index(0, 0, 0);
+    uint8_t mask[SIZE * SIZE];
+
+    for (int axis = 0; axis < 3; axis++) {
+        int strideU = strides[(axis + 1) % 3];
+        int strideV = strides[(axis + 2) % 3];
+        for (int side = 0; side < 2; side++) {
+            int neighbour = side == 0 ? strides[axis] : -strides[axis];
+            for (int slice = 0; slice < SIZE; slice++) {
+                // Faces of this slice's blocks whose neighbour along the normal is air
+                int sliceBase = origin + slice * strides[axis];
+                int faces = 0;
+                for (int j = 0; j < SIZE; j++) {
+                    for (int i = 0; i < SIZE; i++) {
+                        int index = sliceBase + i * strideU + j * strideV;
+                        uint8_t face = blocks[index] && !blocks[index + neighbour];
+                        mask[i + j * SIZE] = face;
+                        faces += face;
+                    }
+                }
+                if (faces == 0) continue;
+                mesh.faces += faces;
+
+                for (int j = 0; j < SIZE; j++) {
+                    for (int i = 0; i < SIZE;) {
+                        if (!mask[i + j * SIZE]) {
+                            i++;
+                            continue;
+                        }
+                        int width = 1;
+                        int height = 1;
+                        if (greedy) {
+                            // Widest run along u, then as many full rows of it along v
+                            while (i + width < SIZE && mask[i + width + j * SIZE]) width++;
+                            for (; j + height < SIZE; height++) {
+                                const uint8_t* row = mask + i + (j + height) * SIZE;
+                                if (std::memchr(row, 0, width) != nullptr) break;
+                            }
+                            for (int h = 0; h < height; h++) {
+                                std::memset(mask + i + (j + h) * SIZE, 0, width);
+                            }
+                        }
+                        EmitQuad(mesh, axis, side, slice, i, j, width, height);
+                        i += width;
+                    }
+                }
+            }
+        }
+    }
+}
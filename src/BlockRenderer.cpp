@@ -0,0 +1,497 @@
+#include "../include/BlockRenderer.h"
+#include "../include/AllocTracker.h"
+#include "../include/EndTerrain.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static const int PADDED_COLUMN_HEIGHT = BlockRenderer::SECTIONS_PER_COLUMN * BlockMesher::SIZE + 2;
+
+// Columns written into the voxel volume per frame
+static const int VOLUME_WRITES_PER_FRAME = 32;
+
+// Clip-space full-screen quad for the voxel trace, two triangles
+static GLfloat screenVertices[] = {
+    -1.0f, -1.0f,   1.0f, -1.0f,   1.0f,  1.0f,
+    -1.0f, -1.0f,   1.0f,  1.0f,  -1.0f,  1.0f
+};
+
+BlockRenderer::SectionMesh::SectionMesh(int y, BlockMesher::Mesh& mesh) :
+    y(y),
+    vbo(mesh.vertices.data(), static_cast<GLsizeiptr>(mesh.vertices.size() * sizeof(GLfloat))),
+    ebo(mesh.indices.data(), static_cast<GLsizeiptr>(mesh.indices.size() * sizeof(GLuint))),
+    indexCount(static_cast<GLsizei>(mesh.indices.size())) {
+    // The element buffer binding is VAO state, attach it while the VAO is bound
+    GLuint stride = BlockMesher::FLOATS_PER_VERTEX * sizeof(GLfloat);
+    vao.Bind();
+    vao.LinkAttrib(vbo, 0, 3, GL_FLOAT, stride, (void*)0);
+    vao.LinkAttrib(vbo, 1, 1, GL_FLOAT, stride, (void*)(3 * sizeof(GLfloat)));
+    ebo.Bind();
+    vao.Unbind();
+    ebo.Unbind();
+}
+
+void BlockRenderer::SectionMesh::Delete() {
+    vao.Delete();
+    vbo.Delete();
+    ebo.Delete();
+}
+
+BlockRenderer::BlockRenderer(int workerThreads) :
+    shader("shaders/block.vert", "shaders/block.frag"),
+    traceShader("shaders/end_raymarch.vert", "shaders/block_dda.frag"),
+    screenVbo(screenVertices, sizeof(screenVertices)),
+    workers(workerThreads, "block mesher"),
+    wantedCursor(0),
+    cameraChunk(INT32_MIN),
+    streamedRadius(-1),
+    streamedOctaves(-1),
+    streamedGreedy(true),
+    generation(0),
+    volumeSlots(VoxelVolume::WINDOW * VoxelVolume::WINDOW, VolumeSlot{0, false}),
+    volumeWindowMin(0),
+    volumeDirty(true),
+    residentColumns(0),
+    inFlightCount(0),
+    drawnSections(0),
+    quadCount(0),
+    faceCount(0),
+    voxelBytes(0),
+    meshNs(0),
+    meshedColumns(0) {
+    maxInFlight = workers.GetThreadCount() * 2;
+    screenVao.Bind();
+    screenVao.LinkAttrib(screenVbo, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0);
+    screenVao.Unbind();
+}
+
+BlockRenderer::~BlockRenderer() {
+    // Jobs reference the column map, which is destroyed before the pool
+    workers.Shutdown();
+}
+
+uint64_t BlockRenderer::MakeKey(int chunkX, int chunkZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkZ);
+}
+
+void BlockRenderer::ReleaseColumn(Column& column) {
+    if (column.state != ColumnState::RESIDENT) {
+        return;
+    }
+    for (SectionMesh& section : column.sections) {
+        section.Delete();
+    }
+    column.sections.clear();
+    for (const ChunkSection& voxels : column.voxels) {
+        voxelBytes -= voxels.GetMemoryBytes();
+    }
+    column.voxels.clear();
+    quadCount -= column.quads;
+    faceCount -= column.faces;
+    residentColumns--;
+    volumeDirty = true;
+}
+
+void BlockRenderer::UploadColumn(Column& column) {
+    PROFILE_ZONE("block upload");
+    // Building an EBO binds GL_ELEMENT_ARRAY_BUFFER, which would land in whatever VAO is bound
+    glBindVertexArray(0);
+    column.quads = 0;
+    column.faces = 0;
+    for (auto& entry : column.pending) {
+        column.sections.emplace_back(entry.first, entry.second);
+        column.quads += entry.second.quads;
+        column.faces += entry.second.faces;
+    }
+    column.pending.clear();
+    column.pending.shrink_to_fit();
+    for (const ChunkSection& voxels : column.voxels) {
+        voxelBytes += voxels.GetMemoryBytes();
+    }
+    column.state = ColumnState::RESIDENT;
+    quadCount += column.quads;
+    faceCount += column.faces;
+    residentColumns++;
+    volumeDirty = true;
+}
+
+void BlockRenderer::Recenter(const glm::ivec2& chunk) {
+    PROFILE_ZONE("block recenter");
+    cameraChunk = chunk;
+    streamedRadius = viewRadius;
+    volumeDirty = true;
+
+    // One chunk of hysteresis so columns on the edge do not flicker in and out
+    int keep = (viewRadius + 1) * (viewRadius + 1);
+    for (auto it = columns.begin(); it != columns.end();) {
+        Column& column = it->second;
+        int dx = column.x - chunk.x;
+        int dz = column.z - chunk.y;
+        bool inRange = dx * dx + dz * dz <= keep;
+        column.cancelled = !inRange;
+        if (inRange || column.state == ColumnState::BAKING) {
+            ++it;
+            continue;
+        }
+        ReleaseColumn(column);
+        it = columns.erase(it);
+    }
+
+    wanted.clear();
+    for (int dz = -viewRadius; dz <= viewRadius; dz++) {
+        for (int dx = -viewRadius; dx <= viewRadius; dx++) {
+            int distance = dx * dx + dz * dz;
+            if (distance > viewRadius * viewRadius) continue;
+            uint64_t key = MakeKey(chunk.x + dx, chunk.y + dz);
+            if (columns.count(key) == 0) {
+                wanted.emplace_back(distance, key);
+            }
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+    wantedCursor = 0;
+}
+
+void BlockRenderer::Update(const glm::vec3& cameraPos) {
+    PROFILE_ZONE("block update");
+    ALLOC_SCOPE("block meshes");
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (octaves != streamedOctaves || greedy != streamedGreedy) {
+        // Meshes from the old settings are dropped when their jobs finish
+        streamedOctaves = octaves;
+        streamedGreedy = greedy;
+        generation++;
+        for (auto& entry : columns) {
+            ReleaseColumn(entry.second);
+        }
+        columns.clear();
+        cameraChunk = glm::ivec2(INT32_MIN);
+    }
+
+    glm::ivec2 chunk(static_cast<int>(std::floor(cameraPos.x / 16.0f)),
+                     static_cast<int>(std::floor(cameraPos.z / 16.0f)));
+    if (chunk != cameraChunk || viewRadius != streamedRadius) {
+        Recenter(chunk);
+    }
+
+    int uploads = 0;
+    for (auto& entry : columns) {
+        if (uploads >= maxUploadsPerFrame) break;
+        if (entry.second.state != ColumnState::READY) continue;
+        UploadColumn(entry.second);
+        uploads++;
+    }
+    if (voxelTrace) {
+        SyncVolume();
+    }
+
+    // Mesh the nearest missing columns first
+    for (; wantedCursor < wanted.size() && inFlightCount < maxInFlight; wantedCursor++) {
+        uint64_t key = wanted[wantedCursor].second;
+        if (columns.count(key) != 0) continue;
+        Column column;
+        column.x = static_cast<int32_t>(key >> 32);
+        column.z = static_cast<int32_t>(key & 0xFFFFFFFFull);
+        column.generation = generation;
+        column.state = ColumnState::BAKING;
+        column.cancelled = false;
+        column.quads = 0;
+        column.faces = 0;
+        columns.emplace(key, std::move(column));
+        inFlightCount++;
+        int jobGeneration = generation;
+        workers.Submit([this, key, jobGeneration] { ProcessColumn(key, jobGeneration); });
+    }
+}
+
+void BlockRenderer::Render(const Camera& camera, int width, int height) {
+    PROFILE_ZONE("block render");
+    Update(camera.Position);
+
+    // Steady-state drawing must not touch the heap (the update above may)
+    NO_ALLOC_SCOPE("block render");
+    if (voxelTrace) {
+        GpuProfiler::Scope scope(profiler, "voxel trace");
+        Trace(camera, width, height);
+        return;
+    }
+    GpuProfiler::Scope scope(profiler, "blocks");
+    Draw(camera, width, height);
+}
+
+void BlockRenderer::SyncVolume() {
+    if (!volumeDirty) {
+        return;
+    }
+    PROFILE_ZONE("voxel volume sync");
+    volume.Create();
+
+    // The window is centred on the camera, each slot holds the column mapping
+    // to it there or nothing
+    const int W = VoxelVolume::WINDOW;
+    volumeWindowMin = cameraChunk - glm::ivec2(W / 2);
+    volumeDirty = false;
+    int writes = 0;
+    for (int dz = 0; dz < W; dz++) {
+        for (int dx = 0; dx < W; dx++) {
+            int chunkX = volumeWindowMin.x + dx;
+            int chunkZ = volumeWindowMin.y + dz;
+            uint64_t key = MakeKey(chunkX, chunkZ);
+            auto it = columns.find(key);
+            bool resident = it != columns.end() && it->second.state == ColumnState::RESIDENT;
+            VolumeSlot& slot = volumeSlots[(chunkZ & (W - 1)) * W + (chunkX & (W - 1))];
+            if (resident ? slot.filled && slot.key == key : !slot.filled) {
+                continue;
+            }
+            if (writes >= VOLUME_WRITES_PER_FRAME) {
+                volumeDirty = true;
+                continue;
+            }
+            if (resident) {
+                volume.WriteColumn(chunkX, chunkZ, it->second.voxels);
+            } else {
+                volume.ClearColumn(chunkX, chunkZ);
+            }
+            slot.key = key;
+            slot.filled = resident;
+            writes++;
+        }
+    }
+}
+
+void BlockRenderer::Draw(const Camera& camera, int width, int height) {
+    // Camera-chunk-relative coordinates for float precision, as in EndRenderer
+    glm::ivec3 chunkOrigin(
+        static_cast<int>(std::floor(camera.Position.x / 16.0f)),
+        static_cast<int>(std::floor(camera.Position.y / 16.0f)),
+        static_cast<int>(std::floor(camera.Position.z / 16.0f)));
+    Camera local = camera;
+    local.Position = camera.Position - glm::vec3(chunkOrigin) * 16.0f;
+    local.width = width;
+    local.height = height;
+    float farPlane = (viewRadius + 2) * 16.0f * 1.5f;
+    glm::mat4 viewProj = local.GetMatrix(fov, 0.1f, farPlane);
+
+    // Frustum planes from the combined matrix (Gribb & Hartmann), normalised
+    glm::vec4 planes[6];
+    glm::mat4 rows = glm::transpose(viewProj);
+    for (int i = 0; i < 3; i++) {
+        planes[i * 2] = rows[3] + rows[i];
+        planes[i * 2 + 1] = rows[3] - rows[i];
+    }
+    for (glm::vec4& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    const float sectionRadius = BlockMesher::SIZE * 0.5f * 1.7320508f;
+
+    glClearColor(skyColor.x, skyColor.y, skyColor.z, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    shader.Activate();
+    GLuint program = shader.ID;
+    glUniformMatrix4fv(glGetUniformLocation(program, "uViewProj"), 1, GL_FALSE, glm::value_ptr(viewProj));
+    glUniform3fv(glGetUniformLocation(program, "uCameraPos"), 1, glm::value_ptr(local.Position));
+    glUniform3fv(glGetUniformLocation(program, "uEndStoneColor"), 1, glm::value_ptr(endStoneColor));
+    glUniform3fv(glGetUniformLocation(program, "uFogColor"), 1, glm::value_ptr(fogColor));
+    glUniform1f(glGetUniformLocation(program, "uFogDensity"), fogDensity);
+    GLint offsetLocation = glGetUniformLocation(program, "uSectionOffset");
+    GLint blockLocation = glGetUniformLocation(program, "uSectionBlock");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    drawnSections = 0;
+    for (auto& entry : columns) {
+        const Column& column = entry.second;
+        for (const SectionMesh& section : column.sections) {
+            glm::ivec3 block(column.x * 16, section.y * 16, column.z * 16);
+            glm::vec3 offset = glm::vec3(block - chunkOrigin * 16);
+            glm::vec3 center = offset + glm::vec3(BlockMesher::SIZE * 0.5f);
+            bool visible = true;
+            for (const glm::vec4& plane : planes) {
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -sectionRadius) {
+                    visible = false;
+                    break;
+                }
+            }
+            if (!visible) continue;
+
+            glUniform3fv(offsetLocation, 1, glm::value_ptr(offset));
+            glUniform3i(blockLocation, block.x, block.y, block.z);
+            glBindVertexArray(section.vao.ID);
+            glDrawElements(GL_TRIANGLES, section.indexCount, GL_UNSIGNED_INT, 0);
+            drawnSections++;
+        }
+    }
+    glBindVertexArray(0);
+
+    glDisable(GL_CULL_FACE);
+    if (!depthTest) {
+        glDisable(GL_DEPTH_TEST);
+    }
+}
+
+void BlockRenderer::Trace(const Camera& camera, int width, int height) {
+    glm::ivec3 chunkOrigin(
+        static_cast<int>(std::floor(camera.Position.x / 16.0f)),
+        static_cast<int>(std::floor(camera.Position.y / 16.0f)),
+        static_cast<int>(std::floor(camera.Position.z / 16.0f)));
+    Camera local = camera;
+    local.Position = camera.Position - glm::vec3(chunkOrigin) * 16.0f;
+    local.width = width;
+    local.height = height;
+    float maxDistance = (viewRadius + 2) * 16.0f * 1.5f;
+    glm::mat4 invViewProj = glm::inverse(local.GetMatrix(fov, 0.1f, maxDistance));
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    traceShader.Activate();
+    GLuint program = traceShader.ID;
+    glUniformMatrix4fv(glGetUniformLocation(program, "uInvViewProj"), 1, GL_FALSE, glm::value_ptr(invViewProj));
+    glUniform3fv(glGetUniformLocation(program, "uCameraPos"), 1, glm::value_ptr(local.Position));
+    glUniform3i(glGetUniformLocation(program, "uChunkOrigin"), chunkOrigin.x, chunkOrigin.y, chunkOrigin.z);
+    glUniform1f(glGetUniformLocation(program, "uMaxDistance"), maxDistance);
+    glUniform1i(glGetUniformLocation(program, "uMaxSteps"), maxTraceSteps);
+    glUniform1i(glGetUniformLocation(program, "uVoxelBlocks"), 0);
+    glUniform1i(glGetUniformLocation(program, "uVoxelCells"), 1);
+    glUniform1i(glGetUniformLocation(program, "uVoxelSections"), 2);
+    glUniform2i(glGetUniformLocation(program, "uVolumeWindowMin"), volumeWindowMin.x, volumeWindowMin.y);
+    glUniform1i(glGetUniformLocation(program, "uVolumeSize"), VoxelVolume::WINDOW);
+    glUniform3fv(glGetUniformLocation(program, "uEndStoneColor"), 1, glm::value_ptr(endStoneColor));
+    glUniform3fv(glGetUniformLocation(program, "uSkyColor"), 1, glm::value_ptr(skyColor));
+    glUniform3fv(glGetUniformLocation(program, "uFogColor"), 1, glm::value_ptr(fogColor));
+    glUniform1f(glGetUniformLocation(program, "uFogDensity"), fogDensity);
+    volume.Bind(0);
+
+    screenVao.Bind();
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    screenVao.Unbind();
+
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+}
+
+void BlockRenderer::Delete() {
+    workers.Shutdown();
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : columns) {
+        ReleaseColumn(entry.second);
+    }
+    columns.clear();
+    wanted.clear();
+    inFlightCount = 0;
+    shader.Delete();
+    traceShader.Delete();
+    screenVao.Delete();
+    screenVbo.Delete();
+    volume.Delete();
+}
+
+// ============================================================================
+// WORKER SIDE
+// ============================================================================
+
+void BlockRenderer::ProcessColumn(uint64_t key, int jobGeneration) {
+    PROFILE_ZONE("block column job");
+    ALLOC_SCOPE("block meshes");
+    int chunkX, chunkZ, jobOctaves;
+    bool jobGreedy;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = columns.find(key);
+        if (it == columns.end() || it->second.cancelled || it->second.generation != jobGeneration) {
+            if (it != columns.end() && it->second.generation == jobGeneration) {
+                columns.erase(it);
+            }
+            inFlightCount--;
+            return;
+        }
+        chunkX = it->second.x;
+        chunkZ = it->second.z;
+        jobOctaves = streamedOctaves;
+        jobGreedy = streamedGreedy;
+    }
+
+    std::vector<ChunkSection> voxels;
+    std::vector<std::pair<int, BlockMesher::Mesh>> meshes;
+    MeshColumn(chunkX, chunkZ, jobOctaves, jobGreedy, voxels, meshes);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    inFlightCount--;
+    auto it = columns.find(key);
+    if (it == columns.end() || it->second.generation != jobGeneration || it->second.state != ColumnState::BAKING) {
+        return;
+    }
+    if (it->second.cancelled) {
+        columns.erase(it);
+        return;
+    }
+    it->second.voxels = std::move(voxels);
+    it->second.pending = std::move(meshes);
+    it->second.state = ColumnState::READY;
+}
+
+void BlockRenderer::MeshColumn(int chunkX, int chunkZ, int octaves, bool greedy, std::vector<ChunkSection>& voxels,
+                               std::vector<std::pair<int, BlockMesher::Mesh>>& meshes) {
+    PROFILE_ZONE("mesh block column");
+    // Sections outside the column's height range are single-value air
+    voxels.assign(SECTIONS_PER_COLUMN, ChunkSection(ChunkSection::AIR));
+    EndTerrain terrain(octaves);
+    float minY, maxY;
+    if (!terrain.ChunkHeightRange(chunkX, chunkZ, minY, maxY)) {
+        return;
+    }
+    int columnBlocks = SECTIONS_PER_COLUMN * BlockMesher::SIZE;
+    int lowY = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+    int highY = std::min(columnBlocks, static_cast<int>(std::ceil(maxY)) + 1);
+    if (lowY >= highY) {
+        return;
+    }
+
+    // Block solid if the density at its centre is. The border comes from the
+    // neighbouring columns and is only needed at heights this column can be solid.
+    const int P = BlockMesher::PADDED;
+    std::vector<uint8_t> blocks(static_cast<size_t>(P) * P * PADDED_COLUMN_HEIGHT, 0);
+    float baseX = chunkX * 16.0f + 0.5f;
+    float baseZ = chunkZ * 16.0f + 0.5f;
+    for (int y = lowY; y < highY; y++) {
+        for (int z = -1; z <= BlockMesher::SIZE; z++) {
+            for (int x = -1; x <= BlockMesher::SIZE; x++) {
+                float density = terrain.Density(baseX + x, y + 0.5f, baseZ + z);
+                blocks[BlockMesher::Index(x, y, z)] = density > 0.0f ? 1 : 0;
+            }
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int sectionSlice = P * P * BlockMesher::SIZE;
+    BlockMesher::Mesh mesh;
+    ChunkSection::BlockId sectionBlocks[ChunkSection::VOLUME];
+    for (int section = lowY / BlockMesher::SIZE; section <= (highY - 1) / BlockMesher::SIZE; section++) {
+        const uint8_t* padded = blocks.data() + section * sectionSlice;
+        for (int y = 0; y < ChunkSection::SIZE; y++) {
+            for (int z = 0; z < ChunkSection::SIZE; z++) {
+                for (int x = 0; x < ChunkSection::SIZE; x++) {
+                    sectionBlocks[ChunkSection::Index(x, y, z)] =
+                        padded[BlockMesher::Index(x, y, z)] ? ChunkSection::END_STONE : ChunkSection::AIR;
+                }
+            }
+        }
+        voxels[section] = ChunkSection::FromBlocks(sectionBlocks);
+
+        BlockMesher::MeshSection(padded, greedy, mesh);
+        if (mesh.quads > 0) {
+            meshes.emplace_back(section, std::move(mesh));
+            mesh = BlockMesher::Mesh();
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    meshNs += elapsed.count();
+    meshedColumns++;
+}
@@ -0,0 +1,404 @@
+#include "../include/BrickMap.h"
+#include "../include/AllocTracker.h"
+#include "../include/EndTerrain.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+static const int BRICK_VOLUME = BrickMap::BRICK_SAMPLES * BrickMap::BRICK_SAMPLES * BrickMap::BRICK_SAMPLES;
+static const float BRICK_BLOCKS = 16.0f;
+static const float SAMPLE_SPACING = BRICK_BLOCKS / (BrickMap::BRICK_SAMPLES - 1);
+
+BrickMap::BrickMap(int workerThreads) :
+    budgetMB(64),
+    maxUploadsPerFrame(32),
+    workers(workerThreads, "brick worker"),
+    gridTexture(0),
+    atlasTexture(0),
+    atlasSlots(0),
+    wantedCursor(0),
+    cameraChunk(INT32_MIN),
+    windowMin(0),
+    viewStamp(0),
+    octaves(-1),
+    lipschitz(0.0f),
+    generation(0),
+    residentColumns(0),
+    inFlightCount(0),
+    evictedCount(0),
+    emptyBricks(0),
+    fullBricks(0),
+    dataBricks(0) {
+    maxInFlight = workers.GetThreadCount() * 2;
+}
+
+BrickMap::~BrickMap() {
+    Shutdown();
+}
+
+uint64_t BrickMap::MakeKey(int chunkX, int chunkZ) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkZ);
+}
+
+void BrickMap::CreateTextures() {
+    // Top grid starts out all CELL_UNKNOWN
+    std::vector<uint32_t> cells(static_cast<size_t>(GRID_SIZE) * BRICKS_PER_COLUMN * GRID_SIZE, CELL_UNKNOWN);
+    glGenTextures(1, &gridTexture);
+    glBindTexture(GL_TEXTURE_3D, gridTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R32UI, GRID_SIZE, BRICKS_PER_COLUMN, GRID_SIZE, 0,
+                 GL_RED_INTEGER, GL_UNSIGNED_INT, cells.data());
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    // Atlas as close to a cube of slots as the budget and the 3D texture limit allow
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_3D_TEXTURE_SIZE, &maxSize);
+    double slots = static_cast<double>(budgetMB) * 1024.0 * 1024.0 / (BRICK_VOLUME * 2.0);
+    int perAxis = std::max(1, std::min(static_cast<int>(std::cbrt(slots)), maxSize / BRICK_SAMPLES));
+    atlasSlots = glm::ivec3(perAxis);
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_3D, atlasTexture);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, perAxis * BRICK_SAMPLES, perAxis * BRICK_SAMPLES, perAxis * BRICK_SAMPLES, 0,
+                 GL_RED, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    int capacity = GetCapacity();
+    freeSlots.clear();
+    for (int slot = capacity - 1; slot >= 0; slot--) {
+        freeSlots.push_back(static_cast<uint32_t>(slot));
+    }
+    LOG_INFOF("Brick atlas {} slots ({} MB)", capacity, capacity * BRICK_VOLUME * 2 / (1024 * 1024));
+}
+
+void BrickMap::WriteCells(const Column& column, const uint32_t* cells) {
+    glBindTexture(GL_TEXTURE_3D, gridTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage3D(GL_TEXTURE_3D, 0, column.x & (GRID_SIZE - 1), 0, column.z & (GRID_SIZE - 1), 1, BRICKS_PER_COLUMN, 1,
+                    GL_RED_INTEGER, GL_UNSIGNED_INT, cells);
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+void BrickMap::ReleaseColumn(Column& column) {
+    if (column.state != ColumnState::RESIDENT) {
+        return;
+    }
+    for (uint32_t cell : column.cells) {
+        if (cell >= CELL_FIRST_SLOT) {
+            freeSlots.push_back(cell - CELL_FIRST_SLOT);
+        }
+    }
+    if (column.inLru) {
+        lru.erase(column.lruEntry);
+        column.inLru = false;
+    }
+    static const uint32_t unknown[BRICKS_PER_COLUMN] = {};
+    WriteCells(column, unknown);
+    CountBricks(column, -1);
+    residentColumns--;
+}
+
+void BrickMap::CountBricks(const Column& column, int delta) {
+    for (uint32_t cell : column.cells) {
+        if (cell == CELL_EMPTY) {
+            emptyBricks += delta;
+        } else if (cell == CELL_FULL) {
+            fullBricks += delta;
+        } else if (cell >= CELL_FIRST_SLOT) {
+            dataBricks += delta;
+        }
+    }
+}
+
+bool BrickMap::AllocateSlot(uint32_t& slot) {
+    if (freeSlots.empty()) {
+        // Evict the least recently viewed column, never one in view right now
+        if (lru.empty()) {
+            return false;
+        }
+        auto it = columns.find(lru.back());
+        if (it->second.lastViewed == viewStamp) {
+            return false;
+        }
+        ReleaseColumn(it->second);
+        columns.erase(it);
+        evictedCount++;
+        if (freeSlots.empty()) {
+            return false;
+        }
+    }
+    slot = freeSlots.back();
+    freeSlots.pop_back();
+    return true;
+}
+
+void BrickMap::UploadColumn(uint64_t key, Column& column) {
+    PROFILE_ZONE("brick upload");
+    glBindTexture(GL_TEXTURE_3D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    const float* samples = column.samples.data();
+    bool holdsSlots = false;
+    for (uint32_t& cell : column.cells) {
+        if (cell != CELL_FIRST_SLOT) continue;
+
+        // Bricks that find no slot stay CELL_UNKNOWN and are marched procedurally
+        uint32_t slot;
+        if (!AllocateSlot(slot)) {
+            cell = CELL_UNKNOWN;
+        } else {
+            int sx = slot % atlasSlots.x;
+            int sy = (slot / atlasSlots.x) % atlasSlots.y;
+            int sz = slot / (atlasSlots.x * atlasSlots.y);
+            glBindTexture(GL_TEXTURE_3D, atlasTexture);
+            glTexSubImage3D(GL_TEXTURE_3D, 0, sx * BRICK_SAMPLES, sy * BRICK_SAMPLES, sz * BRICK_SAMPLES,
+                            BRICK_SAMPLES, BRICK_SAMPLES, BRICK_SAMPLES, GL_RED, GL_FLOAT, samples);
+            cell = CELL_FIRST_SLOT + slot;
+            holdsSlots = true;
+        }
+        samples += BRICK_VOLUME;
+    }
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    WriteCells(column, column.cells);
+    column.samples.clear();
+    column.samples.shrink_to_fit();
+    column.state = ColumnState::RESIDENT;
+    CountBricks(column, 1);
+    residentColumns++;
+    if (holdsSlots) {
+        lru.push_front(key);
+        column.lruEntry = lru.begin();
+        column.inLru = true;
+    }
+}
+
+void BrickMap::Recenter(const glm::ivec2& chunk, float viewDistance) {
+    PROFILE_ZONE("brick recenter");
+    cameraChunk = chunk;
+    windowMin = chunk - glm::ivec2(GRID_SIZE / 2);
+    viewStamp++;
+
+    // Columns outside the window would alias with the ones replacing them in the toroidal grid
+    for (auto it = columns.begin(); it != columns.end();) {
+        Column& column = it->second;
+        bool inside = column.x >= windowMin.x && column.x < windowMin.x + GRID_SIZE &&
+                      column.z >= windowMin.y && column.z < windowMin.y + GRID_SIZE;
+        if (inside) {
+            ++it;
+            continue;
+        }
+        if (column.state == ColumnState::BAKING) {
+            column.cancelled = true;
+            ++it;
+            continue;
+        }
+        ReleaseColumn(column);
+        it = columns.erase(it);
+    }
+
+    int radius = std::min(static_cast<int>(std::ceil(viewDistance / BRICK_BLOCKS)) + 1, GRID_SIZE / 2 - 1);
+    wanted.clear();
+    for (int dz = -radius; dz <= radius; dz++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            float distance = static_cast<float>(dx * dx + dz * dz);
+            if (distance > static_cast<float>(radius * radius)) continue;
+            uint64_t key = MakeKey(chunk.x + dx, chunk.y + dz);
+            auto it = columns.find(key);
+            if (it == columns.end()) {
+                wanted.emplace_back(distance, key);
+                continue;
+            }
+            // In view: most recently used
+            Column& column = it->second;
+            column.lastViewed = viewStamp;
+            column.cancelled = false;
+            if (column.inLru) {
+                lru.splice(lru.begin(), lru, column.lruEntry);
+            }
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+    wantedCursor = 0;
+}
+
+void BrickMap::Update(const glm::vec3& cameraPos, float viewDistance, int octaves, float lipschitz) {
+    PROFILE_ZONE("brick map update");
+    ALLOC_SCOPE("brick map");
+    std::lock_guard<std::mutex> lock(mutex);
+    if (gridTexture == 0) {
+        CreateTextures();
+    }
+
+    glm::ivec2 chunk(static_cast<int>(std::floor(cameraPos.x / BRICK_BLOCKS)),
+                     static_cast<int>(std::floor(cameraPos.z / BRICK_BLOCKS)));
+    lipschitz = std::max(lipschitz, 0.01f);
+    if (octaves != this->octaves || lipschitz != this->lipschitz) {
+        // Bakes for the old settings are dropped when they finish
+        this->octaves = octaves;
+        this->lipschitz = lipschitz;
+        generation++;
+        for (auto& entry : columns) {
+            ReleaseColumn(entry.second);
+        }
+        columns.clear();
+        cameraChunk = glm::ivec2(INT32_MIN);
+    }
+    if (chunk != cameraChunk) {
+        Recenter(chunk, viewDistance);
+    }
+
+    // Upload finished columns
+    int uploads = 0;
+    for (auto& entry : columns) {
+        if (uploads >= maxUploadsPerFrame) break;
+        if (entry.second.state != ColumnState::READY) continue;
+        UploadColumn(entry.first, entry.second);
+        uploads++;
+    }
+
+    // Dispatch bakes for the nearest missing columns
+    for (; wantedCursor < wanted.size() && inFlightCount < maxInFlight; wantedCursor++) {
+        uint64_t key = wanted[wantedCursor].second;
+        if (columns.count(key) != 0) continue;
+        Column column;
+        column.x = static_cast<int32_t>(key >> 32);
+        column.z = static_cast<int32_t>(key & 0xFFFFFFFFull);
+        column.generation = generation;
+        column.state = ColumnState::BAKING;
+        column.cancelled = false;
+        std::fill(column.cells, column.cells + BRICKS_PER_COLUMN, static_cast<uint32_t>(CELL_UNKNOWN));
+        column.lastViewed = viewStamp;
+        column.inLru = false;
+        columns.emplace(key, std::move(column));
+        inFlightCount++;
+        int jobGeneration = generation;
+        workers.Submit([this, key, jobGeneration] { ProcessColumn(key, jobGeneration); });
+    }
+}
+
+void BrickMap::Bind(GLuint gridUnit, GLuint atlasUnit) const {
+    glActiveTexture(GL_TEXTURE0 + gridUnit);
+    glBindTexture(GL_TEXTURE_3D, gridTexture);
+    glActiveTexture(GL_TEXTURE0 + atlasUnit);
+    glBindTexture(GL_TEXTURE_3D, atlasTexture);
+}
+
+void BrickMap::Shutdown() {
+    workers.Shutdown();
+    std::lock_guard<std::mutex> lock(mutex);
+    columns.clear();
+    lru.clear();
+    freeSlots.clear();
+    wanted.clear();
+    if (gridTexture != 0) {
+        glDeleteTextures(1, &gridTexture);
+        gridTexture = 0;
+    }
+    if (atlasTexture != 0) {
+        glDeleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+    }
+    residentColumns = 0;
+    inFlightCount = 0;
+    emptyBricks = 0;
+    fullBricks = 0;
+    dataBricks = 0;
+}
+
+// ============================================================================
+// WORKER SIDE
+// ============================================================================
+
+void BrickMap::ProcessColumn(uint64_t key, int jobGeneration) {
+    PROFILE_ZONE("brick column job");
+    ALLOC_SCOPE("brick map");
+    int chunkX, chunkZ, jobOctaves;
+    float jobLipschitz;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = columns.find(key);
+        if (it == columns.end() || it->second.cancelled || it->second.generation != jobGeneration) {
+            if (it != columns.end() && it->second.generation == jobGeneration) {
+                columns.erase(it);
+            }
+            inFlightCount--;
+            return;
+        }
+        chunkX = it->second.x;
+        chunkZ = it->second.z;
+        jobOctaves = octaves;
+        jobLipschitz = lipschitz;
+    }
+
+    uint32_t cells[BRICKS_PER_COLUMN];
+    std::vector<float> samples;
+    BakeColumn(chunkX, chunkZ, jobOctaves, jobLipschitz, cells, samples);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    inFlightCount--;
+    auto it = columns.find(key);
+    if (it == columns.end() || it->second.generation != jobGeneration || it->second.state != ColumnState::BAKING) {
+        return;
+    }
+    if (it->second.cancelled) {
+        columns.erase(it);
+        return;
+    }
+    std::copy(cells, cells + BRICKS_PER_COLUMN, it->second.cells);
+    it->second.samples = std::move(samples);
+    it->second.state = ColumnState::READY;
+}
+
+void BrickMap::BakeColumn(int chunkX, int chunkZ, int octaves, float lipschitz, uint32_t* cells,
+                          std::vector<float>& samples) {
+    PROFILE_ZONE("bake brick column");
+    EndTerrain terrain(octaves);
+    float minY, maxY;
+    bool solid = terrain.ChunkHeightRange(chunkX, chunkZ, minY, maxY);
+    // Every point of a cell is within half its diagonal of a corner sample, so
+    // a sample this far from zero keeps its sign over the cells around it
+    float margin = lipschitz * SAMPLE_SPACING * 0.8660254f;
+
+    float brick[BRICK_VOLUME];
+    for (int by = 0; by < BRICKS_PER_COLUMN; by++) {
+        float y0 = by * BRICK_BLOCKS;
+        if (!solid || y0 > maxY || y0 + BRICK_BLOCKS < minY) {
+            cells[by] = CELL_EMPTY;
+            continue;
+        }
+
+        // Samples sit on the brick's cell corners, so neighbouring bricks share faces
+        // and trilinear filtering never reads outside the brick
+        int provenEmpty = 0;
+        int provenFull = 0;
+        int index = 0;
+        for (int z = 0; z < BRICK_SAMPLES; z++) {
+            for (int y = 0; y < BRICK_SAMPLES; y++) {
+                for (int x = 0; x < BRICK_SAMPLES; x++, index++) {
+                    float density = terrain.Density(chunkX * BRICK_BLOCKS + x * SAMPLE_SPACING,
+                                                    y0 + y * SAMPLE_SPACING,
+                                                    chunkZ * BRICK_BLOCKS + z * SAMPLE_SPACING);
+                    brick[index] = density;
+                    provenEmpty += density < -margin ? 1 : 0;
+                    provenFull += density > margin ? 1 : 0;
+                }
+            }
+        }
+
+        if (provenEmpty == BRICK_VOLUME) {
+            cells[by] = CELL_EMPTY;
+        } else if (provenFull == BRICK_VOLUME) {
+            cells[by] = CELL_FULL;
+        } else {
+            // Slot assigned on upload
+            cells[by] = CELL_FIRST_SLOT;
+            samples.insert(samples.end(), brick, brick + BRICK_VOLUME);
+        }
+    }
+}
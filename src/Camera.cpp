@@ -11,7 +11,7 @@ Camera::Camera(int width, int height, glm::vec3 position){
     Position = position;
 }
 
-void Camera::Matrix(float FOVdeg, float nearPlane, float farPlane, Shader& shader, const char* uniform){
+glm::mat4 Camera::GetMatrix(float FOVdeg, float nearPlane, float farPlane) const {
     glm::mat4 view = glm::mat4(1.0f);
     glm::mat4 projection = glm::mat4(1.0f);
 
@@ -20,7 +20,12 @@ void Camera::Matrix(float FOVdeg, float nearPlane, float farPlane, Shader& shade
     // Fix: Cast to float before division to get correct aspect ratio
     projection = glm::perspective(glm::radians(FOVdeg), (float)width / (float)height, nearPlane, farPlane);
 
-    glUniformMatrix4fv(glGetUniformLocation(shader.ID, uniform), 1, GL_FALSE, glm::value_ptr(projection * view));
+    return projection * view;
+}
+
+void Camera::Matrix(float FOVdeg, float nearPlane, float farPlane, Shader& shader, const char* uniform){
+    glm::mat4 matrix = GetMatrix(FOVdeg, nearPlane, farPlane);
+    glUniformMatrix4fv(glGetUniformLocation(shader.ID, uniform), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 //Input controls
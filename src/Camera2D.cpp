@@ -25,7 +25,7 @@ void Camera2D::SetViewportSize(int w, int h) {
 }
 
 void Camera2D::SetZoom(float z) {
-    zoom = std::max(0.1f, z); // Prevent negative or zero zoom
+    zoom = std::max(0.0001f, z); // Prevent negative or zero zoom
     matricesDirty = true;
 }
 
@@ -76,17 +76,20 @@ void Camera2D::CalculateView() {
 }
 
 void Camera2D::SetMatrices(Shader& shader) {
+    // Orthographic projection covering the zoomed viewport
     glm::mat4 projection = glm::ortho(
-        -200.0f, 200.0f,  // left, right (X range)
-        -250.0f, 400.0f,  // bottom, top (Y range)
-        -1.0f, 1.0f       // near, far (Z range for 2D)
+        left / zoom, right / zoom,   // left, right (X range)
+        bottom / zoom, top / zoom,   // bottom, top (Y range)
+        -1.0f, 1.0f                  // near, far (Z range for 2D)
     );
 
-    glm::mat4 view = glm::mat4(1.0f); // Identity for 2D
+    // View: rotate around the camera position
+    glm::mat4 view = glm::rotate(glm::mat4(1.0f), -rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+    view = glm::translate(view, glm::vec3(-position, 0.0f));
 
     // Set uniforms
-    GLuint projLoc = glGetUniformLocation(shader.ID, "projection2D");
-    GLuint viewLoc = glGetUniformLocation(shader.ID, "view2D");
+    GLint projLoc = glGetUniformLocation(shader.ID, "projection2D");
+    GLint viewLoc = glGetUniformLocation(shader.ID, "view2D");
 
     if (projLoc != -1) {
         glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
@@ -94,8 +97,6 @@ void Camera2D::SetMatrices(Shader& shader) {
     if (viewLoc != -1) {
         glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
     }
-
-    std::cout << "DEBUG: 2D Camera projection set to cover X:(-200,200) Y:(-250,400)" << std::endl;
 }
 
 
@@ -108,7 +109,7 @@ glm::vec2 Camera2D::ScreenToWorld(const glm::vec2& screenPos) {
 
 glm::vec2 Camera2D::WorldToScreen(const glm::vec2& worldPos) {
     // Convert world coordinates to screen coordinates
-    float x = ((worldPos.x - position.x) * zoom - left / zoom) / (right - left) * width;
-    float y = height - ((worldPos.y - position.y) * zoom - bottom / zoom) / (top - bottom) * height;
+    float x = ((worldPos.x - position.x) * zoom - left) / (right - left) * width;
+    float y = height - ((worldPos.y - position.y) * zoom - bottom) / (top - bottom) * height;
     return glm::vec2(x, y);
 }
@@ -0,0 +1,179 @@
+#include "../include/CameraPath.h"
+#include "../include/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+static const char PATH_MAGIC[4] = {'E', 'C', 'P', '1'};
+
+struct PackedPose {
+    float position[3];
+    int16_t orientation[2];
+};
+static_assert(sizeof(PackedPose) == 16, "PackedPose must stay 16 bytes");
+
+static float signNotZero(float v) {
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+// Octahedral unit-vector encoding
+static void encodeDirection(const glm::vec3& dir, int16_t out[2]) {
+    glm::vec3 v = dir / (std::abs(dir.x) + std::abs(dir.y) + std::abs(dir.z));
+    float x = v.x;
+    float y = v.y;
+    if (v.z < 0.0f) {
+        x = (1.0f - std::abs(v.y)) * signNotZero(v.x);
+        y = (1.0f - std::abs(v.x)) * signNotZero(v.y);
+    }
+    out[0] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+    out[1] = static_cast<int16_t>(std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+}
+
+static glm::vec3 decodeDirection(const int16_t in[2]) {
+    float x = in[0] / 32767.0f;
+    float y = in[1] / 32767.0f;
+    glm::vec3 v(x, y, 1.0f - std::abs(x) - std::abs(y));
+    if (v.z < 0.0f) {
+        v.x = (1.0f - std::abs(y)) * signNotZero(x);
+        v.y = (1.0f - std::abs(x)) * signNotZero(y);
+    }
+    return glm::normalize(v);
+}
+
+void CameraPath::Append(const Camera& camera) {
+    poses.push_back({camera.Position, glm::normalize(camera.Orientation)});
+}
+
+void CameraPath::Apply(size_t frame, Camera& camera) const {
+    if (poses.empty()) {
+        return;
+    }
+    const Pose& pose = poses[std::min(frame, poses.size() - 1)];
+    camera.Position = pose.position;
+    camera.Orientation = pose.orientation;
+}
+
+bool CameraPath::Save(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        LOG_ERROR("Failed to open camera path for writing: " + path);
+        return false;
+    }
+
+    uint32_t frameCount = static_cast<uint32_t>(poses.size());
+    std::fwrite(PATH_MAGIC, 1, 4, file);
+    std::fwrite(&frameCount, sizeof(frameCount), 1, file);
+    std::fwrite(&timestep, sizeof(timestep), 1, file);
+
+    std::vector<PackedPose> packed(poses.size());
+    for (size_t i = 0; i < poses.size(); i++) {
+        std::memcpy(packed[i].position, &poses[i].position.x, sizeof(packed[i].position));
+        encodeDirection(poses[i].orientation, packed[i].orientation);
+    }
+    std::fwrite(packed.data(), sizeof(PackedPose), packed.size(), file);
+    std::fclose(file);
+
+    LOG_INFO("Camera path saved: " + path + " (" + std::to_string(frameCount) + " frames)");
+    return true;
+}
+
+bool CameraPath::Load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        LOG_ERROR("Failed to open camera path: " + path);
+        return false;
+    }
+
+    char magic[4];
+    uint32_t frameCount = 0;
+    float fileTimestep = 0.0f;
+    bool ok = std::fread(magic, 1, 4, file) == 4 &&
+              std::memcmp(magic, PATH_MAGIC, 4) == 0 &&
+              std::fread(&frameCount, sizeof(frameCount), 1, file) == 1 &&
+              std::fread(&fileTimestep, sizeof(fileTimestep), 1, file) == 1;
+
+    // A corrupt frame count must not size the allocation, check it against the bytes left
+    long dataStart = ok ? std::ftell(file) : -1;
+    long fileEnd = -1;
+    if (dataStart >= 0 && std::fseek(file, 0, SEEK_END) == 0) {
+        fileEnd = std::ftell(file);
+        std::fseek(file, dataStart, SEEK_SET);
+    }
+    if (ok && (fileEnd < dataStart ||
+               frameCount > static_cast<uint64_t>(fileEnd - dataStart) / sizeof(PackedPose))) {
+        std::fclose(file);
+        LOG_ERROR("Camera path frame count " + std::to_string(frameCount) + " exceeds the file size: " + path);
+        return false;
+    }
+    // The timestep scales the replayed shader time
+    if (ok && (!std::isfinite(fileTimestep) || fileTimestep <= 0.0f)) {
+        std::fclose(file);
+        LOG_ERROR("Camera path timestep " + std::to_string(fileTimestep) + " is not a positive number: " + path);
+        return false;
+    }
+
+    std::vector<PackedPose> packed;
+    if (ok) {
+        packed.resize(frameCount);
+        ok = std::fread(packed.data(), sizeof(PackedPose), frameCount, file) == frameCount;
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        LOG_ERROR("Invalid camera path file: " + path);
+        return false;
+    }
+
+    timestep = fileTimestep;
+    poses.resize(frameCount);
+    for (size_t i = 0; i < packed.size(); i++) {
+        std::memcpy(&poses[i].position.x, packed[i].position, sizeof(packed[i].position));
+        poses[i].orientation = decodeDirection(packed[i].orientation);
+    }
+    return true;
+}
+
+CameraPath CameraPath::MainIslandOrbit(int frames) {
+    // One slow lap around the main island, looking at its center
+    CameraPath path;
+    const glm::vec3 target(0.0f, 70.0f, 0.0f);
+    const float radius = 380.0f;
+    const float height = 115.0f;
+    for (int i = 0; i < frames; i++) {
+        float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(frames);
+        glm::vec3 position(radius * std::cos(angle), height, radius * std::sin(angle));
+        path.poses.push_back({position, glm::normalize(target - position)});
+    }
+    return path;
+}
+
+CameraPath CameraPath::OuterVoidDash(int frames) {
+    // Fast straight run outwards over the outer islands, gently weaving
+    CameraPath path;
+    const glm::vec3 start(1200.0f, 95.0f, 300.0f);
+    const glm::vec3 end(9000.0f, 80.0f, 5200.0f);
+    const glm::vec3 forward = glm::normalize(end - start);
+    for (int i = 0; i < frames; i++) {
+        float t = static_cast<float>(i) / static_cast<float>(std::max(1, frames - 1));
+        glm::vec3 position = start + (end - start) * t;
+        float weave = 0.25f * std::sin(t * 18.0f);
+        glm::vec3 side = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+        glm::vec3 orientation = glm::normalize(forward + side * weave + glm::vec3(0.0f, -0.15f, 0.0f));
+        path.poses.push_back({position, orientation});
+    }
+    return path;
+}
+
+bool CameraPath::Resolve(const std::string& nameOrPath, CameraPath& path) {
+    if (nameOrPath == "orbit") {
+        path = MainIslandOrbit();
+        return true;
+    }
+    if (nameOrPath == "dash") {
+        path = OuterVoidDash();
+        return true;
+    }
+    return path.Load(nameOrPath);
+}
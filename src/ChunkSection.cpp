@@ -0,0 +1,125 @@
+#include "../include/ChunkSection.h"
+#include <algorithm>
+
+ChunkSection::ChunkSection(BlockId fill) :
+    bits(0),
+    entriesPerWord(0),
+    mask(0),
+    palette(1, fill) {
+}
+
+int ChunkSection::BitsFor(size_t paletteSize) {
+    int bits = 0;
+    while ((static_cast<size_t>(1) << bits) < paletteSize) {
+        bits++;
+    }
+    return bits;
+}
+
+void ChunkSection::Pack(const uint16_t* entries, int newBits) {
+    bits = newBits;
+    data.clear();
+    if (bits == 0) {
+        entriesPerWord = 0;
+        mask = 0;
+        data.shrink_to_fit();
+        return;
+    }
+    entriesPerWord = 64 / bits;
+    mask = (static_cast<uint64_t>(1) << bits) - 1;
+    data.assign((VOLUME + entriesPerWord - 1) / entriesPerWord, 0);
+    data.shrink_to_fit();
+    int index = 0;
+    for (uint64_t& word : data) {
+        for (int entry = 0; entry < entriesPerWord && index < VOLUME; entry++, index++) {
+            word |= static_cast<uint64_t>(entries[index]) << (entry * bits);
+        }
+    }
+}
+
+void ChunkSection::UnpackEntries(uint16_t* entries) const {
+    if (bits == 0) {
+        std::fill(entries, entries + VOLUME, 0);
+        return;
+    }
+    int index = 0;
+    for (uint64_t word : data) {
+        for (int entry = 0; entry < entriesPerWord && index < VOLUME; entry++, index++) {
+            entries[index] = static_cast<uint16_t>(word & mask);
+            word >>= bits;
+        }
+    }
+}
+
+ChunkSection ChunkSection::FromBlocks(const BlockId* blocks) {
+    ChunkSection section(blocks[0]);
+    uint16_t entries[VOLUME];
+    uint16_t last = 0;
+    for (int index = 0; index < VOLUME; index++) {
+        // Neighbouring blocks are mostly the same id
+        if (section.palette[last] != blocks[index]) {
+            auto it = std::find(section.palette.begin(), section.palette.end(), blocks[index]);
+            if (it == section.palette.end()) {
+                section.palette.push_back(blocks[index]);
+                it = section.palette.end() - 1;
+            }
+            last = static_cast<uint16_t>(it - section.palette.begin());
+        }
+        entries[index] = last;
+    }
+    section.palette.shrink_to_fit();
+    section.Pack(entries, BitsFor(section.palette.size()));
+    return section;
+}
+
+uint32_t ChunkSection::PaletteIndex(BlockId block) {
+    auto it = std::find(palette.begin(), palette.end(), block);
+    if (it != palette.end()) {
+        return static_cast<uint32_t>(it - palette.begin());
+    }
+    palette.push_back(block);
+    int needed = BitsFor(palette.size());
+    if (needed > bits) {
+        // Repack every entry at the wider size
+        uint16_t entries[VOLUME];
+        UnpackEntries(entries);
+        Pack(entries, needed);
+    }
+    return static_cast<uint32_t>(palette.size() - 1);
+}
+
+void ChunkSection::Set(int x, int y, int z, BlockId block) {
+    if (bits == 0 && palette[0] == block) {
+        return;
+    }
+    uint64_t entry = PaletteIndex(block);
+    int index = Index(x, y, z);
+    int word = index / entriesPerWord;
+    int shift = (index - word * entriesPerWord) * bits;
+    data[word] = (data[word] & ~(mask << shift)) | (entry << shift);
+}
+
+void ChunkSection::Unpack(BlockId* blocks) const {
+    ForEach([blocks](int index, BlockId block) { blocks[index] = block; });
+}
+
+void ChunkSection::Compact() {
+    if (bits == 0) {
+        return;
+    }
+    uint16_t entries[VOLUME];
+    UnpackEntries(entries);
+
+    std::vector<uint16_t> remap(palette.size(), UINT16_MAX);
+    std::vector<BlockId> used;
+    for (uint16_t& entry : entries) {
+        if (remap[entry] == UINT16_MAX) {
+            remap[entry] = static_cast<uint16_t>(used.size());
+            used.push_back(palette[entry]);
+        }
+        entry = remap[entry];
+    }
+    palette = std::move(used);
+    palette.shrink_to_fit();
+    Pack(entries, BitsFor(palette.size()));
+}
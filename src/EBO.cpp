@@ -1,9 +1,11 @@
 #include "../include/EBO.h"
+#include "../include/GLDebug.h"
 
 EBO::EBO(GLuint* indices, GLsizeiptr size){
     glGenBuffers(1, &ID);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, indices, GL_STATIC_DRAW);
+    GL_OBJECT_LABEL(GL_BUFFER, ID, "EBO " + std::to_string(ID) + " (" + std::to_string(size) + " bytes)");
 }
 
 void EBO::Bind(){
@@ -0,0 +1,146 @@
+#include "../include/EndNoise.h"
+#include <cmath>
+
+namespace EndNoise {
+
+// Skewing factors
+static const float F2 = 0.36602540378f;
+static const float G2 = 0.21132486540f;
+static const float F3 = 0.33333333333f;
+static const float G3 = 0.16666666667f;
+
+static inline float fract(float v) {
+    return v - std::floor(v);
+}
+
+// Hash function for gradient generation (matches hash3 in GLSL)
+static inline void hash3(float x, float y, float z, float out[3]) {
+    float px = x * 127.1f + y * 311.7f + z * 74.7f;
+    float py = x * 269.5f + y * 183.3f + z * 246.1f;
+    float pz = x * 113.5f + y * 271.9f + z * 124.6f;
+    out[0] = -1.0f + 2.0f * fract(std::sin(px) * 43758.5453f);
+    out[1] = -1.0f + 2.0f * fract(std::sin(py) * 43758.5453f);
+    out[2] = -1.0f + 2.0f * fract(std::sin(pz) * 43758.5453f);
+}
+
+static inline void hash2(float x, float y, float out[2]) {
+    float px = x * 127.1f + y * 311.7f;
+    float py = x * 269.5f + y * 183.3f;
+    out[0] = -1.0f + 2.0f * fract(std::sin(px) * 43758.5453f);
+    out[1] = -1.0f + 2.0f * fract(std::sin(py) * 43758.5453f);
+}
+
+float simplex3D(float x, float y, float z) {
+    // Skew
+    float s = (x + y + z) * F3;
+    float ix = std::floor(x + s);
+    float iy = std::floor(y + s);
+    float iz = std::floor(z + s);
+    float t = (ix + iy + iz) * G3;
+    float x0 = x - (ix - t);
+    float y0 = y - (iy - t);
+    float z0 = z - (iz - t);
+
+    // Simplex corners
+    float i1x, i1y, i1z, i2x, i2y, i2z;
+    if (x0 >= y0) {
+        if (y0 >= z0)      { i1x = 1; i1y = 0; i1z = 0; i2x = 1; i2y = 1; i2z = 0; }
+        else if (x0 >= z0) { i1x = 1; i1y = 0; i1z = 0; i2x = 1; i2y = 0; i2z = 1; }
+        else               { i1x = 0; i1y = 0; i1z = 1; i2x = 1; i2y = 0; i2z = 1; }
+    } else {
+        if (y0 < z0)       { i1x = 0; i1y = 0; i1z = 1; i2x = 0; i2y = 1; i2z = 1; }
+        else if (x0 < z0)  { i1x = 0; i1y = 1; i1z = 0; i2x = 0; i2y = 1; i2z = 1; }
+        else               { i1x = 0; i1y = 1; i1z = 0; i2x = 1; i2y = 1; i2z = 0; }
+    }
+
+    float x1 = x0 - i1x + G3, y1 = y0 - i1y + G3, z1 = z0 - i1z + G3;
+    float x2 = x0 - i2x + 2.0f * G3, y2 = y0 - i2y + 2.0f * G3, z2 = z0 - i2z + 2.0f * G3;
+    float x3 = x0 - 1.0f + 3.0f * G3, y3 = y0 - 1.0f + 3.0f * G3, z3 = z0 - 1.0f + 3.0f * G3;
+
+    // Contributions, skipping the gradient hash for corners with zero weight
+    float n = 0.0f;
+    float g[3];
+
+    float w0 = 0.6f - (x0 * x0 + y0 * y0 + z0 * z0);
+    if (w0 > 0.0f) {
+        hash3(ix, iy, iz, g);
+        w0 *= w0;
+        n += w0 * w0 * (g[0] * x0 + g[1] * y0 + g[2] * z0);
+    }
+    float w1 = 0.6f - (x1 * x1 + y1 * y1 + z1 * z1);
+    if (w1 > 0.0f) {
+        hash3(ix + i1x, iy + i1y, iz + i1z, g);
+        w1 *= w1;
+        n += w1 * w1 * (g[0] * x1 + g[1] * y1 + g[2] * z1);
+    }
+    float w2 = 0.6f - (x2 * x2 + y2 * y2 + z2 * z2);
+    if (w2 > 0.0f) {
+        hash3(ix + i2x, iy + i2y, iz + i2z, g);
+        w2 *= w2;
+        n += w2 * w2 * (g[0] * x2 + g[1] * y2 + g[2] * z2);
+    }
+    float w3 = 0.6f - (x3 * x3 + y3 * y3 + z3 * z3);
+    if (w3 > 0.0f) {
+        hash3(ix + 1.0f, iy + 1.0f, iz + 1.0f, g);
+        w3 *= w3;
+        n += w3 * w3 * (g[0] * x3 + g[1] * y3 + g[2] * z3);
+    }
+
+    return 32.0f * n;
+}
+
+float simplex2D(float x, float y) {
+    float s = (x + y) * F2;
+    float ix = std::floor(x + s);
+    float iy = std::floor(y + s);
+    float t = (ix + iy) * G2;
+    float x0 = x - (ix - t);
+    float y0 = y - (iy - t);
+
+    float i1x = (x0 > y0) ? 1.0f : 0.0f;
+    float i1y = (x0 > y0) ? 0.0f : 1.0f;
+    float x1 = x0 - i1x + G2, y1 = y0 - i1y + G2;
+    float x2 = x0 - 1.0f + 2.0f * G2, y2 = y0 - 1.0f + 2.0f * G2;
+
+    float n = 0.0f;
+    float g[2];
+
+    float w0 = 0.5f - (x0 * x0 + y0 * y0);
+    if (w0 > 0.0f) {
+        hash2(ix, iy, g);
+        w0 *= w0;
+        n += w0 * w0 * (g[0] * x0 + g[1] * y0);
+    }
+    float w1 = 0.5f - (x1 * x1 + y1 * y1);
+    if (w1 > 0.0f) {
+        hash2(ix + i1x, iy + i1y, g);
+        w1 *= w1;
+        n += w1 * w1 * (g[0] * x1 + g[1] * y1);
+    }
+    float w2 = 0.5f - (x2 * x2 + y2 * y2);
+    if (w2 > 0.0f) {
+        hash2(ix + 1.0f, iy + 1.0f, g);
+        w2 *= w2;
+        n += w2 * w2 * (g[0] * x2 + g[1] * y2);
+    }
+
+    return 70.0f * n;
+}
+
+float fbm3D(float x, float y, float z, int octaves) {
+    float value = 0.0f;
+    float amplitude = 1.0f;
+    float frequency = 1.0f;
+    float maxValue = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        value += simplex3D(x * frequency, y * frequency, z * frequency) * amplitude;
+        maxValue += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    return maxValue > 0.0f ? value / maxValue : 0.0f;
+}
+
+}
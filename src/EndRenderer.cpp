@@ -0,0 +1,201 @@
+#include "../include/EndRenderer.h"
+#include "../include/AllocTracker.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+// Clip-space full-screen quad, two triangles
+static GLfloat screenVertices[] = {
+    -1.0f, -1.0f,   1.0f, -1.0f,   1.0f,  1.0f,
+    -1.0f, -1.0f,   1.0f,  1.0f,  -1.0f,  1.0f
+};
+
+// Density gradient per unit of noise gradient, the worst of the main island
+// (fbm * 8 at 0.02 plus detail * 2 at 0.05) and outer islands (fbm * 4 at 0.08).
+// Normalized fbm of n octaves is n / sum(amplitudes) times as steep as one octave.
+static float noiseGradientWeight(int octaves) {
+    auto fbm = [](int n) {
+        n = std::max(n, 1);
+        return n / (2.0f * (1.0f - std::pow(0.5f, static_cast<float>(n))));
+    };
+    float mainIsland = 8.0f * 0.02f * fbm(octaves) + 2.0f * 0.05f;
+    float outerIslands = 4.0f * 0.08f * fbm(octaves - 1);
+    return std::max(mainIsland, outerIslands);
+}
+
+EndRenderer::EndRenderer(int width, int height) :
+    shader("shaders/end_raymarch.vert", "shaders/end_raymarch.frag"),
+    vbo(screenVertices, sizeof(screenVertices)),
+    target(width, height) {
+    vao.Bind();
+    vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0);
+    vao.Unbind();
+    noise.Initialize();
+}
+
+void EndRenderer::SetUniforms(GLuint program, const Camera& camera, int width, int height, float time) {
+    // Keep the shader working in chunk-relative coordinates for float precision
+    glm::ivec3 chunkOrigin(
+        static_cast<int>(std::floor(camera.Position.x / 16.0f)),
+        static_cast<int>(std::floor(camera.Position.y / 16.0f)),
+        static_cast<int>(std::floor(camera.Position.z / 16.0f)));
+
+    Camera local = camera;
+    local.Position = camera.Position - glm::vec3(chunkOrigin) * 16.0f;
+    local.width = width;
+    local.height = height;
+    glm::mat4 invViewProj = glm::inverse(local.GetMatrix(fov, 0.1f, settings.maxDistance));
+
+    glUniformMatrix4fv(glGetUniformLocation(program, "uInvViewProj"), 1, GL_FALSE, glm::value_ptr(invViewProj));
+    glUniform3fv(glGetUniformLocation(program, "uCameraPos"), 1, glm::value_ptr(local.Position));
+    glUniform3i(glGetUniformLocation(program, "uChunkOrigin"), chunkOrigin.x, chunkOrigin.y, chunkOrigin.z);
+    glUniform1f(glGetUniformLocation(program, "uCameraAltitude"), camera.Position.y);
+
+    glUniform1f(glGetUniformLocation(program, "uMaxDistance"), settings.maxDistance);
+    glUniform1i(glGetUniformLocation(program, "uMaxSteps"), settings.maxSteps);
+    glUniform1f(glGetUniformLocation(program, "uTime"), time);
+    glUniform1i(glGetUniformLocation(program, "uOctaves"), settings.octaves);
+    glUniform1f(glGetUniformLocation(program, "uStepMultiplier"), settings.stepMultiplier);
+    glUniform1i(glGetUniformLocation(program, "uRefineSteps"), settings.refineSteps);
+    glUniform1i(glGetUniformLocation(program, "uSphereTrace"), settings.sphereTrace ? 1 : 0);
+    glUniform1f(glGetUniformLocation(program, "uRelaxation"), settings.relaxation);
+    // The clipmap and bricks are baked from the procedural density, so they must be traced against it
+    bool procedural = settings.sdfClipmap || settings.brickMap;
+    bool baked = settings.bakedNoise && !procedural;
+    glUniform1i(glGetUniformLocation(program, "uBakedNoise"), baked ? 1 : 0);
+    // settings.lipschitz bounds the procedural density. Baked noise steeper than simplex3D raises
+    // it by the excess; a smoother bake keeps it, the outer islands' shape sets the bound there.
+    float lipschitz = settings.lipschitz;
+    if (baked) {
+        float excess = std::max(noise.GetMaxGradient() - noise.GetReferenceGradient(), 0.0f);
+        lipschitz += noiseGradientWeight(settings.octaves) * excess;
+    }
+    glUniform1f(glGetUniformLocation(program, "uLipschitz"), std::max(lipschitz, 0.01f));
+    glUniform1i(glGetUniformLocation(program, "uNoiseVolume"), 0);
+    glUniform1f(glGetUniformLocation(program, "uNoisePeriod"), static_cast<float>(noise.period));
+    glUniform1i(glGetUniformLocation(program, "uUseIslandGrid"), settings.islandGrid && islandGrid.IsValid() ? 1 : 0);
+    glUniform1i(glGetUniformLocation(program, "uIslandGrid"), 1);
+    glUniform2i(glGetUniformLocation(program, "uIslandGridOrigin"), islandGrid.GetOriginX(), islandGrid.GetOriginZ());
+    glUniform1i(glGetUniformLocation(program, "uIslandGridSize"), IslandGrid::SIZE);
+    glUniform1i(glGetUniformLocation(program, "uIslandGridLevels"), IslandGrid::LEVELS);
+
+    GLint sdfUnits[SdfClipmap::LEVELS];
+    GLint sdfOrigins[SdfClipmap::LEVELS * 3];
+    for (int level = 0; level < SdfClipmap::LEVELS; level++) {
+        sdfUnits[level] = 2 + level;
+        glm::ivec3 origin = sdf.GetOrigin(level);
+        sdfOrigins[level * 3] = origin.x;
+        sdfOrigins[level * 3 + 1] = origin.y;
+        sdfOrigins[level * 3 + 2] = origin.z;
+    }
+    glUniform1i(glGetUniformLocation(program, "uUseSdf"), settings.sdfClipmap && sdf.IsValid() ? 1 : 0);
+    glUniform1i(glGetUniformLocation(program, "uSdfShadows"), settings.sdfShadows ? 1 : 0);
+    glUniform1iv(glGetUniformLocation(program, "uSdfLevels"), SdfClipmap::LEVELS, sdfUnits);
+    glUniform3iv(glGetUniformLocation(program, "uSdfOrigin"), SdfClipmap::LEVELS, sdfOrigins);
+    glUniform1f(glGetUniformLocation(program, "uSdfVoxelSize"), sdf.voxelSize);
+    glUniform1i(glGetUniformLocation(program, "uSdfResolution"), sdf.resolution);
+
+    glm::ivec2 brickWindow = bricks.GetWindowMin();
+    glm::ivec3 brickSlots = bricks.GetAtlasSlots();
+    glUniform1i(glGetUniformLocation(program, "uUseBricks"), settings.brickMap && bricks.IsValid() ? 1 : 0);
+    glUniform1i(glGetUniformLocation(program, "uBrickGrid"), 7);
+    glUniform1i(glGetUniformLocation(program, "uBrickAtlas"), 8);
+    glUniform1i(glGetUniformLocation(program, "uBrickGridSize"), BrickMap::GRID_SIZE);
+    glUniform2i(glGetUniformLocation(program, "uBrickWindowMin"), brickWindow.x, brickWindow.y);
+    glUniform3i(glGetUniformLocation(program, "uBrickAtlasSlots"), brickSlots.x, brickSlots.y, brickSlots.z);
+
+    glUniform3fv(glGetUniformLocation(program, "uEndStoneColor"), 1, glm::value_ptr(endStoneColor));
+    glUniform3fv(glGetUniformLocation(program, "uSkyColor"), 1, glm::value_ptr(skyColor));
+    glUniform3fv(glGetUniformLocation(program, "uFogColor"), 1, glm::value_ptr(fogColor));
+    glUniform1f(glGetUniformLocation(program, "uFogDensity"), fogDensity);
+}
+
+void EndRenderer::Render(const Camera& camera, int width, int height, float time, GLuint destinationFBO) {
+    PROFILE_ZONE("end render");
+    float scale = std::clamp(settings.renderScale, 0.1f, 1.0f);
+    int marchWidth = std::max(1, static_cast<int>(width * scale));
+    int marchHeight = std::max(1, static_cast<int>(height * scale));
+    target.Resize(marchWidth, marchHeight);
+
+    if (measureCost && !costShader) {
+        cost.Initialize();
+        costShader = std::make_unique<Shader>("shaders/end_raymarch.vert", "shaders/end_raymarch.frag", cost.ShaderPreamble());
+    }
+
+    if (settings.islandGrid) {
+        islandGrid.Update(static_cast<int>(std::floor(camera.Position.x / 16.0f)),
+                          static_cast<int>(std::floor(camera.Position.z / 16.0f)));
+    }
+
+    if (settings.sdfClipmap) {
+        sdf.Update(camera.Position, settings.octaves, settings.lipschitz);
+    }
+
+    if (settings.brickMap) {
+        bricks.Update(camera.Position, settings.maxDistance, settings.octaves, settings.lipschitz);
+    }
+
+    // Steady-state rendering must not touch the heap (resizing, grid, clipmap and brick updates above may)
+    NO_ALLOC_SCOPE("end render");
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    // Raymarch pass
+    {
+        GpuProfiler::Scope scope(profiler, "raymarch");
+        target.Bind();
+        noise.Bind(0);
+        islandGrid.Bind(1);
+        sdf.Bind(2);
+        bricks.Bind(7, 8);
+        if (measureCost) {
+            cost.Collect();
+            costShader->Activate();
+            SetUniforms(costShader->ID, camera, marchWidth, marchHeight, time);
+            glUniform1i(glGetUniformLocation(costShader->ID, "uCostView"), static_cast<int>(costView));
+            cost.BeginPass(marchWidth, marchHeight, settings.maxSteps);
+        } else {
+            shader.Activate();
+            SetUniforms(shader.ID, camera, marchWidth, marchHeight, time);
+        }
+        vao.Bind();
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        vao.Unbind();
+        if (measureCost) {
+            cost.EndPass();
+        }
+        target.Unbind();
+    }
+
+    // Upsample pass
+    {
+        GpuProfiler::Scope scope(profiler, "upsample");
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target.GetFBO());
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destinationFBO);
+        glBlitFramebuffer(0, 0, marchWidth, marchHeight, 0, 0, width, height,
+                          GL_COLOR_BUFFER_BIT, marchWidth == width ? GL_NEAREST : GL_LINEAR);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+}
+
+void EndRenderer::Delete() {
+    vao.Delete();
+    vbo.Delete();
+    shader.Delete();
+    target.Delete();
+    noise.Delete();
+    islandGrid.Delete();
+    sdf.Delete();
+    bricks.Shutdown();
+    if (costShader) {
+        costShader->Delete();
+        costShader.reset();
+    }
+    cost.Delete();
+}
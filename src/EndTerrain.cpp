@@ -0,0 +1,237 @@
+#include "../include/EndTerrain.h"
+#include "../include/EndNoise.h"
+#include <algorithm>
+#include <cmath>
+
+// Vertical allowance around an outer island's nominal height for its fbm term
+static const float ISLAND_NOISE_MARGIN = 8.0f;
+
+// Main island fbm (x8) and detail (x2) terms, |noise| < 1.3 for both the
+// procedural and the baked noise
+static const float MAIN_NOISE_MARGIN = 15.0f;
+
+// Distance from (x, z) to the nearest point of the chunk column
+static float DistanceToChunk(float x, float z, int chunkX, int chunkZ) {
+    float minX = chunkX * 16.0f, minZ = chunkZ * 16.0f;
+    float dx = x - std::clamp(x, minX, minX + 16.0f);
+    float dz = z - std::clamp(z, minZ, minZ + 16.0f);
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+EndTerrain::EndTerrain(int octaves) : octaves(octaves) {
+}
+
+// Height profile for main island
+float EndTerrain::MainIslandHeight(float dist) const {
+    if (dist > MAIN_ISLAND_RADIUS) return -100.0f;
+
+    float t = dist / MAIN_ISLAND_RADIUS;
+    float falloff = std::cos(t * 3.14159265f * 0.5f);
+    falloff = falloff * falloff;
+
+    return 40.0f * falloff;
+}
+
+float EndTerrain::MainIslandDensity(float x, float y, float z, float horizDist) const {
+    float heightAtDist = MainIslandHeight(horizDist);
+    float baseDensity = heightAtDist - (y - SEA_LEVEL);
+
+    // Add terrain noise
+    baseDensity += EndNoise::fbm3D(x * 0.02f, y * 0.02f, z * 0.02f, octaves) * 8.0f;
+
+    // Detail noise
+    baseDensity += EndNoise::simplex3D(x * 0.05f, y * 0.05f, z * 0.05f) * 2.0f;
+
+    // Floor cutoff
+    if (y < 4.0f) {
+        baseDensity -= (4.0f - y) * 2.0f;
+    }
+
+    return baseDensity;
+}
+
+bool EndTerrain::IslandForChunk(int chunkX, int chunkZ, Island& island) const {
+    float cx = static_cast<float>(chunkX);
+    float cz = static_cast<float>(chunkZ);
+
+    // Check if position is in outer island region
+    float dist = std::sqrt(cx * cx + cz * cz) * 16.0f;
+    if (dist <= EXCLUSION_ZONE_END) return false;
+
+    float noise = EndNoise::simplex2D(cx * 0.5f, cz * 0.5f);
+    float threshold = std::clamp(-0.8f + (dist / 3000.0f), -0.8f, -0.5f);
+    if (noise >= threshold) return false;
+
+    // Island center with variation
+    float offsetX = EndNoise::simplex2D(cx * 0.7f, cz * 0.7f + 100.0f) * 6.0f;
+    float offsetZ = EndNoise::simplex2D(cx * 0.3f + 100.0f, cz * 0.3f) * 6.0f;
+    island.centerX = cx * 16.0f + 8.0f + offsetX;
+    island.centerZ = cz * 16.0f + 8.0f + offsetZ;
+
+    // Island properties (the size noise is the same sample as the placement noise)
+    island.radius = 20.0f + noise * 15.0f;
+    island.height = 10.0f + noise * 10.0f;
+    return true;
+}
+
+void EndTerrain::IslandHeightRange(const Island& island, float& minY, float& maxY) const {
+    float halfHeight = island.height + ISLAND_NOISE_MARGIN;
+    minY = SEA_LEVEL - halfHeight;
+    maxY = SEA_LEVEL + halfHeight;
+}
+
+float EndTerrain::MainIslandMaxY(float horizDist) const {
+    return SEA_LEVEL + MainIslandHeight(horizDist) + MAIN_NOISE_MARGIN;
+}
+
+bool EndTerrain::ChunkHeightRange(int chunkX, int chunkZ, float& minY, float& maxY) const {
+    minY = MAX_Y;
+    maxY = MIN_Y;
+    bool solid = false;
+
+    // The main island profile falls off with distance, its nearest point is the highest
+    float nearest = DistanceToChunk(0.0f, 0.0f, chunkX, chunkZ);
+    if (nearest <= MAIN_ISLAND_RADIUS) {
+        minY = MIN_Y;
+        maxY = std::min(MainIslandMaxY(nearest), MAX_Y);
+        solid = true;
+    }
+
+    // Outer islands reach at most one chunk beyond their own
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            Island island;
+            if (!IslandForChunk(chunkX + dx, chunkZ + dz, island)) continue;
+            if (DistanceToChunk(island.centerX, island.centerZ, chunkX, chunkZ) > island.radius) continue;
+            float low, high;
+            IslandHeightRange(island, low, high);
+            minY = std::min(minY, std::max(low, MIN_Y));
+            maxY = std::max(maxY, std::min(high, MAX_Y));
+            solid = true;
+        }
+    }
+    return solid;
+}
+
+float EndTerrain::OuterIslandDensity(float x, float y, float z, float horizDist) const {
+    // Quick rejection
+    if (horizDist < EXCLUSION_ZONE_END) return -1.0f;
+
+    int chunkX = static_cast<int>(std::floor(x / 16.0f));
+    int chunkZ = static_cast<int>(std::floor(z / 16.0f));
+    float maxDensity = -1.0f;
+
+    // Check 3x3 chunk neighborhood
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            Island island;
+            if (!IslandForChunk(chunkX + dx, chunkZ + dz, island)) continue;
+
+            float toX = x - island.centerX;
+            float toZ = z - island.centerZ;
+            float islandDist = std::sqrt(toX * toX + toZ * toZ);
+            if (islandDist >= island.radius * 1.5f) continue;
+
+            float normDist = islandDist / island.radius;
+            float maxH = island.height * std::max(0.0f, 1.0f - normDist * normDist);
+            float density = maxH - std::abs(y - SEA_LEVEL);
+
+            // Add noise
+            density += EndNoise::fbm3D(x * 0.08f + island.centerX * 0.01f,
+                                       y * 0.08f,
+                                       z * 0.08f + island.centerZ * 0.01f,
+                                       std::max(1, octaves - 1)) * 4.0f;
+
+            // Edge falloff
+            float e = std::clamp((normDist - 0.7f) / 0.3f, 0.0f, 1.0f);
+            density *= 1.0f - e * e * (3.0f - 2.0f * e);
+
+            maxDensity = std::max(maxDensity, density);
+        }
+    }
+
+    return maxDensity;
+}
+
+float EndTerrain::Density(float x, float y, float z) const {
+    float horizDist = std::sqrt(x * x + z * z);
+
+    if (horizDist < EXCLUSION_ZONE_START) {
+        return MainIslandDensity(x, y, z, horizDist);
+    }
+
+    if (horizDist < EXCLUSION_ZONE_END) {
+        return -1.0f;  // Exclusion zone
+    }
+
+    return OuterIslandDensity(x, y, z, horizDist);
+}
+
+float EndTerrain::DistanceBound(float x, float y, float z, float density, float lipschitz) const {
+    float bound = -density / lipschitz;
+
+    // Solid terrain is confined to MIN_Y..MAX_Y
+    bound = std::max(bound, std::max(MIN_Y - y, y - MAX_Y));
+
+    // Nothing inside the exclusion ring, distance to its walls is horizontal
+    float horizDist = std::sqrt(x * x + z * z);
+    if (horizDist >= EXCLUSION_ZONE_START && horizDist < EXCLUSION_ZONE_END) {
+        bound = std::max(bound, std::min(horizDist - EXCLUSION_ZONE_START, EXCLUSION_ZONE_END - horizDist));
+    }
+    return bound;
+}
+
+EndTerrain::Column EndTerrain::SampleColumn(float x, float z) const {
+    Column column = { false, MIN_Y };
+    float horizDist = std::sqrt(x * x + z * z);
+
+    // Conservative vertical range where the density can be positive
+    float yTop, yBottom;
+    if (horizDist < EXCLUSION_ZONE_START) {
+        // Noise adds at most 8 + 2 on top of the height profile
+        yTop = SEA_LEVEL + std::max(0.0f, MainIslandHeight(horizDist)) + 11.0f;
+        yBottom = MIN_Y;
+    } else if (horizDist < EXCLUSION_ZONE_END) {
+        return column;
+    } else {
+        int chunkX = static_cast<int>(std::floor(x / 16.0f));
+        int chunkZ = static_cast<int>(std::floor(z / 16.0f));
+        float extent = -1.0f;
+        for (int dx = -1; dx <= 1; dx++) {
+            for (int dz = -1; dz <= 1; dz++) {
+                Island island;
+                if (!IslandForChunk(chunkX + dx, chunkZ + dz, island)) continue;
+                float toX = x - island.centerX;
+                float toZ = z - island.centerZ;
+                float normDist = std::sqrt(toX * toX + toZ * toZ) / island.radius;
+                if (normDist >= 1.0f) continue;  // Edge falloff zeroes the density
+                extent = std::max(extent, island.height * (1.0f - normDist * normDist) + 4.0f);
+            }
+        }
+        if (extent < 0.0f) return column;
+        yTop = SEA_LEVEL + extent;
+        yBottom = SEA_LEVEL - extent;
+    }
+
+    yTop = std::min(yTop, MAX_Y);
+    for (float y = std::ceil(yTop); y >= yBottom; y -= 1.0f) {
+        if (Density(x, y, z) > 0.0f) {
+            // Refine the crossing with binary search
+            float low = y;
+            float high = y + 1.0f;
+            for (int i = 0; i < 4; i++) {
+                float mid = (low + high) * 0.5f;
+                if (Density(x, mid, z) > 0.0f) {
+                    low = mid;
+                } else {
+                    high = mid;
+                }
+            }
+            column.solid = true;
+            column.topY = low;
+            return column;
+        }
+    }
+
+    return column;
+}
@@ -1,5 +1,6 @@
 #include "../include/FrameBuffer.h"
 #include "../include/Logger.h"
+#include "../include/GLDebug.h"
 
 Framebuffer::Framebuffer(int w, int h) : width(w), height(h), fbo(0), colorTexture(0), depthRenderbuffer(0) {
     CreateFramebuffer();
@@ -28,11 +29,15 @@ void Framebuffer::CreateFramebuffer() {
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
 
+    GL_OBJECT_LABEL(GL_FRAMEBUFFER, fbo, "Framebuffer " + std::to_string(width) + "x" + std::to_string(height));
+    GL_OBJECT_LABEL(GL_TEXTURE, colorTexture, "Framebuffer color " + std::to_string(width) + "x" + std::to_string(height));
+    GL_OBJECT_LABEL(GL_RENDERBUFFER, depthRenderbuffer, "Framebuffer depth " + std::to_string(width) + "x" + std::to_string(height));
+
     // Check framebuffer completeness
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         LOG_ERROR("Framebuffer not complete!");
     } else {
-        LOG_INFO("Framebuffer created successfully (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+        LOG_INFOF("Framebuffer created successfully ({}x{})", width, height);
     }
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
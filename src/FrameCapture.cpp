@@ -0,0 +1,483 @@
+#include "../include/FrameCapture.h"
+#include "../include/AllocTracker.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <zlib.h>
+
+FrameCapture::FrameCapture(int ringSize) :
+    slots(ringSize < 2 ? 2 : ringSize),
+    writeIndex(0),
+    readIndex(0),
+    pendingCount(0),
+    glInitialized(false),
+    recording(false),
+    sequenceFormat(Format::PNG),
+    sequenceFps(60),
+    sequenceFrame(0),
+    droppedFrames(0),
+    encoderBusy(false),
+    stopEncoder(false),
+    y4mFile(nullptr),
+    y4mWidth(0),
+    y4mHeight(0) {
+    encoderThread = std::thread(&FrameCapture::EncoderLoop, this);
+}
+
+FrameCapture::~FrameCapture() {
+    Shutdown();
+}
+
+void FrameCapture::InitializeGL() {
+    for (Slot& slot : slots) {
+        glGenBuffers(1, &slot.pbo);
+    }
+    glInitialized = true;
+}
+
+void FrameCapture::DeleteGL() {
+    for (Slot& slot : slots) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.pbo != 0) {
+            glDeleteBuffers(1, &slot.pbo);
+            slot.pbo = 0;
+        }
+        slot.state = SlotState::FREE;
+    }
+    pendingCount = 0;
+    glInitialized = false;
+}
+
+std::string FrameCapture::TimestampedPath(const std::string& prefix) {
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+
+    std::error_code ec;
+    std::filesystem::create_directories("captures", ec);
+    return "captures/" + prefix + "_" + stamp;
+}
+
+void FrameCapture::Screenshot(const std::string& path) {
+    screenshotPath = path;
+}
+
+bool FrameCapture::StartSequence(const std::string& basePath, Format format, int fps) {
+    if (recording) {
+        StopSequence();
+    }
+
+    std::filesystem::path parent = std::filesystem::path(basePath).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    sequenceBase = basePath;
+    sequenceFormat = format;
+    sequenceFps = fps > 0 ? fps : 60;
+    sequenceFrame = 0;
+    droppedFrames = 0;
+    recording = true;
+
+    LOG_INFO("Capture sequence started: " + basePath + (format == Format::PNG ? " (PNG)" : " (Y4M)"));
+    return true;
+}
+
+void FrameCapture::StopSequence() {
+    if (!recording) {
+        return;
+    }
+    recording = false;
+
+    // The stream can only be closed once the frames still in flight have been queued
+    DrainPending();
+
+    if (sequenceFormat == Format::Y4M) {
+        Job job;
+        job.type = JobType::CLOSE_STREAM;
+        std::lock_guard<std::mutex> lock(queueMutex);
+        jobQueue.push_back(std::move(job));
+        queueCondition.notify_one();
+    }
+
+    LOG_INFOF("Capture sequence stopped after {} frames, {} dropped", sequenceFrame, droppedFrames);
+}
+
+void FrameCapture::CaptureFrame(int width, int height) {
+    PROFILE_ZONE("capture frame");
+    ALLOC_SCOPE("capture");
+    if (!glInitialized) {
+        InitializeGL();
+    }
+
+    // Hand off completed readbacks and recycle encoded slots, without waiting
+    Collect(false);
+
+    bool wantScreenshot = !screenshotPath.empty();
+    if ((!wantScreenshot && !recording) || width <= 0 || height <= 0) {
+        return;
+    }
+
+    // Every slot is still being read back or encoded: drop the frame rather
+    // than stall. A screenshot request stays set and is taken next frame.
+    Slot& slot = slots[writeIndex];
+    if (slot.state != SlotState::FREE) {
+        droppedFrames++;
+        return;
+    }
+
+    if (recording) {
+        if (sequenceFormat == Format::PNG) {
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), "_%06d.png", sequenceFrame);
+            slot.job.type = JobType::SEQUENCE_PNG;
+            slot.job.path = sequenceBase + suffix;
+        } else {
+            slot.job.type = JobType::SEQUENCE_Y4M;
+            slot.job.path = sequenceBase + ".y4m";
+        }
+        slot.job.fps = sequenceFps;
+        slot.job.screenshotPath = screenshotPath;
+        sequenceFrame++;
+    } else {
+        slot.job.type = JobType::SCREENSHOT;
+        slot.job.path = screenshotPath;
+    }
+    screenshotPath.clear();
+
+    Submit(slot, width, height);
+    writeIndex = (writeIndex + 1) % slots.size();
+    pendingCount++;
+}
+
+void FrameCapture::Submit(Slot& slot, int width, int height) {
+    GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    if (slot.capacity < size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+
+    // With a pack buffer bound, glReadPixels only queues the copy and returns
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.job.width = width;
+    slot.job.height = height;
+    slot.state = SlotState::READING;
+}
+
+bool FrameCapture::HandOff(Slot& slot, int index, bool wait) {
+    GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                     wait ? 1000000000ull : 0);
+    if (status == GL_TIMEOUT_EXPIRED && !wait) {
+        return false;
+    }
+    if (status == GL_WAIT_FAILED) {
+        LOG_ERROR("FrameCapture: glClientWaitSync failed, frame dropped");
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    slot.state = SlotState::FREE;
+
+    if (status == GL_WAIT_FAILED) {
+        return true;
+    }
+
+    // Only mapped here: the encoder reads the pixels straight from the buffer,
+    // which stays mapped until Collect sees the frame encoded
+    size_t size = static_cast<size_t>(slot.job.width) * slot.job.height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (data == nullptr) {
+        LOG_ERROR("FrameCapture: failed to map pixel pack buffer, frame dropped");
+        return true;
+    }
+
+    slot.job.slot = index;
+    slot.job.pixels = static_cast<const uint8_t*>(data);
+    slot.state = SlotState::ENCODING;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        slot.encoded = false;
+        jobQueue.push_back(std::move(slot.job));
+        slot.job = Job();
+    }
+    queueCondition.notify_one();
+    return true;
+}
+
+void FrameCapture::Collect(bool wait) {
+    // Oldest first, so the encoder receives frames in capture order
+    size_t index = readIndex;
+    for (int i = 0; i < pendingCount; i++, index = (index + 1) % slots.size()) {
+        Slot& slot = slots[index];
+        if (slot.state == SlotState::READING && !HandOff(slot, static_cast<int>(index), wait)) {
+            break;
+        }
+    }
+
+    // Unmap the buffers the encoder is done with and return their slots
+    while (pendingCount > 0) {
+        Slot& slot = slots[readIndex];
+        if (slot.state == SlotState::ENCODING) {
+            bool encoded;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                encoded = slot.encoded;
+            }
+            if (!encoded) {
+                break;
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            slot.state = SlotState::FREE;
+        }
+        if (slot.state != SlotState::FREE) {
+            break;
+        }
+        readIndex = (readIndex + 1) % slots.size();
+        pendingCount--;
+    }
+}
+
+void FrameCapture::DrainPending() {
+    // Every readback in flight goes to the encoder, waiting for the GPU if needed
+    Collect(true);
+}
+
+void FrameCapture::Flush() {
+    DrainPending();
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        idleCondition.wait(lock, [this] { return jobQueue.empty() && !encoderBusy; });
+    }
+    // Everything is encoded, release the buffers
+    Collect(false);
+}
+
+void FrameCapture::Shutdown() {
+    if (!encoderThread.joinable()) {
+        return;
+    }
+
+    if (glInitialized) {
+        StopSequence();
+        Flush();
+        DeleteGL();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopEncoder = true;
+    }
+    queueCondition.notify_one();
+    encoderThread.join();
+}
+
+// ============================================================================
+// ENCODER THREAD
+// ============================================================================
+
+void FrameCapture::EncoderLoop() {
+    Profiler::SetThreadName("capture encoder");
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopEncoder || !jobQueue.empty(); });
+            if (jobQueue.empty()) {
+                break;
+            }
+            job = std::move(jobQueue.front());
+            jobQueue.pop_front();
+            encoderBusy = true;
+        }
+        idleCondition.notify_all();
+
+        Encode(job);
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (job.slot >= 0) {
+                slots[job.slot].encoded = true;
+            }
+            encoderBusy = false;
+        }
+        idleCondition.notify_all();
+    }
+
+    CloseStream();
+}
+
+void FrameCapture::Encode(Job& job) {
+    PROFILE_ZONE("encode frame");
+    ALLOC_SCOPE("capture");
+    switch (job.type) {
+        case JobType::SCREENSHOT:
+            if (WritePNG(job, job.path, Z_DEFAULT_COMPRESSION)) {
+                LOG_INFOF("Screenshot saved: {}", job.path);
+            }
+            break;
+        case JobType::SEQUENCE_PNG:
+            // Sequences favour throughput over file size
+            WritePNG(job, job.path, Z_BEST_SPEED);
+            break;
+        case JobType::SEQUENCE_Y4M:
+            WriteY4MFrame(job);
+            break;
+        case JobType::CLOSE_STREAM:
+            CloseStream();
+            break;
+    }
+
+    // Screenshot requested while a sequence was recording
+    if (job.type != JobType::SCREENSHOT && !job.screenshotPath.empty()) {
+        if (WritePNG(job, job.screenshotPath, Z_DEFAULT_COMPRESSION)) {
+            LOG_INFOF("Screenshot saved: {}", job.screenshotPath);
+        }
+    }
+}
+
+// Helper to append a big-endian 32-bit value
+static void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static void writePNGChunk(FILE* file, const char* type, const uint8_t* data, uint32_t length) {
+    std::vector<uint8_t> header;
+    appendU32(header, length);
+    header.insert(header.end(), type, type + 4);
+    std::fwrite(header.data(), 1, header.size(), file);
+    if (length > 0) {
+        std::fwrite(data, 1, length, file);
+    }
+
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+    if (length > 0) {
+        crc = crc32(crc, data, length);
+    }
+    std::vector<uint8_t> footer;
+    appendU32(footer, static_cast<uint32_t>(crc));
+    std::fwrite(footer.data(), 1, footer.size(), file);
+}
+
+bool FrameCapture::WritePNG(const Job& job, const std::string& path, int level) {
+    const int w = job.width;
+    const int h = job.height;
+    const size_t rowBytes = static_cast<size_t>(w) * 3 + 1;
+
+    // Flip to top-down rows, drop alpha and prefix each row with filter type 0
+    scratch.resize(rowBytes * h);
+    for (int y = 0; y < h; y++) {
+        const uint8_t* src = job.pixels + static_cast<size_t>(h - 1 - y) * w * 4;
+        uint8_t* dst = scratch.data() + static_cast<size_t>(y) * rowBytes;
+        *dst++ = 0;
+        for (int x = 0; x < w; x++) {
+            *dst++ = src[0];
+            *dst++ = src[1];
+            *dst++ = src[2];
+            src += 4;
+        }
+    }
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(scratch.size()));
+    compressed.resize(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, scratch.data(),
+                  static_cast<uLong>(scratch.size()), level) != Z_OK) {
+        LOG_ERROR("FrameCapture: zlib compression failed for " + path);
+        return false;
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        LOG_ERROR("FrameCapture: failed to open " + path);
+        return false;
+    }
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::fwrite(signature, 1, sizeof(signature), file);
+
+    std::vector<uint8_t> ihdr;
+    appendU32(ihdr, static_cast<uint32_t>(w));
+    appendU32(ihdr, static_cast<uint32_t>(h));
+    ihdr.push_back(8);  // Bit depth
+    ihdr.push_back(2);  // Color type: RGB
+    ihdr.push_back(0);  // Compression
+    ihdr.push_back(0);  // Filter
+    ihdr.push_back(0);  // Interlace
+    writePNGChunk(file, "IHDR", ihdr.data(), static_cast<uint32_t>(ihdr.size()));
+    writePNGChunk(file, "IDAT", compressed.data(), static_cast<uint32_t>(compressedSize));
+    writePNGChunk(file, "IEND", nullptr, 0);
+
+    std::fclose(file);
+    return true;
+}
+
+bool FrameCapture::WriteY4MFrame(const Job& job) {
+    if (y4mFile == nullptr) {
+        y4mFile = std::fopen(job.path.c_str(), "wb");
+        if (y4mFile == nullptr) {
+            LOG_ERROR("FrameCapture: failed to open " + job.path);
+            return false;
+        }
+        y4mWidth = job.width;
+        y4mHeight = job.height;
+        std::fprintf(y4mFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", y4mWidth, y4mHeight, job.fps);
+    }
+
+    // Y4M streams have a fixed frame size, frames captured after a resize are skipped
+    if (job.width != y4mWidth || job.height != y4mHeight) {
+        return false;
+    }
+
+    const int w = job.width;
+    const int h = job.height;
+    const size_t planeSize = static_cast<size_t>(w) * h;
+    scratch.resize(planeSize * 3);
+    uint8_t* yPlane = scratch.data();
+    uint8_t* uPlane = yPlane + planeSize;
+    uint8_t* vPlane = uPlane + planeSize;
+
+    // BT.601 limited range, flipped to top-down rows
+    for (int y = 0; y < h; y++) {
+        const uint8_t* src = job.pixels + static_cast<size_t>(h - 1 - y) * w * 4;
+        size_t row = static_cast<size_t>(y) * w;
+        for (int x = 0; x < w; x++) {
+            int r = src[0];
+            int g = src[1];
+            int b = src[2];
+            src += 4;
+            yPlane[row + x] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+            uPlane[row + x] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[row + x] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    std::fputs("FRAME\n", y4mFile);
+    std::fwrite(scratch.data(), 1, scratch.size(), y4mFile);
+    return true;
+}
+
+void FrameCapture::CloseStream() {
+    if (y4mFile != nullptr) {
+        std::fclose(y4mFile);
+        y4mFile = nullptr;
+    }
+}
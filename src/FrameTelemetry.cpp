@@ -0,0 +1,309 @@
+#include "../include/FrameTelemetry.h"
+#include "../include/Logger.h"
+#include "imGUI1/imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+int LatencyHistogram::BucketIndex(uint64_t us) {
+    if (us < static_cast<uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(us);
+    }
+
+    int exponent = 63 - __builtin_clzll(us);
+    if (exponent > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+
+    // Top SUB_BUCKET_BITS + 1 bits select the sub-bucket within the octave
+    int sub = static_cast<int>(us >> (exponent - SUB_BUCKET_BITS));
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub - SUB_BUCKETS;
+}
+
+double LatencyHistogram::BucketValue(int index) {
+    if (index < SUB_BUCKETS) {
+        return index * 1e-3;
+    }
+
+    int octave = index / SUB_BUCKETS - 1;
+    int sub = index % SUB_BUCKETS + SUB_BUCKETS;
+    double width = static_cast<double>(1ull << octave);
+    return (sub * width + width * 0.5) * 1e-3;
+}
+
+void LatencyHistogram::Record(double ms) {
+    double us = std::max(ms, 0.0) * 1000.0;
+    buckets[BucketIndex(static_cast<uint64_t>(us + 0.5))]++;
+    count++;
+    maxMs = std::max(maxMs, ms);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    maxMs = std::max(maxMs, other.maxMs);
+}
+
+void LatencyHistogram::Reset() {
+    std::fill(buckets, buckets + BUCKET_COUNT, 0u);
+    count = 0;
+    maxMs = 0.0;
+}
+
+double LatencyHistogram::Percentile(double percentile) const {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * count));
+    target = std::max<uint64_t>(target, 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return std::min(BucketValue(i), maxMs);
+        }
+    }
+    return maxMs;
+}
+
+// ============================================================================
+// FrameTelemetry
+// ============================================================================
+
+FrameTelemetry::FrameTelemetry() :
+    currentSecond(0),
+    startTime(Clock::now()),
+    frameStart(startTime),
+    lastPresent(startTime),
+    lastExport(startTime),
+    havePresent(false) {
+    for (Second& second : history) {
+        ClearSecond(second);
+    }
+    ClearSecond(pending);
+    windows[0].seconds = SHORT_WINDOW;
+    windows[1].seconds = HISTORY_SECONDS;
+}
+
+FrameTelemetry::~FrameTelemetry() {
+    Flush();
+}
+
+void FrameTelemetry::ClearSecond(Second& second) {
+    second.cpu.Reset();
+    second.gpu.Reset();
+    second.present.Reset();
+    second.frames = 0;
+    second.hitches = 0;
+}
+
+FrameTelemetry::Second& FrameTelemetry::Current() {
+    return history[currentSecond % HISTORY_SECONDS];
+}
+
+void FrameTelemetry::Advance() {
+    Clock::time_point now = Clock::now();
+    int64_t second = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
+    if (second != currentSecond) {
+        // Seconds without frames (minimised window, debugger) stay empty
+        int64_t first = std::max(currentSecond + 1, second - HISTORY_SECONDS + 1);
+        for (int64_t s = first; s <= second; s++) {
+            ClearSecond(history[s % HISTORY_SECONDS]);
+        }
+        currentSecond = second;
+        RefreshWindows();
+    }
+
+    if (exportInterval > 0.0f &&
+        std::chrono::duration<float>(now - lastExport).count() >= exportInterval) {
+        Flush();
+    }
+}
+
+void FrameTelemetry::RefreshWindows() {
+    for (WindowStats& window : windows) {
+        Second merged;
+        ClearSecond(merged);
+        // Completed seconds only, the current one is still filling up
+        for (int k = 1; k <= window.seconds && k <= currentSecond; k++) {
+            const Second& second = history[(currentSecond - k) % HISTORY_SECONDS];
+            merged.cpu.Merge(second.cpu);
+            merged.gpu.Merge(second.gpu);
+            merged.present.Merge(second.present);
+            merged.frames += second.frames;
+            merged.hitches += second.hitches;
+        }
+        window.frames = merged.frames;
+        window.hitches = merged.hitches;
+        window.cpu = Stats(merged.cpu);
+        window.gpu = Stats(merged.gpu);
+        window.present = Stats(merged.present);
+    }
+}
+
+FrameTelemetry::MetricStats FrameTelemetry::Stats(const LatencyHistogram& histogram) {
+    MetricStats stats;
+    stats.p50 = histogram.Percentile(50.0);
+    stats.p90 = histogram.Percentile(90.0);
+    stats.p99 = histogram.Percentile(99.0);
+    stats.max = histogram.GetMax();
+    return stats;
+}
+
+void FrameTelemetry::BeginFrame() {
+    Advance();
+    frameStart = Clock::now();
+}
+
+void FrameTelemetry::EndFrame() {
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+    Current().cpu.Record(ms);
+    pending.cpu.Record(ms);
+}
+
+void FrameTelemetry::Presented() {
+    Clock::time_point now = Clock::now();
+    if (havePresent) {
+        double interval = std::chrono::duration<double, std::milli>(now - lastPresent).count();
+        double baseline = windows[0].present.p50;
+        bool hitch = baseline > 0.0 && interval > hitchFactor * baseline;
+
+        Second& second = Current();
+        second.present.Record(interval);
+        second.frames++;
+        pending.present.Record(interval);
+        pending.frames++;
+        if (hitch) {
+            second.hitches++;
+            pending.hitches++;
+        }
+    }
+    lastPresent = now;
+    havePresent = true;
+}
+
+void FrameTelemetry::RecordGpu(double ms) {
+    Current().gpu.Record(ms);
+    pending.gpu.Record(ms);
+}
+
+void FrameTelemetry::Flush() {
+    Clock::time_point now = Clock::now();
+    double seconds = std::chrono::duration<double>(now - lastExport).count();
+    lastExport = now;
+    if (pending.frames == 0 || exportPath.empty()) {
+        return;
+    }
+
+    WriteLine(pending, seconds);
+    ClearSecond(pending);
+}
+
+static void writeStats(std::ofstream& out, const char* name, const FrameTelemetry::MetricStats& stats) {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "\"%s\":{\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+                  name, stats.p50, stats.p90, stats.p99, stats.max);
+    out << buffer;
+}
+
+void FrameTelemetry::WriteLine(const Second& second, double seconds) {
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(exportPath).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream out(exportPath, std::ios::app);
+    if (!out.is_open()) {
+        LOG_WARNINGF("Failed to append frame telemetry to {}", exportPath);
+        return;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\"time\":\"" << date << "\",\"duration_s\":" << seconds
+        << ",\"frames\":" << second.frames << ",\"hitches\":" << second.hitches << ",";
+    writeStats(out, "cpu_ms", Stats(second.cpu));
+    out << ",";
+    writeStats(out, "gpu_ms", Stats(second.gpu));
+    out << ",";
+    writeStats(out, "present_ms", Stats(second.present));
+    if (!renderer.empty()) {
+        out << ",\"renderer\":\"";
+        for (char c : renderer) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << "\"";
+    }
+#ifdef NDEBUG
+    out << ",\"optimized\":true}\n";
+#else
+    out << ",\"optimized\":false}\n";
+#endif
+}
+
+void FrameTelemetry::DrawWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(440, 230), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Frame Telemetry", open)) {
+        ImGui::End();
+        return;
+    }
+
+    for (const WindowStats& window : windows) {
+        double fps = window.seconds > 0 ? static_cast<double>(window.frames) / window.seconds : 0.0;
+        ImGui::Text("Last %d s: %llu frames (%.1f FPS), %llu hitches", window.seconds,
+                    static_cast<unsigned long long>(window.frames), fps,
+                    static_cast<unsigned long long>(window.hitches));
+
+        ImGui::PushID(window.seconds);
+        ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV;
+        if (ImGui::BeginTable("stats", 5, flags)) {
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p90");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+
+            const char* names[] = {"CPU", "GPU", "Present"};
+            const MetricStats* metrics[] = {&window.cpu, &window.gpu, &window.present};
+            for (int i = 0; i < 3; i++) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(names[i]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", metrics[i]->p50);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", metrics[i]->p90);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", metrics[i]->p99);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", metrics[i]->max);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::PopID();
+    }
+
+    ImGui::SliderFloat("Hitch Factor", &hitchFactor, 1.25f, 4.0f, "%.2fx p50");
+    if (exportInterval > 0.0f) {
+        ImGui::TextDisabled("Appending to %s every %.0f s", exportPath.c_str(), exportInterval);
+    }
+
+    ImGui::End();
+}
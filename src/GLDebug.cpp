@@ -0,0 +1,143 @@
+#include "../include/GLDebug.h"
+#include "../include/Logger.h"
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+// Informational IDs from common drivers that fire on every buffer upload or
+// texture state change (NVIDIA buffer placement, shader recompile notices)
+static const GLuint DEFAULT_IGNORED_IDS[] = {131169, 131185, 131204, 131218};
+
+static bool active = false;
+static std::mutex mutex;
+static std::unordered_set<GLuint> ignoredIds;
+static std::unordered_map<GLuint, std::unique_ptr<LogSite>> sites;
+
+static const char* sourceName(GLenum source) {
+    switch (source) {
+        case GL_DEBUG_SOURCE_API:             return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "Window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "Shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:     return "Third party";
+        case GL_DEBUG_SOURCE_APPLICATION:     return "Application";
+        default:                              return "Other";
+    }
+}
+
+static const char* typeName(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR:               return "error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY:         return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE:         return "performance";
+        case GL_DEBUG_TYPE_MARKER:              return "marker";
+        default:                                return "other";
+    }
+}
+
+static Logger::LogLevel severityLevel(GLenum severity) {
+    switch (severity) {
+        case GL_DEBUG_SEVERITY_HIGH:   return Logger::LogLevel::ERROR;
+        case GL_DEBUG_SEVERITY_MEDIUM: return Logger::LogLevel::WARNING;
+        case GL_DEBUG_SEVERITY_LOW:    return Logger::LogLevel::INFO;
+        default:                       return Logger::LogLevel::DEBUG;
+    }
+}
+
+static void GLAPIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                     GLsizei length, const GLchar* message, const void* /*userParam*/) {
+    Logger* logger = Logger::getInstance();
+    Logger::LogLevel level = severityLevel(severity);
+    if (!logger->isEnabled(level)) {
+        return;
+    }
+
+    // One rate limiting site per message ID, reported as "(GL:<id>)"
+    LogSite* site;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ignoredIds.count(id) != 0) {
+            return;
+        }
+        std::unique_ptr<LogSite>& entry = sites[id];
+        if (!entry) {
+            entry = std::make_unique<LogSite>("GL", static_cast<int>(id));
+        }
+        site = entry.get();
+    }
+
+    if (logger->allow(*site, level)) {
+        std::string_view text(message, length >= 0 ? static_cast<size_t>(length) : std::char_traits<char>::length(message));
+        logger->logFormat(level, site->file, site->line, "{} {}: {}", sourceName(source), typeName(type), text);
+    }
+}
+
+bool GLDebug::Initialize() {
+    if (!GLEW_KHR_debug && !GLEW_VERSION_4_3) {
+#ifdef NDEBUG
+        LOG_WARNING("KHR_debug not available, GL errors will not be reported");
+#else
+        LOG_WARNING("KHR_debug not available, GL errors are only reported by LOG_GLERROR");
+#endif
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+#ifndef NDEBUG
+    // Report on the offending call so the log order matches the code
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+#endif
+    glDebugMessageCallback(debugCallback, nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ignoredIds.insert(std::begin(DEFAULT_IGNORED_IDS), std::end(DEFAULT_IGNORED_IDS));
+    }
+
+#ifdef NDEBUG
+    SetMinimumSeverity(GL_DEBUG_SEVERITY_MEDIUM);
+#else
+    SetMinimumSeverity(GL_DEBUG_SEVERITY_LOW);
+#endif
+
+    active = true;
+    LOG_INFO("GL debug output enabled");
+    return true;
+}
+
+bool GLDebug::IsActive() {
+    return active;
+}
+
+void GLDebug::SetMinimumSeverity(GLenum severity) {
+    // Ordered from most to least severe
+    static const GLenum severities[] = {
+        GL_DEBUG_SEVERITY_HIGH,
+        GL_DEBUG_SEVERITY_MEDIUM,
+        GL_DEBUG_SEVERITY_LOW,
+        GL_DEBUG_SEVERITY_NOTIFICATION
+    };
+
+    bool enabled = true;
+    for (GLenum level : severities) {
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, level, 0, nullptr, enabled ? GL_TRUE : GL_FALSE);
+        if (level == severity) {
+            enabled = false;
+        }
+    }
+}
+
+void GLDebug::IgnoreMessage(GLuint id) {
+    // glDebugMessageControl needs source and type for ID lists, so filter here
+    std::lock_guard<std::mutex> lock(mutex);
+    ignoredIds.insert(id);
+}
+
+void GLDebug::Label(GLenum identifier, GLuint name, const std::string& label) {
+    if (active) {
+        glObjectLabel(identifier, name, static_cast<GLsizei>(label.size()), label.c_str());
+    }
+}
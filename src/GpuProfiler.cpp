@@ -0,0 +1,313 @@
+#include "../include/GpuProfiler.h"
+#include "../include/AllocTracker.h"
+#include "../include/FrameCapture.h"
+#include "../include/Logger.h"
+#include "imGUI1/imgui.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+// Definition for std::min, which binds it to a reference
+const int GpuProfiler::HISTORY_SIZE;
+
+GpuProfiler::Scope::Scope(GpuProfiler* profiler, const char* name) : profiler(profiler) {
+    if (profiler != nullptr) {
+        profiler->BeginPass(name);
+    }
+}
+
+GpuProfiler::Scope::~Scope() {
+    if (profiler != nullptr) {
+        profiler->EndPass();
+    }
+}
+
+GpuProfiler::GpuProfiler() :
+    current(0),
+    frameIndex(0),
+    inFrame(false),
+    historyOffset(0),
+    historyCount(0),
+    lastFrameMs(0.0f),
+    skippedFrames(0),
+    resolvedFrames(0),
+    recordStart(0) {
+    std::fill(frameHistory, frameHistory + HISTORY_SIZE, 0.0f);
+
+    // Passes are recorded inside no-alloc regions, so grow the buffers up front
+    for (Frame& frame : frames) {
+        frame.queries.reserve(128);
+        frame.passes.reserve(64);
+    }
+    openPasses.reserve(16);
+}
+
+int GpuProfiler::IssueTimestamp() {
+    Frame& frame = frames[current];
+    if (frame.usedQueries == static_cast<int>(frame.queries.size())) {
+        GLuint query;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+    glQueryCounter(frame.queries[frame.usedQueries], GL_TIMESTAMP);
+    return frame.usedQueries++;
+}
+
+void GpuProfiler::BeginFrame() {
+    if (!enabled) {
+        return;
+    }
+    ALLOC_SCOPE("profiler");
+
+    // The slot about to be reused holds the oldest frame in the ring
+    current = (current + 1) % FRAME_RING_SIZE;
+    Frame& frame = frames[current];
+    Resolve(frame);
+
+    frame.usedQueries = 0;
+    frame.passes.clear();
+    frame.index = frameIndex++;
+    openPasses.clear();
+    inFrame = true;
+    IssueTimestamp();
+}
+
+void GpuProfiler::EndFrame() {
+    if (!inFrame) {
+        return;
+    }
+
+    while (!openPasses.empty()) {
+        EndPass();
+    }
+    IssueTimestamp();
+    frames[current].pending = true;
+    inFrame = false;
+}
+
+void GpuProfiler::BeginPass(const char* name) {
+    if (!inFrame) {
+        return;
+    }
+
+    Frame& frame = frames[current];
+    openPasses.push_back(static_cast<int>(frame.passes.size()));
+    frame.passes.push_back({name, static_cast<int>(openPasses.size()) - 1, IssueTimestamp(), -1});
+}
+
+void GpuProfiler::EndPass() {
+    if (!inFrame || openPasses.empty()) {
+        return;
+    }
+
+    frames[current].passes[openPasses.back()].end = IssueTimestamp();
+    openPasses.pop_back();
+}
+
+void GpuProfiler::Resolve(Frame& frame) {
+    if (!frame.pending) {
+        return;
+    }
+    frame.pending = false;
+
+    // Timestamps complete in order, so the last one being ready covers the frame
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        skippedFrames++;
+        return;
+    }
+
+    std::vector<GLuint64>& times = resolveTimes;
+    times.resize(frame.usedQueries);
+    for (int i = 0; i < frame.usedQueries; i++) {
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &times[i]);
+    }
+
+    FrameRecord record;
+    record.index = frame.index;
+    record.frameMs = static_cast<float>(times[frame.usedQueries - 1] - times[0]) * 1e-6f;
+
+    for (const PassQuery& pass : frame.passes) {
+        int stats = FindOrAddPass(pass.name, pass.depth);
+        float ms = static_cast<float>(times[pass.end] - times[pass.begin]) * 1e-6f;
+
+        // A pass issued several times in one frame is reported as its sum
+        auto it = std::find_if(record.passes.begin(), record.passes.end(),
+                               [stats](const std::pair<int, float>& p) { return p.first == stats; });
+        if (it != record.passes.end()) {
+            it->second += ms;
+        } else {
+            record.passes.emplace_back(stats, ms);
+        }
+    }
+
+    frameHistory[historyOffset] = record.frameMs;
+    for (PassStats& stats : passStats) {
+        stats.history[historyOffset] = 0.0f;
+    }
+    for (const auto& pass : record.passes) {
+        PassStats& stats = passStats[pass.first];
+        stats.history[historyOffset] = pass.second;
+        stats.lastMs = pass.second;
+    }
+    historyOffset = (historyOffset + 1) % HISTORY_SIZE;
+    historyCount = std::min(historyCount + 1, HISTORY_SIZE);
+    lastFrameMs = record.frameMs;
+    resolvedFrames++;
+
+    if (records.size() < CSV_HISTORY) {
+        records.push_back(std::move(record));
+    } else {
+        records[recordStart] = std::move(record);
+        recordStart = (recordStart + 1) % CSV_HISTORY;
+    }
+}
+
+int GpuProfiler::FindOrAddPass(const char* name, int depth) {
+    for (size_t i = 0; i < passStats.size(); i++) {
+        if (passStats[i].name == name) {
+            return static_cast<int>(i);
+        }
+    }
+
+    PassStats stats;
+    stats.name = name;
+    stats.depth = depth;
+    std::fill(stats.history, stats.history + HISTORY_SIZE, 0.0f);
+    stats.lastMs = 0.0f;
+    passStats.push_back(stats);
+    return static_cast<int>(passStats.size()) - 1;
+}
+
+float GpuProfiler::GetAverageFrameMs() const {
+    if (historyCount == 0) {
+        return 0.0f;
+    }
+    float sum = 0.0f;
+    for (int i = 0; i < historyCount; i++) {
+        sum += frameHistory[i];
+    }
+    return sum / historyCount;
+}
+
+void GpuProfiler::DrawWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(420, 360), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("GPU Profiler", open)) {
+        ImGui::End();
+        return;
+    }
+
+    ImGui::Checkbox("Enabled", &enabled);
+    ImGui::SameLine();
+    if (ImGui::Button("Dump CSV")) {
+        DumpCsv(FrameCapture::TimestampedPath("gpu_profile") + ".csv");
+    }
+
+    float average = GetAverageFrameMs();
+    ImGui::Text("GPU frame %.3f ms, average %.3f ms over %d frames", lastFrameMs, average, historyCount);
+    if (skippedFrames > 0) {
+        ImGui::Text("%zu frames skipped (results not ready after %d frames)", skippedFrames, FRAME_RING_SIZE - 1);
+    }
+
+    // Oldest sample first once the ring has wrapped
+    int plotOffset = historyCount < HISTORY_SIZE ? 0 : historyOffset;
+    float plotMax = 0.0f;
+    for (int i = 0; i < historyCount; i++) {
+        plotMax = std::max(plotMax, frameHistory[i]);
+    }
+    char overlay[32];
+    std::snprintf(overlay, sizeof(overlay), "max %.2f ms", plotMax);
+    ImGui::PlotLines("##frame", frameHistory, historyCount, plotOffset, overlay,
+                     0.0f, std::max(plotMax * 1.1f, 1.0f), ImVec2(-1.0f, 80.0f));
+
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+    if (ImGui::BeginTable("passes", 5, flags)) {
+        ImGui::TableSetupColumn("Pass", ImGuiTableColumnFlags_WidthStretch, 1.2f);
+        ImGui::TableSetupColumn("Last", ImGuiTableColumnFlags_WidthStretch, 0.6f);
+        ImGui::TableSetupColumn("Avg", ImGuiTableColumnFlags_WidthStretch, 0.6f);
+        ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthStretch, 0.6f);
+        ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_WidthStretch, 1.5f);
+        ImGui::TableHeadersRow();
+
+        for (const PassStats& stats : passStats) {
+            float sum = 0.0f;
+            float maxMs = 0.0f;
+            for (int i = 0; i < historyCount; i++) {
+                sum += stats.history[i];
+                maxMs = std::max(maxMs, stats.history[i]);
+            }
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Indent(stats.depth * 10.0f + 1.0f);
+            ImGui::TextUnformatted(stats.name.c_str());
+            ImGui::Unindent(stats.depth * 10.0f + 1.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", stats.lastMs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", historyCount > 0 ? sum / historyCount : 0.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", maxMs);
+            ImGui::TableNextColumn();
+            ImGui::PushID(stats.name.c_str());
+            ImGui::PlotLines("##history", stats.history, historyCount, plotOffset, nullptr,
+                             0.0f, std::max(maxMs, 0.01f), ImVec2(-1.0f, 16.0f));
+            ImGui::PopID();
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+bool GpuProfiler::DumpCsv(const std::string& path) const {
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        LOG_ERRORF("Failed to write GPU profile: {}", path);
+        return false;
+    }
+
+    out << "frame,frame_ms";
+    for (const PassStats& stats : passStats) {
+        out << "," << stats.name << "_ms";
+    }
+    out << "\n";
+
+    std::vector<float> row(passStats.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        const FrameRecord& record = records[(recordStart + i) % records.size()];
+        std::fill(row.begin(), row.end(), 0.0f);
+        for (const auto& pass : record.passes) {
+            row[pass.first] = pass.second;
+        }
+
+        out << record.index << "," << record.frameMs;
+        for (float ms : row) {
+            out << "," << ms;
+        }
+        out << "\n";
+    }
+
+    LOG_INFOF("GPU profile written to {} ({} frames)", path, records.size());
+    return true;
+}
+
+void GpuProfiler::Delete() {
+    for (Frame& frame : frames) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            frame.queries.clear();
+        }
+        frame.usedQueries = 0;
+        frame.pending = false;
+    }
+    inFrame = false;
+}
@@ -1,5 +1,7 @@
 #include "../include/ImGuiManager.h"
+#include "../include/AllocTracker.h"
 #include "../include/Logger.h"
+#include "../include/Profiler.h"
 
 
 ImGuiManager::ImGuiManager(GLFWwindow* window) : window(window) {
@@ -39,10 +41,14 @@ void ImGuiManager::BeginFrame() {
 }
 
 void ImGuiManager::EndFrame() {
+    PROFILE_ZONE("imgui end frame");
+    ALLOC_SCOPE("imgui");
     ImGui::Render();
 }
 
 void ImGuiManager::Render() {
+    PROFILE_ZONE("imgui draw");
+    ALLOC_SCOPE("imgui");
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
@@ -0,0 +1,166 @@
+#include "../include/IslandGrid.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+// Inverted range marking a column without terrain, survives min/max reduction
+static const float EMPTY_MIN = 1000.0f;
+static const float EMPTY_MAX = -1000.0f;
+
+IslandGrid::IslandGrid() : pool(1, "island grid") {
+}
+
+// Distance from (x, z) to the nearest point of the chunk column
+static float DistanceToChunk(float x, float z, int chunkX, int chunkZ) {
+    float minX = chunkX * 16.0f, minZ = chunkZ * 16.0f;
+    float dx = x - std::clamp(x, minX, minX + 16.0f);
+    float dz = z - std::clamp(z, minZ, minZ + 16.0f);
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+// True if the disc intersects the 16x16 column of chunk (chunkX, chunkZ)
+static bool DiscTouchesChunk(float centerX, float centerZ, float radius, int chunkX, int chunkZ) {
+    return DistanceToChunk(centerX, centerZ, chunkX, chunkZ) <= radius;
+}
+
+void IslandGrid::Build(int centerX, int centerZ) {
+    PROFILE_ZONE("build island grid");
+    auto start = std::chrono::steady_clock::now();
+    int baseX = centerX - SIZE / 2;
+    int baseZ = centerZ - SIZE / 2;
+
+    // Level 0, (yMin, yMax) per cell
+    pending.assign(LEVELS, std::vector<float>());
+    std::vector<float>& cells = pending[0];
+    cells.resize(SIZE * SIZE * 2);
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        cells[i * 2] = EMPTY_MIN;
+        cells[i * 2 + 1] = EMPTY_MAX;
+    }
+    auto include = [&](int cellX, int cellZ, float lo, float hi) {
+        if (cellX < 0 || cellZ < 0 || cellX >= SIZE || cellZ >= SIZE) return;
+        int index = cellZ * SIZE + cellX;
+        cells[index * 2] = std::min(cells[index * 2], std::max(std::floor(lo), EndTerrain::MIN_Y));
+        cells[index * 2 + 1] = std::max(cells[index * 2 + 1], std::min(std::ceil(hi), EndTerrain::MAX_Y));
+    };
+
+    // Outer islands reach at most one chunk beyond their own (3x3 lookup in
+    // OuterIslandDensity), so chunks just outside the grid still matter
+    for (int z = -1; z <= SIZE; z++) {
+        for (int x = -1; x <= SIZE; x++) {
+            EndTerrain::Island island;
+            if (!terrain.IslandForChunk(baseX + x, baseZ + z, island)) continue;
+            float low, high;
+            terrain.IslandHeightRange(island, low, high);
+            for (int dz = -1; dz <= 1; dz++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (!DiscTouchesChunk(island.centerX, island.centerZ, island.radius,
+                                          baseX + x + dx, baseZ + z + dz)) continue;
+                    include(x + dx, z + dz, low, high);
+                }
+            }
+        }
+    }
+
+    // Main island, solid from the floor up to its radial height profile
+    // taken at the column's point nearest the centre
+    int mainChunks = static_cast<int>(std::ceil(EndTerrain::MAIN_ISLAND_RADIUS / 16.0f));
+    for (int chunkZ = -mainChunks - 1; chunkZ <= mainChunks; chunkZ++) {
+        for (int chunkX = -mainChunks - 1; chunkX <= mainChunks; chunkX++) {
+            float nearest = DistanceToChunk(0.0f, 0.0f, chunkX, chunkZ);
+            if (nearest > EndTerrain::MAIN_ISLAND_RADIUS) continue;
+            include(chunkX - baseX, chunkZ - baseZ, EndTerrain::MIN_Y, terrain.MainIslandMaxY(nearest));
+        }
+    }
+
+    // Each coarser level is the union of its 2x2 children
+    for (int level = 1; level < LEVELS; level++) {
+        const std::vector<float>& fine = pending[level - 1];
+        std::vector<float>& coarse = pending[level];
+        int fineSize = SIZE >> (level - 1);
+        int coarseSize = SIZE >> level;
+        coarse.resize(coarseSize * coarseSize * 2);
+        for (int z = 0; z < coarseSize; z++) {
+            for (int x = 0; x < coarseSize; x++) {
+                float lo = EMPTY_MIN, hi = EMPTY_MAX;
+                for (int child = 0; child < 4; child++) {
+                    int index = (z * 2 + (child >> 1)) * fineSize + x * 2 + (child & 1);
+                    lo = std::min(lo, fine[index * 2]);
+                    hi = std::max(hi, fine[index * 2 + 1]);
+                }
+                coarse[(z * coarseSize + x) * 2] = lo;
+                coarse[(z * coarseSize + x) * 2 + 1] = hi;
+            }
+        }
+    }
+
+    pendingX = baseX;
+    pendingZ = baseZ;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFOF("Built island grid around chunk ({}, {}) in {:.1f} ms", centerX, centerZ, ms);
+    ready.store(true, std::memory_order_release);
+}
+
+void IslandGrid::Upload() {
+    if (texture == 0) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        for (int level = 0; level < LEVELS; level++) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RG16F, SIZE >> level, SIZE >> level, 0, GL_RG, GL_FLOAT, nullptr);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, LEVELS - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (int level = 0; level < LEVELS; level++) {
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, SIZE >> level, SIZE >> level, GL_RG, GL_FLOAT, pending[level].data());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    originX = pendingX;
+    originZ = pendingZ;
+    valid = true;
+}
+
+void IslandGrid::Update(int cameraChunkX, int cameraChunkZ) {
+    if (building && ready.load(std::memory_order_acquire)) {
+        Upload();
+        ready.store(false, std::memory_order_relaxed);
+        building = false;
+    }
+    if (building) {
+        return;
+    }
+
+    bool drifted = std::max(std::abs(cameraChunkX - requestedX), std::abs(cameraChunkZ - requestedZ)) > SIZE / 4;
+    if (valid && !drifted) {
+        return;
+    }
+    requestedX = cameraChunkX;
+    requestedZ = cameraChunkZ;
+    building = true;
+    pool.Submit([this, cameraChunkX, cameraChunkZ]() { Build(cameraChunkX, cameraChunkZ); });
+}
+
+void IslandGrid::Bind(GLuint unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void IslandGrid::Delete() {
+    pool.WaitIdle();
+    if (texture != 0) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    valid = false;
+    building = false;
+    ready.store(false, std::memory_order_relaxed);
+}
@@ -0,0 +1,149 @@
+#include "../include/LogArgs.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace LogArgs {
+
+// printf conversion for a user spec such as "5", ".2f" or "08x". The spec's
+// conversion character is kept only if it is one of `allowed`, otherwise (or
+// for a width-only spec) `fallback` is used; `length` goes in front of it.
+// Flags, width and precision pass through, anything else is dropped.
+static std::string conversionFor(const std::string& spec, const char* allowed, char fallback, const char* length) {
+    std::string prefix = spec;
+    char type = fallback;
+    if (!prefix.empty() && std::isalpha(static_cast<unsigned char>(prefix.back()))) {
+        if (std::strchr(allowed, prefix.back()) != nullptr) {
+            type = prefix.back();
+        }
+        prefix.pop_back();
+    }
+    if (prefix.find_first_not_of("-+ #0123456789.") != std::string::npos) {
+        prefix.clear();
+    }
+    return "%" + prefix + length + type;
+}
+
+// Reads one packed argument and appends it to out using the optional printf spec
+static bool appendArgument(const std::string& packed, size_t& offset, const std::string& spec, std::string& out) {
+    if (offset >= packed.size()) {
+        return false;
+    }
+
+    auto read = [&](void* value, size_t size) {
+        if (offset + size > packed.size()) {
+            return false;
+        }
+        std::memcpy(value, packed.data() + offset, size);
+        offset += size;
+        return true;
+    };
+
+    Tag tag = static_cast<Tag>(packed[offset++]);
+    char buffer[64];
+    std::string conversion;
+
+    switch (tag) {
+        case BOOL: {
+            uint8_t value;
+            if (!read(&value, sizeof(value))) return false;
+            out += value ? "true" : "false";
+            return true;
+        }
+        case CHAR: {
+            char value;
+            if (!read(&value, sizeof(value))) return false;
+            out += value;
+            return true;
+        }
+        case INT:
+        case UINT:
+        case POINTER: {
+            uint64_t bits = 0;
+            for (int shift = 0;; shift += 7) {
+                if (offset >= packed.size() || shift > 63) return false;
+                uint8_t byte = static_cast<uint8_t>(packed[offset++]);
+                bits |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) break;
+            }
+            if (tag == INT) {
+                bits = (bits >> 1) ^ (~(bits & 1) + 1);   // zigzag decode
+            }
+            // Integer conversions need the long long length modifier
+            conversion = conversionFor(spec, "diuxXo", tag == INT ? 'd' : tag == UINT ? 'u' : 'x', "ll");
+            if (tag == POINTER && spec.empty()) {
+                out += "0x";
+            }
+            if (tag == INT) {
+                std::snprintf(buffer, sizeof(buffer), conversion.c_str(), static_cast<long long>(bits));
+            } else {
+                std::snprintf(buffer, sizeof(buffer), conversion.c_str(), static_cast<unsigned long long>(bits));
+            }
+            out += buffer;
+            return true;
+        }
+        case DOUBLE: {
+            double value;
+            if (!read(&value, sizeof(value))) return false;
+            conversion = conversionFor(spec, "fFeEgGaA", 'g', "");
+            std::snprintf(buffer, sizeof(buffer), conversion.c_str(), value);
+            out += buffer;
+            return true;
+        }
+        case STRING: {
+            uint32_t length;
+            if (!read(&length, sizeof(length)) || offset + length > packed.size()) return false;
+            if (spec.empty()) {
+                out.append(packed, offset, length);
+            } else {
+                // Padded or truncated, sized for long strings rather than into buffer
+                std::string value(packed, offset, length);
+                conversion = conversionFor(spec, "s", 's', "");
+                int size = std::snprintf(nullptr, 0, conversion.c_str(), value.c_str());
+                if (size > 0) {
+                    size_t start = out.size();
+                    out.resize(start + size + 1);
+                    std::snprintf(&out[start], size + 1, conversion.c_str(), value.c_str());
+                    out.resize(start + size);
+                }
+            }
+            offset += length;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Format(const char* format, const std::string& packed, std::string& out) {
+    out.clear();
+    size_t offset = 0;
+    std::string spec;
+
+    for (const char* c = format; *c != '\0'; c++) {
+        if (c[0] == '{' && c[1] == '{') {
+            out += '{';
+            c++;
+        } else if (c[0] == '}' && c[1] == '}') {
+            out += '}';
+            c++;
+        } else if (c[0] == '{') {
+            const char* close = std::strchr(c, '}');
+            if (close == nullptr) {
+                out += c;
+                break;
+            }
+            spec.assign(c + 1, close);
+            if (!spec.empty() && spec[0] == ':') {
+                spec.erase(0, 1);
+            }
+            if (!appendArgument(packed, offset, spec, out)) {
+                out += "{?}";
+            }
+            c = close;
+        } else {
+            out += *c;
+        }
+    }
+}
+
+}
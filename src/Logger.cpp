@@ -1,35 +1,79 @@
 #include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
 #include "GL/gl.h"
 
 // Initialize the static instance pointer
 Logger* Logger::instance = nullptr;
 
+// Records written between flushes / rotation checks
+static const int WRITER_BATCH_SIZE = 1024;
+
+std::string getShortFilePath(const std::string& basePath, const std::string& filePath);
+
+static int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 Logger::Logger() :
+    basePath(""),
+    fileFormat(FileFormat::TEXT),
     initialized(false),
+    maxSegmentBytes(16ull << 20),
+    maxSegmentAgeNs(24ll * 3600 * 1000000000),
+    maxRetainedFiles(20),
+    segmentBytes(0),
+    segmentStartNs(0),
+    segmentIndex(0),
     currentLevel(LogLevel::INFO),
     showTimestamps(true),
     showSourceInfo(true),
     useColors(true),
-    basePath("") {
+    queueCapacity(8192),
+    overflowPolicy(OverflowPolicy::DROP),
+    writerRunning(false),
+    writerStopping(false),
+    writerSleeping(false),
+    writtenCount(0),
+    droppedCount(0),
+    currentSecond(0),
+    rateLimit(50),
+    suppressedSites(nullptr),
+    timestampSecond(-1),
+    startNs(steadyNowNs()),
+    deduplicate(true) {
+    // Records carry monotonic timestamps, the wall clock is only needed for display
+    int64_t wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    wallClockOffsetNs = wallNs - steadyNowNs();
 }
 
 Logger::~Logger() {
+    shutdown();
     if (logFile.is_open()) {
         logFile.close();
     }
+    binaryLog.Close();
 }
 
 Logger* Logger::getInstance() {
-    if (instance == nullptr) {
-        instance = new Logger();
-    }
-    return instance;
+    // Function-local static so concurrent first calls are safe
+    static Logger* created = (instance = new Logger());
+    return created;
 }
 
 bool Logger::init() {
+    std::lock_guard<std::mutex> lock(initMutex);
     if (initialized) {
         return true;
     }
@@ -41,13 +85,32 @@ bool Logger::init() {
     logFileName = createLogFileName();
 
     // Open log file
-    logFile.open("logs/" + logFileName + ".log", std::ios::out);
-
-    if (!logFile.is_open()) {
-        std::cerr << "Failed to open log file: logs/" << logFileName << ".log" << std::endl;
+    binaryLog.fileDisplayName = [this](const char* file) { return getShortFilePath(basePath, file); };
+    if (!openLogFile()) {
         return false;
     }
 
+    // Compress segments left behind by earlier runs and apply the retention cap
+    compressor = std::make_unique<ThreadPool>(1, "log compressor");
+    std::string activePath = logFilePath;
+    int retained = maxRetainedFiles;
+    compressor->Submit([activePath, retained] {
+        std::error_code ec;
+        std::vector<std::string> leftovers;
+        for (const auto& entry : std::filesystem::directory_iterator("logs", ec)) {
+            std::string path = entry.path().string();
+            std::string extension = entry.path().extension().string();
+            if (path != activePath && (extension == ".log" || extension == ".blog") &&
+                entry.path().filename().string().find("_|_") != std::string::npos) {
+                leftovers.push_back(path);
+            }
+        }
+        for (const std::string& path : leftovers) {
+            compressLogFile(path);
+        }
+        enforceRetention(retained, activePath);
+    });
+
     // Try to auto-detect base path from executable location or current working directory
     if (basePath.empty()) {
         // Get current working directory as fallback
@@ -63,6 +126,13 @@ bool Logger::init() {
         }
     }
 
+    // Start the writer thread; the singleton is never destroyed, so drain it at exit
+    queue = std::make_unique<MpscQueue<LogRecord>>(queueCapacity);
+    writerStopping = false;
+    writerRunning = true;
+    writerThread = std::thread(&Logger::writerLoop, this);
+    std::atexit([] { Logger::getInstance()->shutdown(); });
+
     initialized = true;
 
     // Log initial message
@@ -71,6 +141,301 @@ bool Logger::init() {
     return true;
 }
 
+void Logger::setFileFormat(FileFormat format) {
+    fileFormat = format;
+}
+
+void Logger::setRotation(uint64_t maxBytes, int maxAgeSeconds, int maxFiles) {
+    maxSegmentBytes = maxBytes;
+    maxSegmentAgeNs = static_cast<int64_t>(maxAgeSeconds) * 1000000000;
+    maxRetainedFiles = maxFiles;
+}
+
+bool Logger::openLogFile() {
+    logFilePath = "logs/" + logFileName + (fileFormat == FileFormat::BINARY ? ".blog" : ".log");
+    segmentBytes = 0;
+    segmentStartNs = steadyNowNs();
+
+    bool opened;
+    if (fileFormat == FileFormat::BINARY) {
+        opened = binaryLog.Open(logFilePath, wallClockOffsetNs, segmentStartNs);
+    } else {
+        logFile.open(logFilePath, std::ios::out);
+        opened = logFile.is_open();
+    }
+
+    if (!opened) {
+        std::cerr << "Failed to open log file: " << logFilePath << std::endl;
+    }
+    return opened;
+}
+
+void Logger::rotateLogFile() {
+    std::string closedPath = logFilePath;
+    if (logFile.is_open()) {
+        logFile.close();
+    }
+    binaryLog.Close();
+
+    // A failed open keeps logging to the console and retries after the next interval
+    segmentIndex++;
+    logFileName = createLogFileName() + "_" + std::to_string(segmentIndex);
+    openLogFile();
+
+    std::string activePath = logFilePath;
+    int retained = maxRetainedFiles;
+    compressor->Submit([closedPath, activePath, retained] {
+        compressLogFile(closedPath);
+        enforceRetention(retained, activePath);
+    });
+}
+
+// Log segments are the files named by createLogFileName(); returns the name
+// without its extension, shared by a segment's .log/.blog and their .gz
+static bool logSegmentBase(const std::filesystem::path& path, std::string& base) {
+    std::string name = path.filename().string();
+    if (name.find("_|_") == std::string::npos) {
+        return false;
+    }
+    for (const char* suffix : {".log", ".blog", ".log.gz", ".blog.gz"}) {
+        size_t length = std::char_traits<char>::length(suffix);
+        if (name.size() > length && name.compare(name.size() - length, length, suffix) == 0) {
+            base = name.substr(0, name.size() - length);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Logger::compressLogFile(const std::string& path) {
+    FILE* in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        return;
+    }
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(path, ec);
+
+    // Write next to the segment first so an interrupted compression never replaces it
+    std::string tempPath = path + ".gz.tmp";
+    gzFile out = gzopen(tempPath.c_str(), "wb6");
+    if (out == nullptr) {
+        std::fclose(in);
+        return;
+    }
+
+    std::vector<char> buffer(1 << 16);
+    bool ok = true;
+    size_t count;
+    while ((count = std::fread(buffer.data(), 1, buffer.size(), in)) > 0) {
+        if (gzwrite(out, buffer.data(), static_cast<unsigned>(count)) != static_cast<int>(count)) {
+            ok = false;
+            break;
+        }
+    }
+    std::fclose(in);
+    ok = gzclose(out) == Z_OK && ok;
+
+    if (ok) {
+        // Keep the segment's own time so retention still orders it by age
+        std::filesystem::last_write_time(tempPath, writeTime, ec);
+        std::filesystem::rename(tempPath, path + ".gz", ec);
+        if (!ec) {
+            std::filesystem::remove(path, ec);
+        }
+    } else {
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+void Logger::enforceRetention(int maxFiles, const std::string& activePath) {
+    if (maxFiles <= 0) {
+        return;
+    }
+
+    // Group the files of each segment, its newest file dates it
+    struct Segment {
+        std::filesystem::file_time_type time;
+        std::vector<std::filesystem::path> files;
+    };
+    std::string activeBase;
+    logSegmentBase(activePath, activeBase);
+    std::error_code ec;
+    std::unordered_map<std::string, Segment> segments;
+    for (const auto& entry : std::filesystem::directory_iterator("logs", ec)) {
+        std::string base;
+        if (!entry.is_regular_file(ec) || !logSegmentBase(entry.path(), base) || base == activeBase) {
+            continue;
+        }
+        Segment& segment = segments[base];
+        auto time = entry.last_write_time(ec);
+        if (segment.files.empty() || time > segment.time) {
+            segment.time = time;
+        }
+        segment.files.push_back(entry.path());
+    }
+
+    // The active segment is never removed and takes one of the retained slots
+    if (static_cast<int>(segments.size()) <= maxFiles - 1) {
+        return;
+    }
+    std::vector<const Segment*> oldestFirst;
+    for (const auto& entry : segments) {
+        oldestFirst.push_back(&entry.second);
+    }
+    std::sort(oldestFirst.begin(), oldestFirst.end(),
+              [](const Segment* a, const Segment* b) { return a->time < b->time; });
+    size_t removeCount = segments.size() - (maxFiles - 1);
+    for (size_t i = 0; i < removeCount; i++) {
+        for (const auto& path : oldestFirst[i]->files) {
+            std::filesystem::remove(path, ec);
+        }
+    }
+}
+
+void Logger::setQueueCapacity(size_t capacity) {
+    queueCapacity = capacity;
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    overflowPolicy = policy;
+}
+
+void Logger::setRateLimit(uint32_t messagesPerSecond) {
+    rateLimit = messagesPerSecond;
+}
+
+void Logger::enableDeduplication(bool enable) {
+    deduplicate = enable;
+}
+
+void Logger::registerSuppressed(LogSite& site) {
+    if (site.registered.exchange(true)) {
+        return;
+    }
+    LogSite* head = suppressedSites.load();
+    do {
+        site.next = head;
+    } while (!suppressedSites.compare_exchange_weak(head, &site));
+}
+
+void Logger::wakeWriter() {
+    if (writerSleeping.load()) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    Profiler::SetThreadName("log writer");
+    ALLOC_SCOPE("logging");
+    uint64_t reportedDrops = 0;
+
+    for (;;) {
+        // Bounded batches so flushing and rotation keep up with a busy queue
+        bool wrote = false;
+        for (int i = 0; i < WRITER_BATCH_SIZE; i++) {
+            if (!queue->TryPop([this](LogRecord& record) { writeRecord(record); })) {
+                break;
+            }
+            wrote = true;
+        }
+
+        // Advance the coarse clock used by the rate limiter, summarising once a second
+        int64_t now = steadyNowNs();
+        uint32_t second = static_cast<uint32_t>((now - startNs) / 1000000000);
+        if (second != currentSecond.load()) {
+            currentSecond = second;
+            writeSummaries(now);
+            wrote = true;
+        }
+
+        uint64_t dropped = droppedCount.load();
+        if (dropped != reportedDrops) {
+            LogRecord note{LogLevel::WARNING, nullptr, 0, steadyNowNs(), nullptr, std::to_string(dropped - reportedDrops) + " log messages dropped (queue full)"};
+            writeLine(note);
+            reportedDrops = dropped;
+            wrote = true;
+        }
+
+        if (wrote) {
+            flushStreams();
+        }
+
+        uint64_t bytes = fileFormat == FileFormat::BINARY ? binaryLog.GetBytesWritten() : segmentBytes;
+        if ((maxSegmentBytes > 0 && bytes >= maxSegmentBytes) ||
+            (maxSegmentAgeNs > 0 && now - segmentStartNs >= maxSegmentAgeNs)) {
+            rotateLogFile();
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writtenCount = queue->PopCount();
+        flushCondition.notify_all();
+
+        if (!queue->Empty()) {
+            continue;
+        }
+        if (writerStopping) {
+            break;
+        }
+
+        // Producers only pay for a notify while we are asleep; the timeout
+        // covers a push racing with going to sleep
+        writerSleeping = true;
+        if (queue->Empty() && !writerStopping) {
+            wakeCondition.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        writerSleeping = false;
+    }
+}
+
+void Logger::flush() {
+    if (!writerRunning) {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        flushStreams();
+        return;
+    }
+
+    size_t target = queue->PushCount();
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wakeCondition.notify_one();
+    }
+
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (writtenCount.load() < target && writerRunning) {
+        flushCondition.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void Logger::shutdown() {
+    if (!writerRunning) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        writerStopping = true;
+        wakeCondition.notify_all();
+    }
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    writerRunning = false;
+
+    // Anything pushed while the writer was exiting
+    std::lock_guard<std::mutex> lock(syncMutex);
+    while (queue->TryPop([this](LogRecord& record) { writeRecord(record); })) {
+    }
+    writeSummaries(steadyNowNs());
+    flushStreams();
+
+    // Let a running compression finish so no .gz.tmp is left behind
+    if (compressor) {
+        compressor->WaitIdle();
+        compressor->Shutdown();
+    }
+}
+
 std::string Logger::createLogFileName() {
     std::time_t now = std::time(nullptr);
     std::tm* localTime = std::localtime(&now);
@@ -86,23 +451,30 @@ std::string Logger::createLogFileName() {
     return ss.str();
 }
 
-std::string Logger::getCurrentTimestamp() {
-    std::time_t now = std::time(nullptr);
-    std::tm* localTime = std::localtime(&now);
-
-    std::stringstream ss;
-    ss << std::setfill('0')
-       << "["
-       << std::setw(2) << localTime->tm_hour << ":"
-       << std::setw(2) << localTime->tm_min << ":"
-       << std::setw(2) << localTime->tm_sec
-       << "]";
-
-    return ss.str();
+const std::string& Logger::formatTimestamp(int64_t timeNs) {
+    // Only reformat when the second changes
+    int64_t second = (timeNs + wallClockOffsetNs) / 1000000000;
+    if (second == timestampSecond) {
+        return timestampText;
+    }
+    timestampSecond = second;
+
+    std::time_t time = static_cast<std::time_t>(second);
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &time);
+#else
+    localtime_r(&time, &localTime);
+#endif
+
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "[%02d:%02d:%02d]", localTime.tm_hour, localTime.tm_min, localTime.tm_sec);
+    timestampText = buffer;
+    return timestampText;
 }
 
-std::string Logger::getLogLevelString(LogLevel level) {
-    if (!useColors) {
+const char* Logger::getLogLevelString(LogLevel level, bool colored) {
+    if (!colored) {
         switch (level) {
             case LogLevel::DEBUG:   return "[DEBUG]  ";
             case LogLevel::INFO:    return "[INFO]   ";
@@ -177,94 +549,192 @@ std::string getShortFilePath(const std::string& basePath, const std::string& fil
     return filePath;
 }
 
-void Logger::logInternal(LogLevel level, const std::string& message, const char* file, int line) {
+void Logger::logInternal(LogLevel level, const std::string& message, const char* file, int line, const char* format) {
     if (!initialized && !init()) {
         std::cerr << "Logger not initialized!" << std::endl;
         return;
     }
 
-    // For the console (potentially with colors)
-    std::stringstream consoleMessage;
-    // For the file (always without colors)
-    std::stringstream fileMessage;
+    int64_t timeNs = steadyNowNs();
+
+    auto fill = [&](LogRecord& record) {
+        record.level = level;
+        record.file = file;
+        record.line = line;
+        record.timeNs = timeNs;
+        record.format = format;
+        record.message.assign(message);
+    };
+
+    while (writerRunning) {
+        if (queue->TryPush(fill)) {
+            wakeWriter();
+            // Make sure a fatal message is on disk before the caller goes down
+            if (level == LogLevel::FATAL) {
+                flush();
+            }
+            return;
+        }
+
+        if (overflowPolicy == OverflowPolicy::DROP && level != LogLevel::FATAL) {
+            droppedCount++;
+            return;
+        }
+        wakeWriter();
+        std::this_thread::yield();
+    }
+
+    // No writer thread (shut down): write synchronously
+    std::lock_guard<std::mutex> lock(syncMutex);
+    LogRecord record;
+    fill(record);
+    writeRecord(record);
+    flushStreams();
+}
+
+void Logger::writeRecord(const LogRecord& record) {
+    if (deduplicate && record.file != nullptr) {
+        auto site = std::make_pair(record.file, record.line);
+        auto it = lastMessages.find(site);
+        if (it != lastMessages.end()) {
+            RepeatState& last = it->second;
+            if (last.level == record.level && last.format == record.format && last.message == record.message) {
+                last.repeats++;
+                return;
+            }
+            if (last.repeats > 0) {
+                writeLine({last.level, record.file, record.line, record.timeNs, nullptr,
+                           "Last message repeated " + std::to_string(last.repeats) + " times"});
+            }
+            last.level = record.level;
+            last.format = record.format;
+            last.message = record.message;
+            last.repeats = 0;
+        } else {
+            lastMessages.emplace(site, RepeatState{record.level, record.format, record.message, 0});
+        }
+    }
+    writeLine(record);
+}
+
+void Logger::writeSummaries(int64_t timeNs) {
+    for (auto& entry : lastMessages) {
+        RepeatState& last = entry.second;
+        if (last.repeats > 0) {
+            writeLine({last.level, entry.first.first, entry.first.second, timeNs, nullptr,
+                       "Last message repeated " + std::to_string(last.repeats) + " times"});
+            last.repeats = 0;
+        }
+    }
+
+    for (LogSite* site = suppressedSites.load(); site != nullptr; site = site->next) {
+        uint32_t suppressed = site->suppressed.exchange(0);
+        if (suppressed > 0) {
+            writeLine({LogLevel::WARNING, site->file, site->line, timeNs, nullptr,
+                       std::to_string(suppressed) + " messages suppressed by the rate limit (" +
+                       std::to_string(rateLimit.load()) + " per second)"});
+        }
+    }
+}
+
+void Logger::writeLine(const LogRecord& record) {
+    bool colored = useColors;
+    consoleLine.clear();
+    fileLine.clear();
 
     // Add timestamp if enabled
     if (showTimestamps) {
-        std::string timestamp = getCurrentTimestamp();
-        consoleMessage << (useColors ? "\033[90m" + timestamp + "\033[0m " : timestamp + " "); // Gray color for timestamp
-        fileMessage << timestamp << " ";
+        const std::string& timestamp = formatTimestamp(record.timeNs);
+        if (colored) {
+            consoleLine.append("\033[90m").append(timestamp).append("\033[0m "); // Gray color for timestamp
+        } else {
+            consoleLine.append(timestamp).append(" ");
+        }
+        fileLine.append(timestamp).append(" ");
     }
 
-    // Add log level (color handled inside getLogLevelString)
-    consoleMessage << getLogLevelString(level) << " ";
-    // For file, always use non-colored version
-    switch (level) {
-        case LogLevel::DEBUG:   fileMessage << "[DEBUG]  "; break;
-        case LogLevel::INFO:    fileMessage << "[INFO]   "; break;
-        case LogLevel::WARNING: fileMessage << "[WARNING]"; break;
-        case LogLevel::ERROR:   fileMessage << "[ERROR]  "; break;
-        case LogLevel::FATAL:   fileMessage << "[FATAL]  "; break;
-        case LogLevel::TODO:    fileMessage << "[TODO]   "; break;
-        default:                fileMessage << "[UNKNOWN]"; break;
-    }
-    fileMessage << " ";
+    // Add log level, the file always gets the non-colored version
+    consoleLine.append(getLogLevelString(record.level, colored)).append(" ");
+    fileLine.append(getLogLevelString(record.level, false)).append(" ");
 
     // Add source information if enabled and provided
-    if (showSourceInfo && file != nullptr) {
-        // Get shorter file path
-        std::string shortFilePath = getShortFilePath(basePath, file);
-        std::string sourceInfo = "(" + shortFilePath + ":" + std::to_string(line) + ") ";
-
-        consoleMessage << (useColors ? "\033[90m" + sourceInfo + "\033[0m" : sourceInfo); // Gray for source info
-        fileMessage << sourceInfo;
+    if (showSourceInfo && record.file != nullptr) {
+        std::string sourceInfo = "(" + getShortFilePath(basePath, record.file) + ":" + std::to_string(record.line) + ") ";
+        if (colored) {
+            consoleLine.append("\033[90m").append(sourceInfo).append("\033[0m"); // Gray for source info
+        } else {
+            consoleLine.append(sourceInfo);
+        }
+        fileLine.append(sourceInfo);
     }
 
-    // Add the actual message
-    consoleMessage << message;
-    fileMessage << message;
+    // Add the actual message, expanding deferred arguments here on the writer side
+    const std::string* message = &record.message;
+    if (record.format != nullptr) {
+        LogArgs::Format(record.format, record.message, formattedMessage);
+        message = &formattedMessage;
+    }
+    consoleLine.append(*message).append("\n");
+    fileLine.append(*message).append("\n");
 
-    // Write to console with potential colors
-    std::cout << consoleMessage.str() << std::endl;
+    // Streams are flushed once per batch by flushStreams()
+    std::cout.write(consoleLine.data(), static_cast<std::streamsize>(consoleLine.size()));
+    if (logFile.is_open()) {
+        logFile.write(fileLine.data(), static_cast<std::streamsize>(fileLine.size()));
+        segmentBytes += fileLine.size();
+    }
+    if (binaryLog.IsOpen()) {
+        binaryLog.Write(static_cast<uint8_t>(record.level), record.file, record.line,
+                        record.format, record.message, record.timeNs);
+    }
+}
 
-    // Write to file (without color codes)
+void Logger::flushStreams() {
+    std::cout.flush();
     if (logFile.is_open()) {
-        logFile << fileMessage.str() << std::endl;
-        logFile.flush(); // Ensure it's written immediately
+        logFile.flush();
+    }
+    binaryLog.Flush();
+}
+
+void Logger::log(LogLevel level, const std::string& message, const char* file, int line) {
+    if (isEnabled(level)) {
+        logInternal(level, message, file, line);
     }
 }
 
 void Logger::debug(const std::string& message, const char* file, int line) {
-    if (static_cast<int>(currentLevel) <= static_cast<int>(LogLevel::DEBUG)) {
+    if (static_cast<int>(currentLevel.load(std::memory_order_relaxed)) <= static_cast<int>(LogLevel::DEBUG)) {
         logInternal(LogLevel::DEBUG, message, file, line);
     }
 }
 
 void Logger::info(const std::string& message, const char* file, int line) {
-    if (static_cast<int>(currentLevel) <= static_cast<int>(LogLevel::INFO)) {
+    if (static_cast<int>(currentLevel.load(std::memory_order_relaxed)) <= static_cast<int>(LogLevel::INFO)) {
         logInternal(LogLevel::INFO, message, file, line);
     }
 }
 
 void Logger::warning(const std::string& message, const char* file, int line) {
-    if (static_cast<int>(currentLevel) <= static_cast<int>(LogLevel::WARNING)) {
+    if (static_cast<int>(currentLevel.load(std::memory_order_relaxed)) <= static_cast<int>(LogLevel::WARNING)) {
         logInternal(LogLevel::WARNING, message, file, line);
     }
 }
 
 void Logger::error(const std::string& message, const char* file, int line) {
-    if (static_cast<int>(currentLevel) <= static_cast<int>(LogLevel::ERROR)) {
+    if (static_cast<int>(currentLevel.load(std::memory_order_relaxed)) <= static_cast<int>(LogLevel::ERROR)) {
         logInternal(LogLevel::ERROR, message, file, line);
     }
 }
 
 void Logger::fatal(const std::string& message, const char* file, int line) {
-    if (static_cast<int>(currentLevel) <= static_cast<int>(LogLevel::FATAL)) {
+    if (static_cast<int>(currentLevel.load(std::memory_order_relaxed)) <= static_cast<int>(LogLevel::FATAL)) {
         logInternal(LogLevel::FATAL, message, file, line);
     }
 }
 
 void Logger::todo(const std::string& message, const char* file, int line) {
-    if (static_cast<int>(currentLevel) <= static_cast<int>(LogLevel::TODO)) {
+    if (static_cast<int>(currentLevel.load(std::memory_order_relaxed)) <= static_cast<int>(LogLevel::TODO)) {
         logInternal(LogLevel::TODO, message, file, line);
     }
 }
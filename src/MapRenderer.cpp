@@ -0,0 +1,194 @@
+#include "../include/MapRenderer.h"
+#include "../include/AllocTracker.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include "imGUI1/imgui.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Unit quad, two triangles
+static GLfloat quadVertices[] = {
+    0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,
+    0.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f
+};
+
+// Missing tiles fall back to at most this many coarser levels
+static const int MAX_FALLBACK_LEVELS = 3;
+
+static const float MIN_ZOOM = 1.0f / static_cast<float>(2 << MapTileCache::MAX_LEVEL);
+static const float MAX_ZOOM = 16.0f;
+
+static int floorDiv(int value, int divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+MapRenderer::MapRenderer(MapTileCache& cache) :
+    cache(cache),
+    shader("shaders/map_tile.vert", "shaders/map_tile.frag"),
+    vbo(quadVertices, sizeof(quadVertices)),
+    currentLevel(0),
+    visibleTiles(0),
+    dragging(false),
+    lastCursor(0.0f) {
+    vao.Bind();
+    vao.LinkAttrib(vbo, 0, 2, GL_FLOAT, 2 * sizeof(float), (void*)0);
+    vao.Unbind();
+}
+
+glm::vec2 MapRenderer::ScreenToBlock(Camera2D& camera, const glm::vec2& screenPos) {
+    glm::vec2 map = camera.ScreenToWorld(screenPos);
+    return glm::vec2(map.x, -map.y);
+}
+
+void MapRenderer::Inputs(GLFWwindow* window, Camera2D& camera, float deltaTime) {
+    PROFILE_ZONE("map input");
+    ImGuiIO& io = ImGui::GetIO();
+
+    // Keyboard panning, constant speed in screen space
+    if (!io.WantCaptureKeyboard) {
+        glm::vec2 move(0.0f);
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) move.y += 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) move.y -= 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) move.x -= 1.0f;
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) move.x += 1.0f;
+        camera.Translate(move * (panSpeed * deltaTime / camera.zoom));
+    }
+
+    double mouseX, mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+    glm::vec2 cursor(static_cast<float>(mouseX), static_cast<float>(mouseY));
+
+    if (io.WantCaptureMouse) {
+        dragging = false;
+        return;
+    }
+
+    // Left-drag panning
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+        if (dragging) {
+            glm::vec2 delta = cursor - lastCursor;
+            camera.Translate(glm::vec2(-delta.x, delta.y) / camera.zoom);
+        }
+        dragging = true;
+    } else {
+        dragging = false;
+    }
+    lastCursor = cursor;
+
+    // Wheel zoom, keeping the point under the cursor fixed
+    if (io.MouseWheel != 0.0f) {
+        glm::vec2 before = camera.ScreenToWorld(cursor);
+        float zoom = camera.zoom * std::pow(1.2f, io.MouseWheel);
+        camera.SetZoom(std::clamp(zoom, MIN_ZOOM, MAX_ZOOM));
+        glm::vec2 after = camera.ScreenToWorld(cursor);
+        camera.Translate(before - after);
+    }
+}
+
+void MapRenderer::Draw(Camera2D& camera) {
+    PROFILE_ZONE("map draw");
+    ALLOC_SCOPE("map tiles");
+    struct DrawItem {
+        GLuint texture;
+        int level;
+        int x;
+        int z;
+    };
+
+    // Pick the level whose texels are closest to one screen pixel
+    float blocksPerPixel = 1.0f / camera.zoom;
+    int level = static_cast<int>(std::floor(std::log2(std::max(blocksPerPixel, 1.0f))));
+    level = std::clamp(level, 0, MapTileCache::MAX_LEVEL);
+    currentLevel = level;
+
+    // Visible block range
+    glm::vec2 cornerA = ScreenToBlock(camera, glm::vec2(0.0f, 0.0f));
+    glm::vec2 cornerB = ScreenToBlock(camera, glm::vec2(static_cast<float>(camera.width), static_cast<float>(camera.height)));
+    glm::vec2 minBlock = glm::min(cornerA, cornerB);
+    glm::vec2 maxBlock = glm::max(cornerA, cornerB);
+    glm::vec2 center = (minBlock + maxBlock) * 0.5f;
+
+    float tileSize = MapTileCache::TileWorldSize(level);
+    int tileX0 = static_cast<int>(std::floor(minBlock.x / tileSize));
+    int tileX1 = static_cast<int>(std::floor(maxBlock.x / tileSize));
+    int tileZ0 = static_cast<int>(std::floor(minBlock.y / tileSize));
+    int tileZ1 = static_cast<int>(std::floor(maxBlock.y / tileSize));
+
+    std::vector<DrawItem> items;
+    visibleTiles = 0;
+
+    for (int tz = tileZ0; tz <= tileZ1; tz++) {
+        for (int tx = tileX0; tx <= tileX1; tx++) {
+            visibleTiles++;
+            float dx = (tx + 0.5f) * tileSize - center.x;
+            float dz = (tz + 0.5f) * tileSize - center.y;
+            float distance = std::sqrt(dx * dx + dz * dz);
+
+            GLuint texture = cache.Request(level, tx, tz, distance / tileSize);
+            if (texture != 0) {
+                items.push_back({texture, level, tx, tz});
+                continue;
+            }
+
+            // Not baked yet: show the nearest resident ancestor meanwhile
+            int maxFallback = std::min(level + MAX_FALLBACK_LEVELS, MapTileCache::MAX_LEVEL);
+            for (int parentLevel = level + 1; parentLevel <= maxFallback; parentLevel++) {
+                int scale = 1 << (parentLevel - level);
+                int px = floorDiv(tx, scale);
+                int pz = floorDiv(tz, scale);
+                float parentSize = MapTileCache::TileWorldSize(parentLevel);
+                GLuint parentTexture = cache.Request(parentLevel, px, pz, distance / parentSize);
+                if (parentTexture != 0) {
+                    items.push_back({parentTexture, parentLevel, px, pz});
+                    break;
+                }
+            }
+        }
+    }
+
+    // Coarse fallbacks first so finer tiles are drawn over them
+    std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.level != b.level) return a.level > b.level;
+        return a.texture < b.texture;
+    });
+    items.erase(std::unique(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
+        return a.texture == b.texture;
+    }), items.end());
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+
+    shader.Activate();
+    camera.SetMatrices(shader);
+    glUniform1i(glGetUniformLocation(shader.ID, "uTile"), 0);
+    glUniform1f(glGetUniformLocation(shader.ID, "uMaxY"), EndTerrain::MAX_Y);
+    glUniform3fv(glGetUniformLocation(shader.ID, "uEndStoneColor"), 1, &endStoneColor.x);
+    glUniform3fv(glGetUniformLocation(shader.ID, "uVoidColor"), 1, &voidColor.x);
+    GLint tileRectLoc = glGetUniformLocation(shader.ID, "uTileRect");
+    GLint blocksPerTexelLoc = glGetUniformLocation(shader.ID, "uBlocksPerTexel");
+
+    vao.Bind();
+    glActiveTexture(GL_TEXTURE0);
+    for (const DrawItem& item : items) {
+        float size = MapTileCache::TileWorldSize(item.level);
+        glUniform4f(tileRectLoc, item.x * size, item.z * size, size, 0.0f);
+        glUniform1f(blocksPerTexelLoc, static_cast<float>(1 << item.level));
+        glBindTexture(GL_TEXTURE_2D, item.texture);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+    vao.Unbind();
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    cache.Update();
+}
+
+void MapRenderer::Delete() {
+    vao.Delete();
+    vbo.Delete();
+    shader.Delete();
+}
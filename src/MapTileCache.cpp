@@ -0,0 +1,330 @@
+#include "../include/MapTileCache.h"
+#include "../include/AllocTracker.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <zlib.h>
+
+// Definition for std::min and std::clamp, which bind it to a reference
+const int MapTileCache::MAX_LEVEL;
+
+static const char TILE_MAGIC[4] = {'E', 'M', 'T', '1'};
+
+MapTileCache::MapTileCache(const EndTerrain& terrain, const std::string& cacheDir, int workerThreads) :
+    maxUploadsPerFrame(8),
+    residentSlack(64),
+    terrain(terrain),
+    cacheDir(cacheDir),
+    workers(workerThreads, "map tile worker"),
+    frame(0),
+    residentCount(0),
+    inFlightCount(0),
+    bakedCount(0),
+    loadedCount(0) {
+    maxInFlight = workers.GetThreadCount() * 2;
+    LOG_INFO("Map tile cache using " + std::to_string(workers.GetThreadCount()) + " worker threads");
+}
+
+MapTileCache::~MapTileCache() {
+    Shutdown();
+}
+
+uint64_t MapTileCache::MakeKey(int level, int tileX, int tileZ) {
+    return (static_cast<uint64_t>(level) << 60) |
+           ((static_cast<uint64_t>(tileX) & 0x3FFFFFFFull) << 30) |
+           (static_cast<uint64_t>(tileZ) & 0x3FFFFFFFull);
+}
+
+std::string MapTileCache::TilePath(int level, int tileX, int tileZ) const {
+    // Tiles depend on the noise octaves, so each setting gets its own pyramid
+    return cacheDir + "/o" + std::to_string(terrain.octaves) + "/" + std::to_string(level) + "/" +
+           std::to_string(tileX) + "_" + std::to_string(tileZ) + ".tile";
+}
+
+GLuint MapTileCache::Request(int level, int tileX, int tileZ, float priority) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint64_t key = MakeKey(level, tileX, tileZ);
+    auto it = tiles.find(key);
+    if (it == tiles.end()) {
+        Tile tile;
+        tile.level = level;
+        tile.x = tileX;
+        tile.z = tileZ;
+        tile.state = TileState::QUEUED;
+        tile.texture = 0;
+        tile.lastUsedFrame = frame;
+        tile.priority = priority;
+        tile.cancelled = false;
+        tiles.emplace(key, std::move(tile));
+        return 0;
+    }
+
+    Tile& tile = it->second;
+    tile.lastUsedFrame = frame;
+    tile.priority = priority;
+    tile.cancelled = false;
+    return tile.state == TileState::RESIDENT ? tile.texture : 0;
+}
+
+void MapTileCache::Update() {
+    PROFILE_ZONE("map tile update");
+    ALLOC_SCOPE("map tiles");
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::pair<float, uint64_t>> queued;
+    std::vector<std::pair<float, uint64_t>> ready;
+    std::vector<std::pair<uint64_t, uint64_t>> unused;
+
+    for (auto it = tiles.begin(); it != tiles.end();) {
+        Tile& tile = it->second;
+        bool used = tile.lastUsedFrame == frame;
+
+        switch (tile.state) {
+            case TileState::QUEUED:
+                if (!used) {
+                    it = tiles.erase(it);
+                    continue;
+                }
+                queued.emplace_back(tile.priority, it->first);
+                break;
+            case TileState::BAKING:
+                // Jobs that have not started yet skip the tile, running ones still persist it
+                tile.cancelled = !used;
+                break;
+            case TileState::READY:
+                if (!used) {
+                    it = tiles.erase(it);
+                    continue;
+                }
+                ready.emplace_back(tile.priority, it->first);
+                break;
+            case TileState::RESIDENT:
+                if (!used) {
+                    unused.emplace_back(tile.lastUsedFrame, it->first);
+                }
+                break;
+        }
+        ++it;
+    }
+
+    // Upload the most important finished tiles, spreading the rest over later frames
+    std::sort(ready.begin(), ready.end());
+    for (size_t i = 0; i < ready.size() && static_cast<int>(i) < maxUploadsPerFrame; i++) {
+        UploadTile(tiles[ready[i].second]);
+    }
+
+    // Dispatch bake jobs closest to the view center first
+    std::sort(queued.begin(), queued.end());
+    for (size_t i = 0; i < queued.size() && inFlightCount < maxInFlight; i++) {
+        uint64_t key = queued[i].second;
+        tiles[key].state = TileState::BAKING;
+        inFlightCount++;
+        workers.Submit([this, key] { ProcessTile(key); });
+    }
+
+    // Keep only the most recently used off-screen tiles resident
+    if (static_cast<int>(unused.size()) > residentSlack) {
+        std::sort(unused.begin(), unused.end());
+        size_t evictCount = unused.size() - residentSlack;
+        for (size_t i = 0; i < evictCount; i++) {
+            auto it = tiles.find(unused[i].second);
+            ReleaseTexture(it->second);
+            tiles.erase(it);
+        }
+    }
+
+    frame++;
+}
+
+void MapTileCache::UploadTile(Tile& tile) {
+    PROFILE_ZONE("tile upload");
+    if (!freeTextures.empty()) {
+        tile.texture = freeTextures.back();
+        freeTextures.pop_back();
+        glBindTexture(GL_TEXTURE_2D, tile.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TILE_SIZE, TILE_SIZE, GL_RG, GL_UNSIGNED_BYTE, tile.pixels.data());
+    } else {
+        glGenTextures(1, &tile.texture);
+        glBindTexture(GL_TEXTURE_2D, tile.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, TILE_SIZE, TILE_SIZE, 0, GL_RG, GL_UNSIGNED_BYTE, tile.pixels.data());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    tile.pixels.clear();
+    tile.pixels.shrink_to_fit();
+    tile.state = TileState::RESIDENT;
+    residentCount++;
+}
+
+void MapTileCache::ReleaseTexture(Tile& tile) {
+    if (tile.texture != 0) {
+        freeTextures.push_back(tile.texture);
+        tile.texture = 0;
+        residentCount--;
+    }
+}
+
+void MapTileCache::Shutdown() {
+    workers.Shutdown();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : tiles) {
+        ReleaseTexture(entry.second);
+    }
+    tiles.clear();
+    if (!freeTextures.empty()) {
+        glDeleteTextures(static_cast<GLsizei>(freeTextures.size()), freeTextures.data());
+        freeTextures.clear();
+    }
+    inFlightCount = 0;
+}
+
+// ============================================================================
+// WORKER SIDE
+// ============================================================================
+
+void MapTileCache::ProcessTile(uint64_t key) {
+    PROFILE_ZONE("map tile job");
+    ALLOC_SCOPE("map tiles");
+    int level, tileX, tileZ;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = tiles.find(key);
+        if (it == tiles.end() || it->second.cancelled) {
+            if (it != tiles.end()) {
+                tiles.erase(it);
+            }
+            inFlightCount--;
+            return;
+        }
+        level = it->second.level;
+        tileX = it->second.x;
+        tileZ = it->second.z;
+    }
+
+    std::vector<uint8_t> pixels;
+    std::string path = TilePath(level, tileX, tileZ);
+    if (LoadTile(path, pixels)) {
+        loadedCount++;
+    } else {
+        BakeTile(level, tileX, tileZ, pixels);
+        SaveTile(path, pixels);
+        bakedCount++;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    inFlightCount--;
+    auto it = tiles.find(key);
+    if (it != tiles.end() && it->second.state == TileState::BAKING) {
+        it->second.pixels = std::move(pixels);
+        it->second.state = TileState::READY;
+    }
+}
+
+void MapTileCache::BakeTile(int level, int tileX, int tileZ, std::vector<uint8_t>& pixels) const {
+    PROFILE_ZONE("bake tile");
+    const float blocksPerTexel = static_cast<float>(1 << level);
+    const float originX = tileX * TileWorldSize(level);
+    const float originZ = tileZ * TileWorldSize(level);
+
+    // Coarser levels take 2x2 columns per texel so small islands still show up as partial coverage
+    const int samples = level == 0 ? 1 : 2;
+    const float sampleStep = blocksPerTexel / samples;
+
+    pixels.resize(TILE_SIZE * TILE_SIZE * 2);
+    for (int pz = 0; pz < TILE_SIZE; pz++) {
+        for (int px = 0; px < TILE_SIZE; px++) {
+            float heightSum = 0.0f;
+            int solidCount = 0;
+
+            for (int sz = 0; sz < samples; sz++) {
+                for (int sx = 0; sx < samples; sx++) {
+                    float x = originX + px * blocksPerTexel + (sx + 0.5f) * sampleStep;
+                    float z = originZ + pz * blocksPerTexel + (sz + 0.5f) * sampleStep;
+                    EndTerrain::Column column = terrain.SampleColumn(x, z);
+                    if (column.solid) {
+                        heightSum += column.topY;
+                        solidCount++;
+                    }
+                }
+            }
+
+            float height = solidCount > 0 ? heightSum / solidCount : 0.0f;
+            float coverage = static_cast<float>(solidCount) / (samples * samples);
+
+            uint8_t* texel = &pixels[(pz * TILE_SIZE + px) * 2];
+            texel[0] = static_cast<uint8_t>(std::clamp(height / EndTerrain::MAX_Y, 0.0f, 1.0f) * 255.0f + 0.5f);
+            texel[1] = static_cast<uint8_t>(coverage * 255.0f + 0.5f);
+        }
+    }
+}
+
+bool MapTileCache::LoadTile(const std::string& path, std::vector<uint8_t>& pixels) const {
+    PROFILE_ZONE("load tile");
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t compressedSize = 0;
+    bool ok = std::fread(magic, 1, 4, file) == 4 &&
+              std::equal(magic, magic + 4, TILE_MAGIC) &&
+              std::fread(&compressedSize, sizeof(compressedSize), 1, file) == 1;
+
+    std::vector<uint8_t> compressed;
+    if (ok) {
+        compressed.resize(compressedSize);
+        ok = std::fread(compressed.data(), 1, compressedSize, file) == compressedSize;
+    }
+    std::fclose(file);
+
+    if (ok) {
+        pixels.resize(TILE_SIZE * TILE_SIZE * 2);
+        uLongf size = static_cast<uLongf>(pixels.size());
+        ok = uncompress(pixels.data(), &size, compressed.data(), compressedSize) == Z_OK &&
+             size == pixels.size();
+    }
+
+    if (!ok) {
+        LOG_WARNINGF("Corrupt map tile, rebaking: {}", path);
+    }
+    return ok;
+}
+
+void MapTileCache::SaveTile(const std::string& path, const std::vector<uint8_t>& pixels) const {
+    PROFILE_ZONE("save tile");
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(pixels.size()));
+    std::vector<uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, pixels.data(),
+                  static_cast<uLong>(pixels.size()), Z_BEST_SPEED) != Z_OK) {
+        return;
+    }
+
+    // Write to a temporary file first so an interrupted write never leaves a partial tile
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        return;
+    }
+    uint32_t size32 = static_cast<uint32_t>(compressedSize);
+    std::fwrite(TILE_MAGIC, 1, 4, file);
+    std::fwrite(&size32, sizeof(size32), 1, file);
+    std::fwrite(compressed.data(), 1, compressedSize, file);
+    std::fclose(file);
+
+    std::filesystem::rename(tempPath, path, ec);
+}
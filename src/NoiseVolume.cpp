@@ -0,0 +1,232 @@
+#include "../include/NoiseVolume.h"
+#include "../include/EndNoise.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+
+static const char VOLUME_MAGIC[4] = {'E', 'N', 'V', '2'};
+
+static inline float fract(float v) {
+    return v - std::floor(v);
+}
+
+static inline float wrap(float v, float period) {
+    float m = std::fmod(v, period);
+    return m < 0.0f ? m + period : m;
+}
+
+// Same gradient hash as EndNoise / end_raymarch.frag
+static inline void hash3(float x, float y, float z, float out[3]) {
+    float px = x * 127.1f + y * 311.7f + z * 74.7f;
+    float py = x * 269.5f + y * 183.3f + z * 246.1f;
+    float pz = x * 113.5f + y * 271.9f + z * 124.6f;
+    out[0] = -1.0f + 2.0f * fract(std::sin(px) * 43758.5453f);
+    out[1] = -1.0f + 2.0f * fract(std::sin(py) * 43758.5453f);
+    out[2] = -1.0f + 2.0f * fract(std::sin(pz) * 43758.5453f);
+}
+
+void NoiseVolume::Sample(float x, float y, float z, int period, float out[4]) {
+    float cx = std::floor(x), cy = std::floor(y), cz = std::floor(z);
+    float fx = x - cx, fy = y - cy, fz = z - cz;
+
+    // Quintic fade and its derivative
+    float ux = fx * fx * fx * (fx * (fx * 6.0f - 15.0f) + 10.0f);
+    float uy = fy * fy * fy * (fy * (fy * 6.0f - 15.0f) + 10.0f);
+    float uz = fz * fz * fz * (fz * (fz * 6.0f - 15.0f) + 10.0f);
+    float dux = 30.0f * fx * fx * (fx - 1.0f) * (fx - 1.0f);
+    float duy = 30.0f * fy * fy * (fy - 1.0f) * (fy - 1.0f);
+    float duz = 30.0f * fz * fz * (fz - 1.0f) * (fz - 1.0f);
+
+    float p = static_cast<float>(period);
+    out[0] = out[1] = out[2] = out[3] = 0.0f;
+    for (int corner = 0; corner < 8; corner++) {
+        int a = corner & 1, b = (corner >> 1) & 1, c = (corner >> 2) & 1;
+
+        // Wrapping the lattice makes the noise repeat every period cells
+        float g[3];
+        hash3(wrap(cx + a, p), wrap(cy + b, p), wrap(cz + c, p), g);
+        float dx = fx - a, dy = fy - b, dz = fz - c;
+        float d = g[0] * dx + g[1] * dy + g[2] * dz;
+
+        float wx = a ? ux : 1.0f - ux, dwx = a ? dux : -dux;
+        float wy = b ? uy : 1.0f - uy, dwy = b ? duy : -duy;
+        float wz = c ? uz : 1.0f - uz, dwz = c ? duz : -duz;
+        float w = wx * wy * wz;
+
+        out[0] += w * d;
+        out[1] += dwx * wy * wz * d + w * g[0];
+        out[2] += wx * dwy * wz * d + w * g[1];
+        out[3] += wx * wy * dwz * d + w * g[2];
+    }
+}
+
+std::string NoiseVolume::CachePath(const std::string& cacheDir) const {
+    return cacheDir + "/noise_" + std::to_string(size) + "_" + std::to_string(period) +
+           (gradients ? "_grad" : "") + ".bin";
+}
+
+void NoiseVolume::Initialize(const std::string& cacheDir) {
+    std::string path = CachePath(cacheDir);
+    std::vector<float> voxels;
+    if (!Load(path, voxels)) {
+        auto start = std::chrono::steady_clock::now();
+        Bake(voxels);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFOF("Baked {}^3 noise volume in {:.1f} ms", size, ms);
+        Save(path, voxels);
+    }
+
+    if (texture == 0) {
+        glGenTextures(1, &texture);
+    }
+    glBindTexture(GL_TEXTURE_3D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage3D(GL_TEXTURE_3D, 0, gradients ? GL_RGBA16F : GL_R16F, size, size, size, 0,
+                 gradients ? GL_RGBA : GL_RED, GL_FLOAT, voxels.data());
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+void NoiseVolume::Bake(std::vector<float>& voxels) {
+    PROFILE_ZONE("bake noise volume");
+    int channels = Channels();
+    size_t sliceSize = static_cast<size_t>(size) * size;
+    voxels.assign(sliceSize * size * channels, 0.0f);
+    std::vector<double> sliceSquares(size, 0.0);
+    std::vector<float> sliceMaxGradient(size, 0.0f);
+
+    // Each texel holds the noise at its centre, which is where texture(p / period) samples it
+    float step = static_cast<float>(period) / size;
+    {
+        ThreadPool pool(0, "noise bake");
+        for (int z = 0; z < size; z++) {
+            pool.Submit([&, z]() {
+                float sample[4];
+                for (int y = 0; y < size; y++) {
+                    for (int x = 0; x < size; x++) {
+                        Sample((x + 0.5f) * step, (y + 0.5f) * step, (z + 0.5f) * step, period, sample);
+                        float* voxel = &voxels[(z * sliceSize + static_cast<size_t>(y) * size + x) * channels];
+                        for (int c = 0; c < channels; c++) {
+                            voxel[c] = sample[c];
+                        }
+                        sliceSquares[z] += static_cast<double>(sample[0]) * sample[0];
+                        float gradient = std::sqrt(sample[1] * sample[1] + sample[2] * sample[2] + sample[3] * sample[3]);
+                        sliceMaxGradient[z] = std::max(sliceMaxGradient[z], gradient);
+                    }
+                }
+            });
+        }
+        pool.WaitIdle();
+    }
+
+    double squares = 0.0;
+    maxGradient = 0.0f;
+    for (int z = 0; z < size; z++) {
+        squares += sliceSquares[z];
+        maxGradient = std::max(maxGradient, sliceMaxGradient[z]);
+    }
+    double bakedRms = std::sqrt(squares / (sliceSize * size));
+
+    // Match the amplitude of the procedural noise (fixed LCG, reproducible)
+    const int referenceSamples = 1 << 16;
+    uint32_t state = 12345u;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8) / 16777216.0f * 1000.0f;
+    };
+    // Central differences at the same points give the procedural gradient
+    const float h = 1e-3f;
+    double referenceSquares = 0.0;
+    referenceGradient = 0.0f;
+    for (int i = 0; i < referenceSamples; i++) {
+        float x = next(), y = next(), z = next();
+        float n = EndNoise::simplex3D(x, y, z);
+        referenceSquares += static_cast<double>(n) * n;
+        float gx = EndNoise::simplex3D(x + h, y, z) - EndNoise::simplex3D(x - h, y, z);
+        float gy = EndNoise::simplex3D(x, y + h, z) - EndNoise::simplex3D(x, y - h, z);
+        float gz = EndNoise::simplex3D(x, y, z + h) - EndNoise::simplex3D(x, y, z - h);
+        referenceGradient = std::max(referenceGradient, std::sqrt(gx * gx + gy * gy + gz * gz) / (2.0f * h));
+    }
+    double referenceRms = std::sqrt(referenceSquares / referenceSamples);
+
+    float scale = bakedRms > 0.0 ? static_cast<float>(referenceRms / bakedRms) : 1.0f;
+    for (float& v : voxels) {
+        v *= scale;
+    }
+    maxGradient *= scale;
+    LOG_INFOF("Noise gradient bound {:.2f} baked, {:.2f} procedural", maxGradient, referenceGradient);
+}
+
+bool NoiseVolume::Load(const std::string& path, std::vector<float>& voxels) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    char magic[4];
+    int32_t header[3] = {};
+    float gradients[2] = {};
+    bool ok = std::fread(magic, 1, 4, file) == 4 &&
+              std::equal(magic, magic + 4, VOLUME_MAGIC) &&
+              std::fread(header, sizeof(header), 1, file) == 1 &&
+              std::fread(gradients, sizeof(gradients), 1, file) == 1 &&
+              header[0] == size && header[1] == period && header[2] == Channels();
+
+    if (ok) {
+        voxels.resize(static_cast<size_t>(size) * size * size * Channels());
+        ok = std::fread(voxels.data(), sizeof(float), voxels.size(), file) == voxels.size();
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        LOG_WARNINGF("Corrupt noise volume cache, rebaking: {}", path);
+        return false;
+    }
+    maxGradient = gradients[0];
+    referenceGradient = gradients[1];
+    return true;
+}
+
+void NoiseVolume::Save(const std::string& path, const std::vector<float>& voxels) const {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    // Write to a temporary file first so an interrupted write never leaves a partial volume
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        LOG_WARNINGF("Failed to write noise volume cache: {}", path);
+        return;
+    }
+    int32_t header[3] = {size, period, Channels()};
+    std::fwrite(VOLUME_MAGIC, 1, 4, file);
+    std::fwrite(header, sizeof(header), 1, file);
+    float gradients[2] = {maxGradient, referenceGradient};
+    std::fwrite(gradients, sizeof(gradients), 1, file);
+    std::fwrite(voxels.data(), sizeof(float), voxels.size(), file);
+    std::fclose(file);
+
+    std::filesystem::rename(tempPath, path, ec);
+}
+
+void NoiseVolume::Bind(GLuint unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_3D, texture);
+}
+
+void NoiseVolume::Delete() {
+    if (texture != 0) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
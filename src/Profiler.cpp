@@ -0,0 +1,149 @@
+#include "../include/Profiler.h"
+#include "../include/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ProfilerRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> buffers;
+
+    // Pairs zone ticks with steady_clock time; the export takes a second
+    // pair and converts ticks linearly between the two
+    uint64_t referenceTicks = Profiler::Now();
+    std::chrono::steady_clock::time_point referenceTime = std::chrono::steady_clock::now();
+};
+
+struct CopiedZone {
+    const ProfileSite* site;
+    uint64_t begin;
+    uint64_t end;
+};
+
+// Never destroyed: threads can still record zones during static destruction
+static ProfilerRegistry& registry() {
+    static ProfilerRegistry* instance = new ProfilerRegistry();
+    return *instance;
+}
+
+static void writeEscaped(std::ofstream& out, const char* text) {
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+}
+
+Profiler::ThreadBuffer* Profiler::RegisterThread() {
+    ProfilerRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+    ThreadBuffer* buffer = reg.buffers.back().get();
+    buffer->threadId = static_cast<uint32_t>(reg.buffers.size());
+    buffer->name = "thread " + std::to_string(buffer->threadId);
+    return buffer;
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+#if PROFILER_ENABLED
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    buffer->name = name;
+#else
+    (void)name;
+#endif
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path, double seconds) {
+#if !PROFILER_ENABLED
+    LOG_WARNING("Profile zones are compiled out (RENDERER_PROFILE_ZONES=OFF), nothing to export");
+    (void)path;
+    (void)seconds;
+    return false;
+#else
+    ProfilerRegistry& reg = registry();
+    std::unique_lock<std::mutex> lock(reg.mutex);
+
+    uint64_t nowTicks = Now();
+    double elapsedNs = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - reg.referenceTime).count();
+    double ticksPerNs = elapsedNs > 0.0 ? static_cast<double>(nowTicks - reg.referenceTicks) / elapsedNs : 1.0;
+    if (ticksPerNs <= 0.0) {
+        ticksPerNs = 1.0;
+    }
+    double windowTicks = seconds * 1e9 * ticksPerNs;
+    uint64_t cutoff = windowTicks < static_cast<double>(nowTicks - reg.referenceTicks)
+        ? nowTicks - static_cast<uint64_t>(windowTicks) : reg.referenceTicks;
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        lock.unlock();
+        LOG_ERRORF("Failed to write trace: {}", path);
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t eventCount = 0;
+    std::vector<CopiedZone> events;
+    char buffer[128];
+
+    for (const auto& thread : reg.buffers) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << thread->threadId << ",\"args\":{\"name\":\"";
+        writeEscaped(out, thread->name.c_str());
+        out << "\"}}";
+        first = false;
+
+        uint64_t head = thread->head.load(std::memory_order_acquire);
+        uint64_t start = head > ThreadBuffer::CAPACITY ? head - ThreadBuffer::CAPACITY : 0;
+        events.clear();
+        for (uint64_t i = start; i < head; i++) {
+            const Event& event = thread->events[i & (ThreadBuffer::CAPACITY - 1)];
+            events.push_back({event.site.load(std::memory_order_relaxed),
+                              event.begin.load(std::memory_order_relaxed),
+                              event.end.load(std::memory_order_relaxed)});
+        }
+
+        // Slots the owner may have reused (or be writing) while we copied
+        uint64_t newHead = thread->head.load(std::memory_order_acquire);
+        uint64_t firstValid = newHead >= ThreadBuffer::CAPACITY ? newHead - ThreadBuffer::CAPACITY + 1 : 0;
+        size_t skip = static_cast<size_t>(std::min(std::max(firstValid, start) - start, head - start));
+
+        for (size_t i = skip; i < events.size(); i++) {
+            const CopiedZone& event = events[i];
+            if (event.end < cutoff || event.begin < reg.referenceTicks) {
+                continue;
+            }
+            double ts = static_cast<double>(event.begin - reg.referenceTicks) / ticksPerNs * 1e-3;
+            double dur = static_cast<double>(event.end - event.begin) / ticksPerNs * 1e-3;
+            out << ",\n{\"name\":\"";
+            writeEscaped(out, event.site->name);
+            std::snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,",
+                          thread->threadId, ts, dur);
+            out << buffer << "\"args\":{\"site\":\"";
+            writeEscaped(out, event.site->file);
+            out << ":" << event.site->line << "\"}}";
+            eventCount++;
+        }
+    }
+    out << "\n]}\n";
+    size_t threadCount = reg.buffers.size();
+
+    // The logger's own threads may be waiting on the registry to record zones
+    lock.unlock();
+    LOG_INFOF("CPU trace written to {} ({} zones, {} threads)", path, eventCount, threadCount);
+    return true;
+#endif
+}
@@ -0,0 +1,207 @@
+#include "../include/RaymarchCost.h"
+#include "../include/Logger.h"
+#include <algorithm>
+
+// costTotals[4] followed by the histogram, see end_raymarch.frag
+static const size_t ATOMIC_BUFFER_SIZE = (4 + RaymarchCost::HISTOGRAM_BINS) * sizeof(uint32_t);
+
+RaymarchCost::RaymarchCost() :
+    initialized(false),
+    atomics(false),
+    nextSlot(0),
+    activeSlot(-1),
+    scratchBuffer(0),
+    costTexture(0),
+    textureWidth(0),
+    textureHeight(0),
+    frameCounter(0),
+    samples(0) {
+}
+
+void RaymarchCost::Initialize() {
+    atomics = GLEW_VERSION_4_3;
+    if (atomics) {
+        glGenBuffers(1, &scratchBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, scratchBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, ATOMIC_BUFFER_SIZE, nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    initialized = true;
+    LOG_INFO(atomics ? "Ray cost counters: SSBO atomics" : "Ray cost counters: per-pixel readback (no GL 4.3)");
+}
+
+std::string RaymarchCost::ShaderPreamble() const {
+    std::string bins = std::to_string(HISTOGRAM_BINS);
+    if (atomics) {
+        return "#version 430 core\n#define RAY_COST\n#define RAY_COST_ATOMICS\n#define RAY_COST_BINS " + bins + "\n";
+    }
+    return "#version 330 core\n#define RAY_COST\n#define RAY_COST_BINS " + bins + "\n";
+}
+
+void RaymarchCost::BeginPass(int width, int height, int maxSteps) {
+    frameCounter++;
+    activeSlot = -1;
+
+    // A slot still in flight means the GPU is behind, skip this sample
+    Slot& slot = slots[nextSlot];
+    bool sample = !slot.pending && (atomics || frameCounter % std::max(readbackInterval, 1) == 0);
+
+    if (atomics) {
+        if (sample) {
+            if (slot.buffer == 0) {
+                glGenBuffers(1, &slot.buffer);
+                glBindBuffer(GL_SHADER_STORAGE_BUFFER, slot.buffer);
+                glBufferData(GL_SHADER_STORAGE_BUFFER, ATOMIC_BUFFER_SIZE, nullptr, GL_DYNAMIC_COPY);
+            }
+            static const uint32_t zeros[4 + HISTOGRAM_BINS] = {};
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, slot.buffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, ATOMIC_BUFFER_SIZE, zeros);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, sample ? slot.buffer : scratchBuffer);
+    } else if (sample) {
+        if (costTexture == 0 || textureWidth != width || textureHeight != height) {
+            if (costTexture == 0) {
+                glGenTextures(1, &costTexture);
+            }
+            glBindTexture(GL_TEXTURE_2D, costTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            textureWidth = width;
+            textureHeight = height;
+        }
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, costTexture, 0);
+        const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+        glDrawBuffers(2, drawBuffers);
+    }
+
+    if (sample) {
+        slot.width = width;
+        slot.height = height;
+        slot.maxSteps = maxSteps;
+        activeSlot = nextSlot;
+    }
+}
+
+void RaymarchCost::EndPass() {
+    if (activeSlot < 0) {
+        return;
+    }
+    Slot& slot = slots[activeSlot];
+
+    if (atomics) {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    } else {
+        size_t size = static_cast<size_t>(slot.width) * slot.height * 4 * sizeof(uint16_t);
+        if (slot.buffer == 0) {
+            glGenBuffers(1, &slot.buffer);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        if (slot.capacity < size) {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+            slot.capacity = size;
+        }
+        glReadBuffer(GL_COLOR_ATTACHMENT1);
+        glReadPixels(0, 0, slot.width, slot.height, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, 0, 0);
+        glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    }
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.pending = true;
+    nextSlot = (nextSlot + 1) % RING_SIZE;
+    activeSlot = -1;
+}
+
+void RaymarchCost::Collect() {
+    // Oldest first, so the newest finished sample ends up in latest
+    for (int i = 0; i < RING_SIZE; i++) {
+        Slot& slot = slots[(nextSlot + i) % RING_SIZE];
+        if (!slot.pending) {
+            continue;
+        }
+
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        slot.pending = false;
+
+        GLenum target = atomics ? GL_COPY_READ_BUFFER : GL_PIXEL_PACK_BUFFER;
+        size_t size = atomics ? ATOMIC_BUFFER_SIZE : static_cast<size_t>(slot.width) * slot.height * 4 * sizeof(uint16_t);
+        glBindBuffer(target, slot.buffer);
+        const void* data = glMapBufferRange(target, 0, size, GL_MAP_READ_BIT);
+        if (data != nullptr) {
+            if (atomics) {
+                ReduceAtomics(slot, static_cast<const uint32_t*>(data));
+            } else {
+                ReducePixels(slot, static_cast<const uint16_t*>(data));
+            }
+            glUnmapBuffer(target);
+        }
+        glBindBuffer(target, 0);
+    }
+}
+
+void RaymarchCost::ReduceAtomics(const Slot& slot, const uint32_t* data) {
+    Stats stats;
+    stats.steps = data[0];
+    stats.densityEvals = data[1];
+    stats.refineSteps = data[2];
+    stats.hits = data[3];
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        stats.histogram[i] = data[4 + i];
+        stats.rays += data[4 + i];
+    }
+    stats.maxSteps = slot.maxSteps;
+    latest = stats;
+    samples++;
+}
+
+void RaymarchCost::ReducePixels(const Slot& slot, const uint16_t* data) {
+    Stats stats;
+    int maxSteps = std::max(slot.maxSteps, 1);
+    size_t pixels = static_cast<size_t>(slot.width) * slot.height;
+    for (size_t i = 0; i < pixels; i++) {
+        const uint16_t* pixel = data + i * 4;
+        stats.steps += pixel[0];
+        stats.densityEvals += pixel[1];
+        stats.refineSteps += pixel[2];
+        stats.hits += pixel[3];
+        stats.histogram[std::min(pixel[0] * HISTOGRAM_BINS / maxSteps, HISTOGRAM_BINS - 1)]++;
+    }
+    stats.rays = pixels;
+    stats.maxSteps = slot.maxSteps;
+    latest = stats;
+    samples++;
+}
+
+void RaymarchCost::Delete() {
+    for (Slot& slot : slots) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.buffer != 0) {
+            glDeleteBuffers(1, &slot.buffer);
+            slot.buffer = 0;
+        }
+        slot.pending = false;
+        slot.capacity = 0;
+    }
+    if (scratchBuffer != 0) {
+        glDeleteBuffers(1, &scratchBuffer);
+        scratchBuffer = 0;
+    }
+    if (costTexture != 0) {
+        glDeleteTextures(1, &costTexture);
+        costTexture = 0;
+    }
+}
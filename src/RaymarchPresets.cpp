@@ -0,0 +1,116 @@
+#include "../include/RaymarchPresets.h"
+#include "../include/Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+const char* RaymarchPresets::DEFAULT_PATH = "presets/raymarch_presets.ini";
+
+static std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r");
+    size_t end = text.find_last_not_of(" \t\r");
+    return start == std::string::npos ? "" : text.substr(start, end - start + 1);
+}
+
+bool RaymarchPresets::Load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    presets.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        if (line.front() == '[' && line.back() == ']') {
+            RaymarchPreset preset;
+            preset.name = line.substr(1, line.size() - 2);
+            presets.push_back(preset);
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos || presets.empty()) {
+            LOG_WARNING(path + ":" + std::to_string(lineNumber) + ": ignoring malformed line");
+            continue;
+        }
+
+        std::string key = trim(line.substr(0, equals));
+        std::istringstream value(trim(line.substr(equals + 1)));
+        RaymarchPreset& preset = presets.back();
+
+        if (key == "maxSteps") value >> preset.settings.maxSteps;
+        else if (key == "stepMultiplier") value >> preset.settings.stepMultiplier;
+        else if (key == "octaves") value >> preset.settings.octaves;
+        else if (key == "refineSteps") value >> preset.settings.refineSteps;
+        else if (key == "renderScale") value >> preset.settings.renderScale;
+        else if (key == "maxDistance") value >> preset.settings.maxDistance;
+        else if (key == "bakedNoise") value >> preset.settings.bakedNoise;
+        else if (key == "sphereTrace") value >> preset.settings.sphereTrace;
+        else if (key == "islandGrid") value >> preset.settings.islandGrid;
+        else if (key == "sdfClipmap") value >> preset.settings.sdfClipmap;
+        else if (key == "sdfShadows") value >> preset.settings.sdfShadows;
+        else if (key == "brickMap") value >> preset.settings.brickMap;
+        else if (key == "lipschitz") value >> preset.settings.lipschitz;
+        else if (key == "relaxation") value >> preset.settings.relaxation;
+        else if (key == "gpuMs") value >> preset.gpuMs;
+        else if (key == "ssim") value >> preset.ssim;
+        else if (key == "psnr") value >> preset.psnr;
+        else LOG_WARNING(path + ":" + std::to_string(lineNumber) + ": unknown key '" + key + "'");
+    }
+
+    LOG_INFO("Loaded " + std::to_string(presets.size()) + " raymarch presets from " + path);
+    return true;
+}
+
+bool RaymarchPresets::Save(const std::string& path) const {
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        LOG_ERROR("Failed to write raymarch presets: " + path);
+        return false;
+    }
+
+    out << "# Raymarch presets (generated by renderer --tune)\n";
+    for (const RaymarchPreset& preset : presets) {
+        out << "\n[" << preset.name << "]\n";
+        out << "maxSteps = " << preset.settings.maxSteps << "\n";
+        out << "stepMultiplier = " << preset.settings.stepMultiplier << "\n";
+        out << "octaves = " << preset.settings.octaves << "\n";
+        out << "refineSteps = " << preset.settings.refineSteps << "\n";
+        out << "renderScale = " << preset.settings.renderScale << "\n";
+        out << "maxDistance = " << preset.settings.maxDistance << "\n";
+        out << "bakedNoise = " << (preset.settings.bakedNoise ? 1 : 0) << "\n";
+        out << "sphereTrace = " << (preset.settings.sphereTrace ? 1 : 0) << "\n";
+        out << "islandGrid = " << (preset.settings.islandGrid ? 1 : 0) << "\n";
+        out << "sdfClipmap = " << (preset.settings.sdfClipmap ? 1 : 0) << "\n";
+        out << "sdfShadows = " << (preset.settings.sdfShadows ? 1 : 0) << "\n";
+        out << "brickMap = " << (preset.settings.brickMap ? 1 : 0) << "\n";
+        out << "lipschitz = " << preset.settings.lipschitz << "\n";
+        out << "relaxation = " << preset.settings.relaxation << "\n";
+        out << "gpuMs = " << preset.gpuMs << "\n";
+        out << "ssim = " << preset.ssim << "\n";
+        out << "psnr = " << preset.psnr << "\n";
+    }
+    return true;
+}
+
+const RaymarchPreset* RaymarchPresets::Find(const std::string& name) const {
+    for (const RaymarchPreset& preset : presets) {
+        if (preset.name == name) {
+            return &preset;
+        }
+    }
+    return nullptr;
+}
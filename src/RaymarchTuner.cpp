@@ -0,0 +1,322 @@
+#include "../include/RaymarchTuner.h"
+#include "../include/FrameBuffer.h"
+#include "../include/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// Each combination is timed this many times per frame, keeping the fastest
+static const int TIMED_RUNS = 2;
+
+// Longest wait for an island grid build before timing a frame anyway
+static const int GRID_SETTLE_MS = 10000;
+
+// SSIM is evaluated on non-overlapping luminance blocks of this size
+static const int SSIM_BLOCK = 8;
+
+// Presets picked from the Pareto front: cheapest point reaching the SSIM threshold
+struct Tier {
+    const char* name;
+    double minSsim;
+};
+static const Tier TIERS[] = {
+    {"Low", 0.90},
+    {"Medium", 0.95},
+    {"High", 0.98},
+};
+
+RaymarchTuner::RaymarchTuner(GLFWwindow* window, EndRenderer& renderer, int width, int height, int framesPerFlight) :
+    window(window),
+    renderer(renderer),
+    width(width),
+    height(height),
+    framesPerFlight(framesPerFlight) {
+}
+
+RaymarchSettings RaymarchTuner::ReferenceSettings() {
+    RaymarchSettings settings;
+    settings.maxSteps = 1024;
+    settings.stepMultiplier = 0.25f;
+    settings.octaves = 6;
+    settings.refineSteps = 8;
+    settings.renderScale = 1.0f;
+    settings.bakedNoise = false;    // Procedural noise and small fixed steps are the ground truth
+    settings.sphereTrace = false;
+    settings.islandGrid = false;
+    return settings;
+}
+
+// Every combination runs the same shader paths whatever the RaymarchSettings
+// defaults are: baked noise, sphere tracing and the island grid, which is the
+// default view, and none of the baked-field modes
+std::vector<RaymarchSettings> RaymarchTuner::SweepGrid() {
+    static const int maxSteps[] = {96, 192, 384};
+    static const float stepMultipliers[] = {0.75f, 1.0f, 1.5f, 2.5f};
+    static const int octaves[] = {2, 3, 4, 5};
+    static const int refineSteps[] = {1, 2, 4};
+    static const float renderScales[] = {0.5f, 0.75f, 1.0f};
+
+    std::vector<RaymarchSettings> grid;
+    for (int steps : maxSteps)
+        for (float multiplier : stepMultipliers)
+            for (int octave : octaves)
+                for (int refine : refineSteps)
+                    for (float scale : renderScales) {
+                        RaymarchSettings settings;
+                        settings.maxSteps = steps;
+                        settings.stepMultiplier = multiplier;
+                        settings.octaves = octave;
+                        settings.refineSteps = refine;
+                        settings.renderScale = scale;
+                        settings.bakedNoise = true;
+                        settings.sphereTrace = true;
+                        settings.islandGrid = true;
+                        settings.sdfClipmap = false;
+                        settings.brickMap = false;
+                        grid.push_back(settings);
+                    }
+    return grid;
+}
+
+bool RaymarchTuner::CollectSamples(const std::vector<std::string>& flights) {
+    samples.clear();
+    for (const std::string& flight : flights) {
+        CameraPath path;
+        if (!CameraPath::Resolve(flight, path) || path.GetFrameCount() == 0) {
+            LOG_ERROR("Tuner: could not load flight " + flight);
+            return false;
+        }
+
+        // Evenly spaced frames, skipping the very first one
+        for (int i = 0; i < framesPerFlight; i++) {
+            size_t frame = (i + 1) * path.GetFrameCount() / (framesPerFlight + 1);
+            Sample sample{Camera(width, height, glm::vec3(0.0f)), frame * path.timestep, {}};
+            path.Apply(frame, sample.camera);
+            samples.push_back(std::move(sample));
+        }
+    }
+    return !samples.empty();
+}
+
+bool RaymarchTuner::SettleIslandGrid(const Sample& sample, GLuint fbo) {
+    // The grid is built on a worker thread. Rendering drives its updates, so
+    // render until it is valid and not rebuilding for this camera; otherwise
+    // early and late combinations would be timed with and without it.
+    const IslandGrid& grid = renderer.GetIslandGrid();
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        renderer.Render(sample.camera, width, height, sample.time, fbo);
+        if (!renderer.settings.islandGrid || (grid.IsValid() && !grid.IsBuilding())) {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(GRID_SETTLE_MS)) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+double RaymarchTuner::RenderTimed(const Sample& sample, GLuint fbo, GLuint query) {
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    renderer.Render(sample.camera, width, height, sample.time, fbo);
+    glEndQuery(GL_TIME_ELAPSED);
+
+    // Blocks until the GPU is done, fine for an offline sweep
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+    return elapsed / 1e6;
+}
+
+void RaymarchTuner::ReadPixels(GLuint fbo, std::vector<uint8_t>& pixels) const {
+    pixels.resize(static_cast<size_t>(width) * height * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+bool RaymarchTuner::Run(const std::vector<std::string>& flights, RaymarchPresets& presets) {
+    if (!CollectSamples(flights)) {
+        return false;
+    }
+
+    Framebuffer output(width, height);
+    GLuint query;
+    glGenQueries(1, &query);
+    RaymarchSettings original = renderer.settings;
+
+    // Reference images
+    LOG_INFO("Tuner: rendering " + std::to_string(samples.size()) + " reference frames");
+    renderer.settings = ReferenceSettings();
+    for (Sample& sample : samples) {
+        renderer.Render(sample.camera, width, height, sample.time, output.GetFBO());
+        ReadPixels(output.GetFBO(), sample.reference);
+    }
+
+    std::vector<RaymarchSettings> grid = SweepGrid();
+    LOG_INFO("Tuner: sweeping " + std::to_string(grid.size()) + " combinations at " +
+             std::to_string(width) + "x" + std::to_string(height));
+
+    results.clear();
+    std::vector<uint8_t> pixels;
+    bool aborted = false;
+    for (size_t i = 0; i < grid.size(); i++) {
+        glfwPollEvents();
+        if (glfwWindowShouldClose(window)) {
+            aborted = true;
+            break;
+        }
+
+        renderer.settings = grid[i];
+        Result result{grid[i], 0.0, 0.0, 0.0};
+        for (const Sample& sample : samples) {
+            // Untimed warm-up render(s) so shader variants, caches and the island grid are ready
+            if (!SettleIslandGrid(sample, output.GetFBO())) {
+                LOG_WARNING("Tuner: island grid still building, frame timed without it");
+            }
+
+            double best = RenderTimed(sample, output.GetFBO(), query);
+            for (int run = 1; run < TIMED_RUNS; run++) {
+                best = std::min(best, RenderTimed(sample, output.GetFBO(), query));
+            }
+
+            ReadPixels(output.GetFBO(), pixels);
+            result.gpuMs += best;
+            result.psnr += Psnr(pixels, sample.reference);
+            result.ssim += Ssim(pixels, sample.reference, width, height);
+        }
+        result.gpuMs /= samples.size();
+        result.psnr /= samples.size();
+        result.ssim /= samples.size();
+        results.push_back(result);
+
+        if ((i + 1) % 25 == 0 || i + 1 == grid.size()) {
+            LOG_INFOF("Tuner: {} / {} combinations", i + 1, grid.size());
+        }
+    }
+
+    glDeleteQueries(1, &query);
+    output.Delete();
+    renderer.settings = original;
+
+    if (aborted) {
+        LOG_WARNING("Tuner: aborted, no presets written");
+        return false;
+    }
+
+    std::vector<Result> front = ParetoFront(results);
+    presets.presets.clear();
+
+    auto makePreset = [](const std::string& name, const Result& result) {
+        RaymarchPreset preset;
+        preset.name = name;
+        preset.settings = result.settings;
+        preset.gpuMs = static_cast<float>(result.gpuMs);
+        preset.ssim = static_cast<float>(result.ssim);
+        preset.psnr = static_cast<float>(result.psnr);
+        return preset;
+    };
+
+    for (const Tier& tier : TIERS) {
+        for (const Result& result : front) {
+            if (result.ssim >= tier.minSsim) {
+                presets.presets.push_back(makePreset(tier.name, result));
+                break;
+            }
+        }
+    }
+    if (!front.empty()) {
+        presets.presets.push_back(makePreset("Ultra", front.back()));
+    }
+    for (size_t i = 0; i < front.size(); i++) {
+        presets.presets.push_back(makePreset("pareto_" + std::to_string(i), front[i]));
+
+        char line[160];
+        std::snprintf(line, sizeof(line), "Pareto %2zu: %7.3f ms  SSIM %.4f  PSNR %5.2f dB  steps %d x%.2f oct %d refine %d scale %.2f",
+                      i, front[i].gpuMs, front[i].ssim, front[i].psnr, front[i].settings.maxSteps,
+                      front[i].settings.stepMultiplier, front[i].settings.octaves,
+                      front[i].settings.refineSteps, front[i].settings.renderScale);
+        LOG_INFO(line);
+    }
+
+    return presets.Save();
+}
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+double RaymarchTuner::Psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    double squaredError = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double diff = static_cast<double>(a[i]) - b[i];
+        squaredError += diff * diff;
+    }
+    double mse = squaredError / a.size();
+
+    // Identical images: report a large finite value so averages stay usable
+    if (mse <= 1e-10) {
+        return 100.0;
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+double RaymarchTuner::Ssim(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int width, int height) {
+    const double c1 = (0.01 * 255.0) * (0.01 * 255.0);
+    const double c2 = (0.03 * 255.0) * (0.03 * 255.0);
+    const double n = SSIM_BLOCK * SSIM_BLOCK;
+
+    auto luma = [](const std::vector<uint8_t>& image, size_t pixel) {
+        return 0.299 * image[pixel * 3] + 0.587 * image[pixel * 3 + 1] + 0.114 * image[pixel * 3 + 2];
+    };
+
+    double total = 0.0;
+    int blocks = 0;
+    for (int by = 0; by + SSIM_BLOCK <= height; by += SSIM_BLOCK) {
+        for (int bx = 0; bx + SSIM_BLOCK <= width; bx += SSIM_BLOCK) {
+            double sumA = 0.0, sumB = 0.0, sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+            for (int y = by; y < by + SSIM_BLOCK; y++) {
+                for (int x = bx; x < bx + SSIM_BLOCK; x++) {
+                    size_t pixel = static_cast<size_t>(y) * width + x;
+                    double la = luma(a, pixel);
+                    double lb = luma(b, pixel);
+                    sumA += la;
+                    sumB += lb;
+                    sumAA += la * la;
+                    sumBB += lb * lb;
+                    sumAB += la * lb;
+                }
+            }
+
+            double meanA = sumA / n;
+            double meanB = sumB / n;
+            double varA = sumAA / n - meanA * meanA;
+            double varB = sumBB / n - meanB * meanB;
+            double covariance = sumAB / n - meanA * meanB;
+
+            total += ((2.0 * meanA * meanB + c1) * (2.0 * covariance + c2)) /
+                     ((meanA * meanA + meanB * meanB + c1) * (varA + varB + c2));
+            blocks++;
+        }
+    }
+    return blocks > 0 ? total / blocks : 1.0;
+}
+
+std::vector<RaymarchTuner::Result> RaymarchTuner::ParetoFront(std::vector<Result> candidates) {
+    std::sort(candidates.begin(), candidates.end(), [](const Result& a, const Result& b) {
+        if (a.gpuMs != b.gpuMs) return a.gpuMs < b.gpuMs;
+        return a.ssim > b.ssim;
+    });
+
+    std::vector<Result> front;
+    double bestSsim = -1.0;
+    for (const Result& result : candidates) {
+        if (result.ssim > bestSsim) {
+            front.push_back(result);
+            bestSsim = result.ssim;
+        }
+    }
+    return front;
+}
@@ -0,0 +1,198 @@
+#include "../include/ReplayBenchmark.h"
+#include "../include/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+
+ReplayBenchmark::ReplayBenchmark(const CameraPath& path, const std::string& name, int warmupFrames) :
+    path(path),
+    name(name),
+    warmupFrames(warmupFrames),
+    frame(0),
+    rayCostSamples(0),
+    queriesCreated(false) {
+    cpuTimes.reserve(path.GetFrameCount());
+    gpuTimes.reserve(path.GetFrameCount());
+    for (int i = 0; i < QUERY_RING_SIZE; i++) {
+        queries[i] = 0;
+        queryFrame[i] = 0;
+        queryPending[i] = false;
+    }
+}
+
+void ReplayBenchmark::BeginFrame(Camera& camera) {
+    if (!queriesCreated) {
+        glGenQueries(QUERY_RING_SIZE, queries);
+        queriesCreated = true;
+    }
+
+    path.Apply(frame, camera);
+
+    // Reusing a slot whose result has not arrived yet forces a wait (ring too small for the GPU latency)
+    int slot = static_cast<int>(frame % QUERY_RING_SIZE);
+    if (queryPending[slot]) {
+        CollectQueries(true);
+    }
+
+    frameStart = std::chrono::steady_clock::now();
+    glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+}
+
+void ReplayBenchmark::EndFrame() {
+    int slot = static_cast<int>(frame % QUERY_RING_SIZE);
+    glEndQuery(GL_TIME_ELAPSED);
+    queryPending[slot] = true;
+    queryFrame[slot] = frame;
+
+    auto frameEnd = std::chrono::steady_clock::now();
+    cpuTimes.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+    gpuTimes.push_back(-1.0);
+
+    frame++;
+    CollectQueries(false);
+}
+
+void ReplayBenchmark::AddRayCost(const RaymarchCost::Stats& stats) {
+    if (frame < static_cast<size_t>(warmupFrames)) {
+        return;
+    }
+    rayCost.rays += stats.rays;
+    rayCost.steps += stats.steps;
+    rayCost.densityEvals += stats.densityEvals;
+    rayCost.refineSteps += stats.refineSteps;
+    rayCost.hits += stats.hits;
+    for (int i = 0; i < RaymarchCost::HISTOGRAM_BINS; i++) {
+        rayCost.histogram[i] += stats.histogram[i];
+    }
+    rayCost.maxSteps = stats.maxSteps;
+    rayCostSamples++;
+}
+
+void ReplayBenchmark::CollectQueries(bool wait) {
+    for (int i = 0; i < QUERY_RING_SIZE; i++) {
+        if (!queryPending[i]) {
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available && !wait) {
+            continue;
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &elapsed);
+        gpuTimes[queryFrame[i]] = static_cast<double>(elapsed) / 1.0e6;
+        queryPending[i] = false;
+    }
+}
+
+double ReplayBenchmark::Percentile(std::vector<double> values, double percentile) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    // Nearest-rank percentile
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size()));
+    rank = std::clamp<size_t>(rank, 1, values.size());
+    return values[rank - 1];
+}
+
+ReplayBenchmark::Summary ReplayBenchmark::Summarize(const std::vector<double>& values) {
+    Summary summary = {0.0, 0.0, 0.0, 0.0, 0.0};
+    if (values.empty()) {
+        return summary;
+    }
+    for (double v : values) {
+        summary.mean += v;
+        summary.max = std::max(summary.max, v);
+    }
+    summary.mean /= values.size();
+    summary.p50 = Percentile(values, 50.0);
+    summary.p95 = Percentile(values, 95.0);
+    summary.p99 = Percentile(values, 99.0);
+    return summary;
+}
+
+static void writeSummaryJson(std::ofstream& out, const char* key, const ReplayBenchmark::Summary& s, bool last) {
+    out << "  \"" << key << "\": {\"mean\": " << s.mean << ", \"p50\": " << s.p50
+        << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << "}"
+        << (last ? "\n" : ",\n");
+}
+
+void ReplayBenchmark::Finish(const std::string& outputDir) {
+    if (queriesCreated) {
+        CollectQueries(true);
+    }
+
+    // Frames after warmup only
+    std::vector<double> cpu, gpu;
+    for (size_t i = static_cast<size_t>(warmupFrames); i < cpuTimes.size(); i++) {
+        cpu.push_back(cpuTimes[i]);
+        if (gpuTimes[i] >= 0.0) {
+            gpu.push_back(gpuTimes[i]);
+        }
+    }
+    Summary cpuSummary = Summarize(cpu);
+    Summary gpuSummary = Summarize(gpu);
+
+    std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+    std::error_code ec;
+    std::filesystem::create_directories(outputDir, ec);
+    std::string base = outputDir + "/" + name + "_" + stamp;
+
+    std::ofstream csv(base + ".csv");
+    csv << "frame,cpu_ms,gpu_ms,warmup\n";
+    for (size_t i = 0; i < cpuTimes.size(); i++) {
+        csv << i << "," << cpuTimes[i] << "," << gpuTimes[i] << ","
+            << (i < static_cast<size_t>(warmupFrames) ? 1 : 0) << "\n";
+    }
+
+    std::ofstream json(base + ".json");
+    json << "{\n";
+    json << "  \"flight\": \"" << name << "\",\n";
+    json << "  \"frames\": " << cpuTimes.size() << ",\n";
+    json << "  \"warmup_frames\": " << warmupFrames << ",\n";
+    json << "  \"timestep\": " << path.timestep << ",\n";
+    writeSummaryJson(json, "cpu_ms", cpuSummary, false);
+    writeSummaryJson(json, "gpu_ms", gpuSummary, rayCostSamples == 0);
+    if (rayCostSamples > 0) {
+        double rays = static_cast<double>(std::max<uint64_t>(rayCost.rays, 1));
+        json << "  \"ray_cost\": {\"samples\": " << rayCostSamples
+             << ", \"steps_per_ray\": " << rayCost.steps / rays
+             << ", \"density_evals_per_ray\": " << rayCost.densityEvals / rays
+             << ", \"refine_steps_per_ray\": " << rayCost.refineSteps / rays
+             << ", \"hit_rate\": " << rayCost.hits / rays
+             << ", \"max_steps\": " << rayCost.maxSteps
+             << ", \"steps_histogram\": [";
+        for (int i = 0; i < RaymarchCost::HISTOGRAM_BINS; i++) {
+            json << (i > 0 ? ", " : "") << rayCost.histogram[i];
+        }
+        json << "]}\n";
+    }
+    json << "}\n";
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "Replay '%s': %zu frames | CPU ms p50 %.3f p95 %.3f p99 %.3f | GPU ms p50 %.3f p95 %.3f p99 %.3f",
+                  name.c_str(), cpuTimes.size(), cpuSummary.p50, cpuSummary.p95, cpuSummary.p99,
+                  gpuSummary.p50, gpuSummary.p95, gpuSummary.p99);
+    LOG_INFO(line);
+    if (rayCostSamples > 0) {
+        double rays = static_cast<double>(std::max<uint64_t>(rayCost.rays, 1));
+        LOG_INFOF("Replay '{}' ray cost: {:.1f} steps, {:.1f} density evals, {:.2f} refine steps per ray",
+                  name, rayCost.steps / rays, rayCost.densityEvals / rays, rayCost.refineSteps / rays);
+    }
+    LOG_INFO("Replay results written to " + base + ".csv/.json");
+}
+
+void ReplayBenchmark::Delete() {
+    if (queriesCreated) {
+        glDeleteQueries(QUERY_RING_SIZE, queries);
+        queriesCreated = false;
+    }
+}
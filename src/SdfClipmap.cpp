@@ -0,0 +1,321 @@
+#include "../include/SdfClipmap.h"
+#include "../include/EndTerrain.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Levels move in steps of this many voxels to batch slab bakes
+static const int ORIGIN_SNAP = 4;
+
+static const double FAR = 1e20;
+
+SdfClipmap::SdfClipmap() : pool(0, "sdf bake") {
+}
+
+static int FloorDiv(int value, int divisor) {
+    return (value >= 0 ? value : value - divisor + 1) / divisor;
+}
+
+// Squared distance transform of a sampled function (Felzenszwalb & Huttenlocher)
+static void DistanceTransform1D(const double* f, double* d, int n, int* v, double* z) {
+    int k = 0;
+    v[0] = 0;
+    z[0] = -FAR;
+    z[1] = FAR;
+    for (int q = 1; q < n; q++) {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FAR;
+    }
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+// In-place squared Euclidean distance transform of a 3D grid, x fastest
+static void DistanceTransform3D(std::vector<double>& grid, const glm::ivec3& size) {
+    int longest = std::max(size.x, std::max(size.y, size.z));
+    std::vector<double> line(longest), result(longest), z(longest + 1);
+    std::vector<int> v(longest);
+    const int strides[3] = {1, size.x, size.x * size.y};
+
+    for (int axis = 0; axis < 3; axis++) {
+        int n = size[axis];
+        int stride = strides[axis];
+        int lines = size.x * size.y * size.z / n;
+        for (int i = 0; i < lines; i++) {
+            // Start of the i-th line along this axis
+            int base;
+            if (axis == 0) base = i * size.x;
+            else if (axis == 1) base = (i / size.x) * size.x * size.y + i % size.x;
+            else base = i;
+            for (int q = 0; q < n; q++) line[q] = grid[base + q * stride];
+            DistanceTransform1D(line.data(), result.data(), n, v.data(), z.data());
+            for (int q = 0; q < n; q++) grid[base + q * stride] = result[q];
+        }
+    }
+}
+
+glm::ivec3 SdfClipmap::TargetOrigin(int level, const glm::vec3& cameraPos) const {
+    float voxel = voxelSize * static_cast<float>(1 << level);
+    glm::ivec3 origin;
+    for (int axis = 0; axis < 3; axis++) {
+        int camera = static_cast<int>(std::floor(cameraPos[axis] / voxel));
+        origin[axis] = FloorDiv(camera - resolution / 2, ORIGIN_SNAP) * ORIGIN_SNAP;
+    }
+
+    // Keep the terrain slab inside the level where it fits, otherwise as much of it as possible
+    int low = static_cast<int>(std::floor(EndTerrain::MIN_Y / voxel)) - 1;
+    int high = static_cast<int>(std::ceil(EndTerrain::MAX_Y / voxel)) + 1 - resolution;
+    origin.y = std::clamp(origin.y, std::min(low, high), std::max(low, high));
+    return origin;
+}
+
+void SdfClipmap::Bake(Box& box, int level, int octaves, float lipschitz) const {
+    PROFILE_ZONE("bake sdf");
+    float voxel = voxelSize * static_cast<float>(1 << level);
+    float halfDiagonal = voxel * 0.8660254f;
+
+    // Every voxel within `band` of the box is needed for its exact distances
+    glm::ivec3 expandedMin = box.min - glm::ivec3(band);
+    glm::ivec3 expandedSize = box.size + glm::ivec3(2 * band);
+    size_t count = static_cast<size_t>(expandedSize.x) * expandedSize.y * expandedSize.z;
+
+    // y-range that can hold terrain per voxel column, from the chunk columns it overlaps
+    EndTerrain terrain(octaves);
+    int firstChunkX = static_cast<int>(std::floor(expandedMin.x * voxel / 16.0f));
+    int firstChunkZ = static_cast<int>(std::floor(expandedMin.z * voxel / 16.0f));
+    int chunksX = static_cast<int>(std::floor(((expandedMin.x + expandedSize.x) * voxel - 0.5f) / 16.0f)) - firstChunkX + 1;
+    int chunksZ = static_cast<int>(std::floor(((expandedMin.z + expandedSize.z) * voxel - 0.5f) / 16.0f)) - firstChunkZ + 1;
+    std::vector<glm::vec2> chunkRanges(static_cast<size_t>(chunksX) * chunksZ);
+    for (int z = 0; z < chunksZ; z++) {
+        for (int x = 0; x < chunksX; x++) {
+            glm::vec2& range = chunkRanges[z * chunksX + x];
+            if (!terrain.ChunkHeightRange(firstChunkX + x, firstChunkZ + z, range.x, range.y)) {
+                range = glm::vec2(1.0f, 0.0f);
+            }
+        }
+    }
+    std::vector<glm::vec2> columnRanges(static_cast<size_t>(expandedSize.x) * expandedSize.z, glm::vec2(1.0f, 0.0f));
+    for (int z = 0; z < expandedSize.z; z++) {
+        for (int x = 0; x < expandedSize.x; x++) {
+            glm::vec2& range = columnRanges[z * expandedSize.x + x];
+            int chunkX0 = static_cast<int>(std::floor((expandedMin.x + x) * voxel / 16.0f)) - firstChunkX;
+            int chunkZ0 = static_cast<int>(std::floor((expandedMin.z + z) * voxel / 16.0f)) - firstChunkZ;
+            int chunkX1 = static_cast<int>(std::floor(((expandedMin.x + x + 1) * voxel - 0.5f) / 16.0f)) - firstChunkX;
+            int chunkZ1 = static_cast<int>(std::floor(((expandedMin.z + z + 1) * voxel - 0.5f) / 16.0f)) - firstChunkZ;
+            for (int cz = chunkZ0; cz <= chunkZ1; cz++) {
+                for (int cx = chunkX0; cx <= chunkX1; cx++) {
+                    const glm::vec2& chunk = chunkRanges[cz * chunksX + cx];
+                    if (chunk.x > chunk.y) continue;
+                    range = range.x > range.y ? chunk : glm::vec2(std::min(range.x, chunk.x), std::max(range.y, chunk.y));
+                }
+            }
+        }
+    }
+
+    // Voxels that can hold terrain seed the distance transform: inside a
+    // column's y-range and not proven empty by the Lipschitz bound. The
+    // density is only evaluated there.
+    std::vector<float> density(count, 0.0f);
+    std::vector<double> field(count, FAR);
+    size_t index = 0;
+    for (int z = 0; z < expandedSize.z; z++) {
+        for (int y = 0; y < expandedSize.y; y++) {
+            float low = (expandedMin.y + y) * voxel;
+            for (int x = 0; x < expandedSize.x; x++, index++) {
+                const glm::vec2& range = columnRanges[z * expandedSize.x + x];
+                if (low > range.y || low + voxel < range.x) continue;
+                float d = terrain.Density((expandedMin.x + x + 0.5f) * voxel,
+                                          (expandedMin.y + y + 0.5f) * voxel,
+                                          (expandedMin.z + z + 0.5f) * voxel);
+                density[index] = d;
+                if (d > -lipschitz * halfDiagonal) field[index] = 0.0;
+            }
+        }
+    }
+
+    DistanceTransform3D(field, expandedSize);
+
+    box.values.resize(static_cast<size_t>(box.size.x) * box.size.y * box.size.z);
+    float* out = box.values.data();
+    for (int z = 0; z < box.size.z; z++) {
+        for (int y = 0; y < box.size.y; y++) {
+            for (int x = 0; x < box.size.x; x++) {
+                size_t source = ((static_cast<size_t>(z) + band) * expandedSize.y + y + band) * expandedSize.x + x + band;
+                float bound = -density[source] / lipschitz;
+                if (field[source] > 0.0) {
+                    // Nothing closer than the nearest possibly solid voxel, less its half diagonal
+                    float voxels = std::min(static_cast<float>(std::sqrt(field[source])), static_cast<float>(band));
+                    bound = std::max(bound, voxels * voxel - halfDiagonal);
+                }
+                // Trilinear weights put at most a half diagonal between a
+                // point and its corners on average, so any blend stays a lower bound
+                *out++ = bound - halfDiagonal;
+            }
+        }
+    }
+}
+
+void SdfClipmap::Upload(int level, const Box& box) {
+    Level& target = levels[level];
+    if (target.texture == 0) {
+        glGenTextures(1, &target.texture);
+        glBindTexture(GL_TEXTURE_3D, target.texture);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, resolution, resolution, resolution, 0, GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_REPEAT);
+    }
+    glBindTexture(GL_TEXTURE_3D, target.texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, box.size.x);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, box.size.y);
+
+    // Texel = world voxel mod resolution, so the box may wrap: up to two pieces per axis
+    int start[3], first[3];
+    for (int axis = 0; axis < 3; axis++) {
+        start[axis] = ((box.min[axis] % resolution) + resolution) % resolution;
+        first[axis] = std::min(box.size[axis], resolution - start[axis]);
+    }
+    for (int piece = 0; piece < 8; piece++) {
+        int skip[3], offset[3], size[3];
+        bool empty = false;
+        for (int axis = 0; axis < 3; axis++) {
+            bool wrapped = (piece >> axis) & 1;
+            skip[axis] = wrapped ? first[axis] : 0;
+            offset[axis] = wrapped ? 0 : start[axis];
+            size[axis] = wrapped ? box.size[axis] - first[axis] : first[axis];
+            empty = empty || size[axis] <= 0;
+        }
+        if (empty) continue;
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, skip[0]);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, skip[1]);
+        glPixelStorei(GL_UNPACK_SKIP_IMAGES, skip[2]);
+        glTexSubImage3D(GL_TEXTURE_3D, 0, offset[0], offset[1], offset[2], size[0], size[1], size[2],
+                        GL_RED, GL_FLOAT, box.values.data());
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_IMAGES, 0);
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+void SdfClipmap::Update(const glm::vec3& cameraPos, int octaves, float lipschitz) {
+    lipschitz = std::max(lipschitz, 0.01f);
+    if (octaves != this->octaves || lipschitz != this->lipschitz) {
+        this->octaves = octaves;
+        this->lipschitz = lipschitz;
+        generation++;
+        for (Level& level : levels) {
+            level.valid = false;
+        }
+    }
+
+    for (int k = 0; k < LEVELS; k++) {
+        Level& level = levels[k];
+        if (level.baking && level.ready.load(std::memory_order_acquire)) {
+            // Bakes for outdated parameters are dropped, the level rebakes in full below
+            if (level.generation == generation) {
+                for (const Box& box : level.pending) {
+                    Upload(k, box);
+                }
+                level.origin = level.pendingOrigin;
+                level.valid = true;
+            }
+            level.pending.clear();
+            level.ready.store(false, std::memory_order_relaxed);
+            level.baking = false;
+        }
+        if (level.baking) continue;
+
+        glm::ivec3 target = TargetOrigin(k, cameraPos);
+        if (level.valid && target == level.origin) continue;
+
+        // Only voxels the level did not cover before need baking, peeled off one axis at a time
+        std::vector<Box> boxes;
+        glm::ivec3 shift = target - level.origin;
+        bool full = !level.valid;
+        for (int axis = 0; axis < 3; axis++) {
+            full = full || std::abs(shift[axis]) >= resolution;
+        }
+        if (full) {
+            boxes.push_back({target, glm::ivec3(resolution), {}});
+        } else {
+            glm::ivec3 low = target;
+            glm::ivec3 high = target + glm::ivec3(resolution);
+            for (int axis = 0; axis < 3; axis++) {
+                if (shift[axis] == 0) continue;
+                Box box{low, high - low, {}};
+                if (shift[axis] > 0) {
+                    box.min[axis] = level.origin[axis] + resolution;
+                    box.size[axis] = shift[axis];
+                    high[axis] = level.origin[axis] + resolution;
+                } else {
+                    box.size[axis] = -shift[axis];
+                    low[axis] = level.origin[axis];
+                }
+                boxes.push_back(box);
+            }
+        }
+
+        level.baking = true;
+        level.generation = generation;
+        level.pendingOrigin = target;
+        level.pending = std::move(boxes);
+        pool.Submit([this, k, octaves, lipschitz, full]() {
+            auto start = std::chrono::steady_clock::now();
+            for (Box& box : levels[k].pending) {
+                Bake(box, k, octaves, lipschitz);
+            }
+            if (full) {
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                LOG_INFOF("Baked SDF clipmap level {} in {:.1f} ms", k, ms);
+            }
+            levels[k].ready.store(true, std::memory_order_release);
+        });
+    }
+}
+
+bool SdfClipmap::IsValid() const {
+    for (const Level& level : levels) {
+        if (!level.valid) return false;
+    }
+    return true;
+}
+
+void SdfClipmap::Bind(GLuint firstUnit) const {
+    for (int k = 0; k < LEVELS; k++) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + k);
+        glBindTexture(GL_TEXTURE_3D, levels[k].texture);
+    }
+}
+
+void SdfClipmap::Delete() {
+    pool.WaitIdle();
+    for (Level& level : levels) {
+        if (level.texture != 0) {
+            glDeleteTextures(1, &level.texture);
+            level.texture = 0;
+        }
+        level.valid = false;
+        level.baking = false;
+        level.pending.clear();
+        level.ready.store(false, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,83 @@
+#include "../include/ThreadPool.h"
+#include "../include/Profiler.h"
+
+ThreadPool::ThreadPool(int threadCount, const std::string& name) : activeJobs(0), stopping(false) {
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        if (threadCount < 1) {
+            threadCount = 1;
+        }
+    }
+
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, name + " " + std::to_string(i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    Shutdown();
+}
+
+void ThreadPool::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobCondition.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idleCondition.wait(lock, [this] { return jobs.empty() && activeJobs == 0; });
+}
+
+int ThreadPool::GetPendingJobs() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(jobs.size()) + activeJobs;
+}
+
+void ThreadPool::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+        jobs.clear();
+    }
+    jobCondition.notify_all();
+    idleCondition.notify_all();
+
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop(std::string name) {
+    Profiler::SetThreadName(name);
+
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                break;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            activeJobs++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeJobs--;
+        }
+        idleCondition.notify_all();
+    }
+}
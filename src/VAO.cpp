@@ -1,8 +1,17 @@
 #include "../include/VAO.h"
+#include "../include/GLDebug.h"
 
 VAO::VAO(){
     glGenVertexArrays(1, &ID);
 
+#ifndef NDEBUG
+    // The object only exists once bound, keep the caller's binding
+    GLint previous = 0;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous);
+    glBindVertexArray(ID);
+    GL_OBJECT_LABEL(GL_VERTEX_ARRAY, ID, "VAO " + std::to_string(ID));
+    glBindVertexArray(previous);
+#endif
 }
 
 void VAO::LinkAttrib(VBO VBO, GLuint layout, GLuint numComponents, GLuint type, GLuint stride, void* offset){
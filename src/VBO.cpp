@@ -1,9 +1,11 @@
 #include "../include/VBO.h"
+#include "../include/GLDebug.h"
 
 VBO::VBO(GLfloat* vertices, GLsizeiptr size){
     glGenBuffers(1, &ID);
     glBindBuffer(GL_ARRAY_BUFFER, ID);
     glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+    GL_OBJECT_LABEL(GL_BUFFER, ID, "VBO " + std::to_string(ID) + " (" + std::to_string(size) + " bytes)");
 }
 
 void VBO::Bind(){
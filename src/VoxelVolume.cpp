@@ -0,0 +1,128 @@
+#include "../include/VoxelVolume.h"
+#include "../include/Logger.h"
+#include "../include/Profiler.h"
+#include <algorithm>
+
+// Definition for LOG_INFOF, which binds it to a reference
+const int VoxelVolume::WINDOW;
+
+// Texels per column at each level
+static const int BLOCK_TEXELS = ChunkSection::SIZE / 2;
+static const int BLOCK_TEXELS_Y = VoxelVolume::SECTIONS * ChunkSection::SIZE / 2;
+static const int CELL_TEXELS = ChunkSection::SIZE / 4;
+static const int CELL_TEXELS_Y = VoxelVolume::SECTIONS * ChunkSection::SIZE / 4;
+
+VoxelVolume::VoxelVolume() :
+    blockTexture(0),
+    cellTexture(0),
+    sectionTexture(0),
+    blocks(BLOCK_TEXELS * BLOCK_TEXELS_Y * BLOCK_TEXELS),
+    cells(CELL_TEXELS * CELL_TEXELS_Y * CELL_TEXELS) {
+}
+
+static GLuint createLevel(int width, int height, int depth) {
+    // Zero-filled so slots never written read as empty
+    std::vector<uint8_t> zeros(static_cast<size_t>(width) * height * depth, 0);
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_3D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_R8UI, width, height, depth, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, zeros.data());
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return texture;
+}
+
+void VoxelVolume::Create() {
+    if (blockTexture != 0) {
+        return;
+    }
+    blockTexture = createLevel(WINDOW * BLOCK_TEXELS, BLOCK_TEXELS_Y, WINDOW * BLOCK_TEXELS);
+    cellTexture = createLevel(WINDOW * CELL_TEXELS, CELL_TEXELS_Y, WINDOW * CELL_TEXELS);
+    sectionTexture = createLevel(WINDOW, SECTIONS, WINDOW);
+    glBindTexture(GL_TEXTURE_3D, 0);
+    size_t bytes = static_cast<size_t>(WINDOW) * WINDOW *
+                   (blocks.size() + cells.size() + SECTIONS);
+    LOG_INFOF("Voxel volume {}x{} columns ({} KB)", WINDOW, WINDOW, bytes / 1024);
+}
+
+void VoxelVolume::Upload(int chunkX, int chunkZ) {
+    int slotX = chunkX & (WINDOW - 1);
+    int slotZ = chunkZ & (WINDOW - 1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_3D, blockTexture);
+    glTexSubImage3D(GL_TEXTURE_3D, 0, slotX * BLOCK_TEXELS, 0, slotZ * BLOCK_TEXELS,
+                    BLOCK_TEXELS, BLOCK_TEXELS_Y, BLOCK_TEXELS, GL_RED_INTEGER, GL_UNSIGNED_BYTE, blocks.data());
+    glBindTexture(GL_TEXTURE_3D, cellTexture);
+    glTexSubImage3D(GL_TEXTURE_3D, 0, slotX * CELL_TEXELS, 0, slotZ * CELL_TEXELS,
+                    CELL_TEXELS, CELL_TEXELS_Y, CELL_TEXELS, GL_RED_INTEGER, GL_UNSIGNED_BYTE, cells.data());
+    glBindTexture(GL_TEXTURE_3D, sectionTexture);
+    glTexSubImage3D(GL_TEXTURE_3D, 0, slotX, 0, slotZ, 1, SECTIONS, 1, GL_RED_INTEGER, GL_UNSIGNED_BYTE, sections);
+    glBindTexture(GL_TEXTURE_3D, 0);
+}
+
+void VoxelVolume::WriteColumn(int chunkX, int chunkZ, const std::vector<ChunkSection>& columnSections) {
+    PROFILE_ZONE("voxel column write");
+    std::fill(blocks.begin(), blocks.end(), 0);
+    std::fill(cells.begin(), cells.end(), 0);
+    for (int s = 0; s < SECTIONS; s++) {
+        const ChunkSection& section = columnSections[s];
+        sections[s] = 0;
+        if (section.IsSingleValue()) {
+            if (section.GetIndex(0) == ChunkSection::AIR) continue;
+            // Solid throughout, fill the section's texels directly
+            sections[s] = 1;
+            for (int z = 0; z < BLOCK_TEXELS; z++) {
+                for (int y = 0; y < BLOCK_TEXELS; y++) {
+                    uint8_t* row = &blocks[(z * BLOCK_TEXELS_Y + s * BLOCK_TEXELS + y) * BLOCK_TEXELS];
+                    std::fill(row, row + BLOCK_TEXELS, 0xFF);
+                }
+            }
+            for (int z = 0; z < CELL_TEXELS; z++) {
+                for (int y = 0; y < CELL_TEXELS; y++) {
+                    uint8_t* row = &cells[(z * CELL_TEXELS_Y + s * CELL_TEXELS + y) * CELL_TEXELS];
+                    std::fill(row, row + CELL_TEXELS, 1);
+                }
+            }
+            continue;
+        }
+        section.ForEach([&](int index, ChunkSection::BlockId block) {
+            if (block == ChunkSection::AIR) return;
+            int x = index & 15;
+            int z = (index >> 4) & 15;
+            int y = s * ChunkSection::SIZE + (index >> 8);
+            int bit = (x & 1) | ((y & 1) << 1) | ((z & 1) << 2);
+            blocks[((z >> 1) * BLOCK_TEXELS_Y + (y >> 1)) * BLOCK_TEXELS + (x >> 1)] |= static_cast<uint8_t>(1 << bit);
+            cells[((z >> 2) * CELL_TEXELS_Y + (y >> 2)) * CELL_TEXELS + (x >> 2)] = 1;
+            sections[s] = 1;
+        });
+    }
+    Upload(chunkX, chunkZ);
+}
+
+void VoxelVolume::ClearColumn(int chunkX, int chunkZ) {
+    std::fill(blocks.begin(), blocks.end(), 0);
+    std::fill(cells.begin(), cells.end(), 0);
+    std::fill(sections, sections + SECTIONS, 0);
+    Upload(chunkX, chunkZ);
+}
+
+void VoxelVolume::Bind(GLuint firstUnit) const {
+    glActiveTexture(GL_TEXTURE0 + firstUnit);
+    glBindTexture(GL_TEXTURE_3D, blockTexture);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+    glBindTexture(GL_TEXTURE_3D, cellTexture);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 2);
+    glBindTexture(GL_TEXTURE_3D, sectionTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void VoxelVolume::Delete() {
+    GLuint textures[3] = {blockTexture, cellTexture, sectionTexture};
+    if (blockTexture != 0) {
+        glDeleteTextures(3, textures);
+    }
+    blockTexture = 0;
+    cellTexture = 0;
+    sectionTexture = 0;
+}
@@ -11,13 +11,35 @@
 #include "../include/VAO.h"
 #include "../include/VBO.h"
 #include "../include/EBO.h"
+#include "../include/AllocTracker.h"
 #include "../include/Logger.h"
+#include "../include/GLDebug.h"
 #include "../include/ImGuiManager.h"
 #include "../include/Camera.h"
+#include "../include/FrameCapture.h"
+#include "../include/FrameTelemetry.h"
+#include "../include/GpuProfiler.h"
+#include "../include/Profiler.h"
+#include "../include/Camera2D.h"
+#include "../include/EndTerrain.h"
+#include "../include/MapTileCache.h"
+#include "../include/MapRenderer.h"
+#include "../include/EndRenderer.h"
+#include "../include/BlockRenderer.h"
+#include "../include/CameraPath.h"
+#include "../include/ReplayBenchmark.h"
+#include "../include/RaymarchPresets.h"
+#include "../include/RaymarchTuner.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <vector>
 
 // Error callback for GLFW
 void errorCallback(int error, const char* description) {
-    LOG_ERROR(std::string("GLFW Error ") + std::to_string(error) + ": " + description);
+    LOG_ERRORF("GLFW Error {}: {}", error, description);
 }
 
 // Handle window resize
@@ -25,10 +47,53 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Command line:
+    //   --record <file>   record the End camera pose every frame, saved on exit
+    //   --replay <file|orbit|dash>   replay a flight with fixed timesteps and report frame times
+    //   --tune <flight,flight,...>   sweep raymarch settings over the flights and write presets
+    //   --binary-log      write logs/<name>.blog instead of the text log (see log_decode)
+    //   --alloc-assert    assert on heap allocations inside NO_ALLOC_SCOPE regions (debug builds)
+    //   --ray-cost        count raymarch steps per ray (replay results gain a ray_cost section)
+    std::string recordPath;
+    std::string replaySource;
+    std::vector<std::string> tuneFlights;
+    bool binaryLog = false;
+    bool rayCost = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replaySource = argv[++i];
+        } else if (std::strcmp(argv[i], "--binary-log") == 0) {
+            binaryLog = true;
+        } else if (std::strcmp(argv[i], "--alloc-assert") == 0) {
+            AllocTracker::SetAssertOnViolation(true);
+        } else if (std::strcmp(argv[i], "--ray-cost") == 0) {
+            rayCost = true;
+        } else if (std::strcmp(argv[i], "--tune") == 0 && i + 1 < argc) {
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = std::min(list.find(',', start), list.size());
+                if (comma > start) {
+                    tuneFlights.push_back(list.substr(start, comma - start));
+                }
+                start = comma + 1;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--record <file>] [--replay <file|orbit|dash>] [--tune <flight,...>] [--binary-log] [--alloc-assert] [--ray-cost]" << std::endl;
+            return -1;
+        }
+    }
+
     // Initialize Logger first
     Logger* logger = Logger::getInstance();
     logger->enableColors(true);
+    if (binaryLog) {
+        logger->setFileFormat(Logger::FileFormat::BINARY);
+    }
 
     if (!logger->init()) {
         std::cerr << "Failed to initialize logger!" << std::endl;
@@ -36,6 +101,7 @@ int main() {
     }
 
     LOG_INFO("Application starting...");
+    Profiler::SetThreadName("main");
 
     // Initialize GLFW
     if (!glfwInit()) {
@@ -51,6 +117,9 @@ int main() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifndef NDEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+#endif
 
     // Create a window
     LOG_INFO("Creating window...");
@@ -80,6 +149,7 @@ int main() {
     LOG_INFO(std::string("OpenGL Version: ") + (const char*)glGetString(GL_VERSION));
     LOG_INFO(std::string("GLEW Version: ") + (const char*)glewGetString(GLEW_VERSION));
     LOG_INFO(std::string("GLFW Version: ") + glfwGetVersionString());
+    GLDebug::Initialize();
 
     // Setup ImGui
     ImGuiManager imguiManager(window);
@@ -128,16 +198,113 @@ int main() {
     float scale = 1.0f;
     float clearColor[4] = {0.2f, 0.3f, 0.3f, 1.0f};
     bool showDemoWindow = false;
+    bool showGpuProfiler = false;
+    bool showTelemetry = false;
+    bool showAllocations = false;
 
     glEnable(GL_DEPTH_TEST);
 
     Camera camera(windowHeight, windowWidth, glm::vec3(0.0f, 0.0f, 2.0f));
 
+    // Frame capture (F12 = screenshot, F9 = start/stop PNG sequence)
+    FrameCapture frameCapture;
+    int captureFormat = 0; // 0 = PNG sequence, 1 = Y4M video
+    bool screenshotKeyDown = false;
+    bool recordKeyDown = false;
+    bool traceKeyDown = false;  // F8 = export the last seconds of CPU zones
+
+    // Top-down End map (view mode 1)
+    int viewMode = 0; // 0 = scene, 1 = End map
+    Camera2D mapCamera(windowHeight, windowWidth);
+    mapCamera.SetZoom(0.25f);
+    EndTerrain mapTerrain;
+    MapTileCache mapTileCache(mapTerrain);
+    MapRenderer mapRenderer(mapTileCache);
+    double lastFrameTime = glfwGetTime();
+
+    // End raymarch view (view mode 2)
+    EndRenderer endRenderer(windowHeight, windowWidth);
+    Camera endCamera(windowHeight, windowWidth, glm::vec3(0.0f, 120.0f, 320.0f));
+    endCamera.Orientation = glm::normalize(glm::vec3(0.0f, -0.3f, -1.0f));
+    endCamera.speed = 1.0f;
+    float endTime = 0.0f;
+    RaymarchPresets raymarchPresets;
+    raymarchPresets.Load();
+    int selectedPreset = -1;
+    uint64_t rayCostSeen = 0;
+
+    // Greedy-meshed block view of the End (view mode 3), flown with the End camera
+    BlockRenderer blockRenderer;
+
+    // Per-pass GPU timings (raymarch/upsample come from EndRenderer)
+    GpuProfiler gpuProfiler;
+    endRenderer.profiler = &gpuProfiler;
+    blockRenderer.profiler = &gpuProfiler;
+    uint64_t gpuFramesSeen = 0;
+
+    // Frame-time percentiles and hitches, appended to telemetry/frames.jsonl
+    FrameTelemetry telemetry;
+    telemetry.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+
+    // Offline raymarch tuning replaces the interactive session
+    if (!tuneFlights.empty()) {
+        glfwSwapInterval(0);
+        RaymarchTuner tuner(window, endRenderer);
+        if (tuner.Run(tuneFlights, raymarchPresets)) {
+            LOG_INFO("Raymarch presets written to " + std::string(RaymarchPresets::DEFAULT_PATH));
+        }
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+    }
+
+    // Camera flight recording
+    CameraPath recordedPath;
+    bool recordingPath = !recordPath.empty();
+    if (recordPath.empty()) {
+        recordPath = "flight.ecp";
+    }
+
+    // Deterministic replay benchmark
+    std::unique_ptr<ReplayBenchmark> replay;
+    if (!replaySource.empty()) {
+        CameraPath replayPath;
+        if (!CameraPath::Resolve(replaySource, replayPath)) {
+            LOG_FATAL("Could not load replay: " + replaySource);
+            glfwTerminate();
+            return -1;
+        }
+        std::string replayName = std::filesystem::path(replaySource).stem().string();
+        replay = std::make_unique<ReplayBenchmark>(replayPath, replayName);
+        if (rayCost) {
+            // Counters only, the replay still renders the normal image
+            endRenderer.measureCost = true;
+            endRenderer.costView = RaymarchCostView::SHADED;
+        }
+        viewMode = 2;
+        recordingPath = false;
+        glfwSwapInterval(0); // Measure the renderer, not vsync
+        LOG_INFO("Replaying '" + replayName + "' (" + std::to_string(replayPath.GetFrameCount()) + " frames)");
+    }
+
     // Main loop
     LOG_INFO("Entering main rendering loop");
     while (!glfwWindowShouldClose(window)) {
+        PROFILE_ZONE("frame");
+        telemetry.BeginFrame();
+
         // Poll events first
-        glfwPollEvents();
+        {
+            PROFILE_ZONE("poll events");
+            glfwPollEvents();
+        }
+
+        if (replay) {
+            replay->BeginFrame(endCamera);
+        }
+        gpuProfiler.BeginFrame();
+        if (gpuProfiler.GetResolvedFrames() != gpuFramesSeen) {
+            gpuFramesSeen = gpuProfiler.GetResolvedFrames();
+            telemetry.RecordGpu(gpuProfiler.GetFrameMs());
+        }
 
         // 1. Render the scene to the backbuffer
         glClearColor(clearColor[0], clearColor[1], clearColor[2], 1.0f);
@@ -148,20 +315,93 @@ int main() {
         glfwGetFramebufferSize(window, &windowWidth, &windowHeight);
         glViewport(0, 0, windowWidth, windowHeight);
 
-        // Render the triangle directly to the backbuffer
-        shader.Activate();
+        double currentTime = glfwGetTime();
+        float deltaTime = static_cast<float>(currentTime - lastFrameTime);
+        lastFrameTime = currentTime;
 
-        camera.Inputs(window);
-        camera.Matrix(45.0f, 0.1f, 100.0f, shader, "camMatrix");
+        gpuProfiler.BeginPass("scene");
+        if (viewMode == 1) {
+            // Top-down map through the 2D camera
+            if (mapCamera.width != windowWidth || mapCamera.height != windowHeight) {
+                mapCamera.SetViewportSize(windowWidth, windowHeight);
+            }
+            mapRenderer.Inputs(window, mapCamera, deltaTime);
+            mapRenderer.Draw(mapCamera);
+        } else if (viewMode == 3) {
+            {
+                PROFILE_ZONE("camera update");
+                endCamera.Inputs(window);
+            }
+            endCamera.width = windowWidth;
+            endCamera.height = windowHeight;
+            blockRenderer.Render(endCamera, windowWidth, windowHeight);
+        } else if (viewMode == 2) {
+            // End terrain raymarch, replay uses a fixed timestep instead of wall time
+            if (replay) {
+                endTime = replay->GetTime();
+            } else {
+                PROFILE_ZONE("camera update");
+                endCamera.Inputs(window);
+                endTime += deltaTime;
+            }
+            if (recordingPath) {
+                recordedPath.Append(endCamera);
+            }
+            endCamera.width = windowWidth;
+            endCamera.height = windowHeight;
+            endRenderer.Render(endCamera, windowWidth, windowHeight, endTime);
+        } else {
+            // Render the triangle directly to the backbuffer
+            shader.Activate();
+
+            {
+                PROFILE_ZONE("camera update");
+                camera.Inputs(window);
+                camera.Matrix(45.0f, 0.1f, 100.0f, shader, "camMatrix");
+            }
 
-        VAO1.Bind();
-        glDrawElements(GL_TRIANGLES, sizeof(indices)/sizeof(int), GL_UNSIGNED_INT, 0);
+            VAO1.Bind();
+            glDrawElements(GL_TRIANGLES, sizeof(indices)/sizeof(int), GL_UNSIGNED_INT, 0);
+        }
+        gpuProfiler.EndPass();
+
+        // Capture hotkeys (edge-triggered)
+        bool screenshotKey = glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS;
+        if (screenshotKey && !screenshotKeyDown) {
+            frameCapture.Screenshot(FrameCapture::TimestampedPath("screenshot") + ".png");
+        }
+        screenshotKeyDown = screenshotKey;
+
+        bool recordKey = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+        if (recordKey && !recordKeyDown) {
+            if (frameCapture.IsRecording()) {
+                frameCapture.StopSequence();
+            } else {
+                frameCapture.StartSequence(FrameCapture::TimestampedPath("sequence"),
+                                           captureFormat == 0 ? FrameCapture::Format::PNG : FrameCapture::Format::Y4M);
+            }
+        }
+        recordKeyDown = recordKey;
+
+        bool traceKey = glfwGetKey(window, GLFW_KEY_F8) == GLFW_PRESS;
+        if (traceKey && !traceKeyDown) {
+            Profiler::ExportChromeTrace(FrameCapture::TimestampedPath("trace") + ".json");
+        }
+        traceKeyDown = traceKey;
+
+        // Capture the scene before ImGui is drawn on top of it
+        gpuProfiler.BeginPass("capture");
+        frameCapture.CaptureFrame(windowWidth, windowHeight);
+        gpuProfiler.EndPass();
 
         // 2. Now render ImGui on top
         imguiManager.BeginFrame();
 
         // Create a control window (floating over the scene)
         {
+            PROFILE_ZONE("imgui build");
+            ALLOC_SCOPE("imgui");
+
             // Position the controls in the top-left corner
             ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
             ImGui::SetNextWindowSize(ImVec2(300, 200), ImGuiCond_FirstUseEver);
@@ -169,14 +409,182 @@ int main() {
             ImGui::Begin("Controls");
 
             ImGui::Text("Renderer Settings");
+            ImGui::RadioButton("Scene", &viewMode, 0);
+            ImGui::SameLine();
+            ImGui::RadioButton("End Map", &viewMode, 1);
+            ImGui::SameLine();
+            ImGui::RadioButton("End", &viewMode, 2);
+            ImGui::SameLine();
+            ImGui::RadioButton("End Blocks", &viewMode, 3);
+
+            if (viewMode == 2) {
+                ImGui::Text("Position: %.1f %.1f %.1f", endCamera.Position.x, endCamera.Position.y, endCamera.Position.z);
+                ImGui::SliderFloat("End Speed", &endCamera.speed, 0.1f, 20.0f);
+                if (!raymarchPresets.presets.empty()) {
+                    const char* preview = selectedPreset >= 0 ? raymarchPresets.presets[selectedPreset].name.c_str() : "Custom";
+                    if (ImGui::BeginCombo("Preset", preview)) {
+                        for (int p = 0; p < static_cast<int>(raymarchPresets.presets.size()); p++) {
+                            const RaymarchPreset& preset = raymarchPresets.presets[p];
+                            char label[96];
+                            std::snprintf(label, sizeof(label), "%s (%.2f ms)", preset.name.c_str(), preset.gpuMs);
+                            if (ImGui::Selectable(label, p == selectedPreset)) {
+                                selectedPreset = p;
+                                endRenderer.settings = preset.settings;
+                            }
+                        }
+                        ImGui::EndCombo();
+                    }
+                }
+                ImGui::SliderInt("Max Steps", &endRenderer.settings.maxSteps, 16, 1024);
+                ImGui::SliderFloat("Step Multiplier", &endRenderer.settings.stepMultiplier, 0.25f, 4.0f);
+                ImGui::SliderInt("Octaves", &endRenderer.settings.octaves, 1, 8);
+                ImGui::SliderInt("Refine Steps", &endRenderer.settings.refineSteps, 0, 8);
+                ImGui::SliderFloat("Render Scale", &endRenderer.settings.renderScale, 0.25f, 1.0f);
+                ImGui::Checkbox("Baked Noise", &endRenderer.settings.bakedNoise);
+                ImGui::Checkbox("Island Grid", &endRenderer.settings.islandGrid);
+                ImGui::Checkbox("SDF Clipmap", &endRenderer.settings.sdfClipmap);
+                if (endRenderer.settings.sdfClipmap) {
+                    ImGui::Checkbox("SDF Shadows + AO", &endRenderer.settings.sdfShadows);
+                }
+                ImGui::Checkbox("Brick Map", &endRenderer.settings.brickMap);
+                if (endRenderer.settings.brickMap) {
+                    const BrickMap& bricks = endRenderer.GetBricks();
+                    ImGui::Text("Slots %d / %d, %d columns, %d in flight, %d evicted",
+                                bricks.GetUsedSlots(), bricks.GetCapacity(), bricks.GetResidentColumns(),
+                                bricks.GetInFlightCount(), bricks.GetEvictedCount());
+                    ImGui::Text("Bricks resident: %d empty, %d full, %d mixed",
+                                bricks.GetEmptyBricks(), bricks.GetFullBricks(), bricks.GetDataBricks());
+                }
+                ImGui::Checkbox("Sphere Trace", &endRenderer.settings.sphereTrace);
+                if (endRenderer.settings.sphereTrace) {
+                    ImGui::SliderFloat("Lipschitz", &endRenderer.settings.lipschitz, 1.0f, 10.0f);
+                    ImGui::SliderFloat("Relaxation", &endRenderer.settings.relaxation, 1.0f, 1.9f);
+                }
+
+                ImGui::Checkbox("Ray Cost", &endRenderer.measureCost);
+                if (endRenderer.measureCost) {
+                    const char* costViews[] = {"Shaded", "Steps", "Density Evals", "Refine Steps"};
+                    int costView = static_cast<int>(endRenderer.costView);
+                    if (ImGui::Combo("Heatmap", &costView, costViews, IM_ARRAYSIZE(costViews))) {
+                        endRenderer.costView = static_cast<RaymarchCostView>(costView);
+                    }
+                    const RaymarchCost& cost = endRenderer.GetCost();
+                    const RaymarchCost::Stats& stats = cost.GetStats();
+                    if (stats.rays > 0) {
+                        double rays = static_cast<double>(stats.rays);
+                        ImGui::Text("Per ray: %.1f steps, %.1f density, %.2f refine",
+                                    stats.steps / rays, stats.densityEvals / rays, stats.refineSteps / rays);
+                        ImGui::Text("%.1f M steps, %.0f%% hit (%s)", stats.steps * 1e-6, 100.0 * stats.hits / rays,
+                                    cost.UsesAtomics() ? "atomics" : "readback");
+                        float bins[RaymarchCost::HISTOGRAM_BINS];
+                        for (int b = 0; b < RaymarchCost::HISTOGRAM_BINS; b++) {
+                            bins[b] = static_cast<float>(stats.histogram[b]);
+                        }
+                        char overlay[48];
+                        std::snprintf(overlay, sizeof(overlay), "steps per ray, 0..%d", stats.maxSteps);
+                        ImGui::PlotHistogram("##steps", bins, RaymarchCost::HISTOGRAM_BINS, 0, overlay, 0.0f, FLT_MAX, ImVec2(0, 60));
+                    } else {
+                        ImGui::TextDisabled("Waiting for counters...");
+                    }
+                }
+
+                if (replay) {
+                    ImGui::Text("Replay frame %zu / %zu", replay->GetFrame(), replay->GetFrameCount());
+                } else if (recordingPath) {
+                    if (ImGui::Button("Stop Flight Recording")) {
+                        recordedPath.Save(recordPath);
+                        recordingPath = false;
+                    }
+                    ImGui::SameLine();
+                    ImGui::Text("%zu poses", recordedPath.GetFrameCount());
+                } else if (ImGui::Button("Record Flight")) {
+                    recordedPath.Clear();
+                    recordingPath = true;
+                }
+            }
+
+            if (viewMode == 3) {
+                ImGui::Text("Position: %.1f %.1f %.1f", endCamera.Position.x, endCamera.Position.y, endCamera.Position.z);
+                ImGui::SliderFloat("End Speed", &endCamera.speed, 0.1f, 20.0f);
+                ImGui::SliderInt("View Radius", &blockRenderer.viewRadius, 2, 48);
+                ImGui::SliderInt("Block Octaves", &blockRenderer.octaves, 1, 8);
+                ImGui::Checkbox("Greedy Meshing", &blockRenderer.greedy);
+                ImGui::Checkbox("Voxel Trace (DDA)", &blockRenderer.voxelTrace);
+                if (blockRenderer.voxelTrace) {
+                    ImGui::SliderInt("Trace Steps", &blockRenderer.maxTraceSteps, 64, 2048);
+                }
+                int quads = blockRenderer.GetQuadCount();
+                ImGui::Text("%d columns, %d in flight, %d sections drawn",
+                            blockRenderer.GetResidentColumns(), blockRenderer.GetInFlightCount(),
+                            blockRenderer.GetDrawnSections());
+                ImGui::Text("%d quads for %d faces (%.1fx), %.2f ms meshing per column",
+                            quads, blockRenderer.GetFaceCount(),
+                            quads > 0 ? static_cast<double>(blockRenderer.GetFaceCount()) / quads : 0.0,
+                            blockRenderer.GetMeshMs());
+                double voxelMB = blockRenderer.GetVoxelBytes() / (1024.0 * 1024.0);
+                double floatMB = blockRenderer.GetVoxelFloatBytes() / (1024.0 * 1024.0);
+                ImGui::Text("Blocks %.2f MB paletted, %.1f MB as density floats (%.0fx)",
+                            voxelMB, floatMB, voxelMB > 0.0 ? floatMB / voxelMB : 0.0);
+            }
+
+            if (viewMode == 1) {
+                double mouseX, mouseY;
+                glfwGetCursorPos(window, &mouseX, &mouseY);
+                glm::vec2 block = MapRenderer::ScreenToBlock(mapCamera, glm::vec2(mouseX, mouseY));
+                ImGui::Text("Cursor: x %.0f  z %.0f", block.x, block.y);
+                ImGui::Text("Level %d, %d visible, %d resident, %d in flight",
+                            mapRenderer.GetLevel(), mapRenderer.GetVisibleTiles(),
+                            mapTileCache.GetResidentCount(), mapTileCache.GetInFlightCount());
+                ImGui::Text("Tiles baked %d, loaded from disk %d",
+                            mapTileCache.GetBakedCount(), mapTileCache.GetLoadedCount());
+            }
             ImGui::SliderFloat("Speed", &camera.speed, 0.01f, 0.1f);
             ImGui::SliderFloat("Sensitivity", &camera.sensitivity, 1.0f, 50.0f);
             ImGui::ColorEdit3("Background", clearColor);
             ImGui::Checkbox("Show ImGui Demo Window", &showDemoWindow);
+            ImGui::Checkbox("Show GPU Profiler", &showGpuProfiler);
+            ImGui::SameLine();
+            ImGui::Checkbox("Telemetry", &showTelemetry);
+            ImGui::SameLine();
+            ImGui::Checkbox("Allocations", &showAllocations);
+            ImGui::SameLine();
+            if (ImGui::Button("CPU Trace (F8)")) {
+                Profiler::ExportChromeTrace(FrameCapture::TimestampedPath("trace") + ".json");
+            }
+
+            if (ImGui::Button("Screenshot (F12)")) {
+                frameCapture.Screenshot(FrameCapture::TimestampedPath("screenshot") + ".png");
+            }
+            ImGui::SameLine();
+            if (frameCapture.IsRecording()) {
+                if (ImGui::Button("Stop Recording (F9)")) {
+                    frameCapture.StopSequence();
+                }
+                ImGui::SameLine();
+                ImGui::Text("%d frames, %d dropped", frameCapture.GetRecordedFrames(), frameCapture.GetDroppedFrames());
+            } else {
+                if (ImGui::Button("Record (F9)")) {
+                    frameCapture.StartSequence(FrameCapture::TimestampedPath("sequence"),
+                                               captureFormat == 0 ? FrameCapture::Format::PNG : FrameCapture::Format::Y4M);
+                }
+                ImGui::SameLine();
+                ImGui::RadioButton("PNG", &captureFormat, 0);
+                ImGui::SameLine();
+                ImGui::RadioButton("Y4M", &captureFormat, 1);
+            }
 
             ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
                         1000.0f / ImGui::GetIO().Framerate,
                         ImGui::GetIO().Framerate);
+            if (gpuProfiler.enabled) {
+                ImGui::Text("GPU average %.3f ms/frame", gpuProfiler.GetAverageFrameMs());
+            }
+            const FrameTelemetry::WindowStats& recent = telemetry.GetShortWindow();
+            ImGui::Text("Last %d s: p99 %.2f ms, max %.2f ms, %llu hitches", recent.seconds,
+                        recent.present.p99, recent.present.max, static_cast<unsigned long long>(recent.hitches));
+            ImGui::Text("Heap: %llu allocations, %llu bytes last frame",
+                        static_cast<unsigned long long>(AllocTracker::GetFrameAllocations()),
+                        static_cast<unsigned long long>(AllocTracker::GetFrameBytes()));
 
             ImGui::End();
 
@@ -184,22 +592,65 @@ int main() {
             if (showDemoWindow) {
                 ImGui::ShowDemoWindow(&showDemoWindow);
             }
+            if (showGpuProfiler) {
+                gpuProfiler.DrawWindow(&showGpuProfiler);
+            }
+            if (showTelemetry) {
+                telemetry.DrawWindow(&showTelemetry);
+            }
+            if (showAllocations) {
+                AllocTracker::DrawWindow(&showAllocations);
+            }
         }
 
         // End ImGui frame and render it
         imguiManager.EndFrame();
+        gpuProfiler.BeginPass("imgui");
         imguiManager.Render();
+        gpuProfiler.EndPass();
+        gpuProfiler.EndFrame();
+
+        if (replay) {
+            if (endRenderer.GetCost().GetSampleCount() != rayCostSeen) {
+                rayCostSeen = endRenderer.GetCost().GetSampleCount();
+                replay->AddRayCost(endRenderer.GetCost().GetStats());
+            }
+            replay->EndFrame();
+            if (replay->IsFinished()) {
+                replay->Finish();
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+            }
+        }
 
         // Swap buffers
-        glfwSwapBuffers(window);
+        AllocTracker::EndFrame();
+        telemetry.EndFrame();
+        {
+            PROFILE_ZONE("swap buffers");
+            glfwSwapBuffers(window);
+        }
+        telemetry.Presented();
     }
 
     // Clean up
     LOG_INFO("Cleaning up resources...");
+    frameCapture.Shutdown();
     VAO1.Delete();
     VBO1.Delete();
     EBO1.Delete();
     shader.Delete();
+    mapRenderer.Delete();
+    endRenderer.Delete();
+    blockRenderer.Delete();
+    gpuProfiler.Delete();
+    telemetry.Flush();
+    if (replay) {
+        replay->Delete();
+    }
+    if (recordingPath && recordedPath.GetFrameCount() > 0) {
+        recordedPath.Save(recordPath);
+    }
+    mapTileCache.Shutdown();
 
     // Shut down ImGui
     imguiManager.Shutdown();
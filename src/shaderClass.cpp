@@ -1,4 +1,5 @@
 #include "../include/shaderClass.h"
+#include "../include/GLDebug.h"
 
 std::string get_file_contents(const char* filename){
 std::ifstream in(filename, std::ios::binary);
@@ -14,9 +15,26 @@ if(in){
 throw(errno);
 }
 
-Shader::Shader(const char* vertexFile, const char* fragmentFile){
-    std::string vertexCode = get_file_contents(vertexFile);
-    std::string fragmentCode = get_file_contents(fragmentFile);
+static std::string applyPreamble(const std::string& source, const std::string& preamble){
+    if(preamble.empty()){
+        return source;
+    }
+    size_t lineEnd = source.find('\n');
+    if(source.compare(0, 8, "#version") != 0 || lineEnd == std::string::npos){
+        return preamble + source;
+    }
+    if(preamble.compare(0, 8, "#version") == 0){
+        return preamble + source.substr(lineEnd + 1);
+    }
+    return source.substr(0, lineEnd + 1) + preamble + source.substr(lineEnd + 1);
+}
+
+Shader::Shader(const char* vertexFile, const char* fragmentFile) : Shader(vertexFile, fragmentFile, std::string()){
+}
+
+Shader::Shader(const char* vertexFile, const char* fragmentFile, const std::string& preamble){
+    std::string vertexCode = applyPreamble(get_file_contents(vertexFile), preamble);
+    std::string fragmentCode = applyPreamble(get_file_contents(fragmentFile), preamble);
 
     const char* vertexSource = vertexCode.c_str();
     const char* fragmentSource = fragmentCode.c_str();
@@ -36,6 +54,7 @@ Shader::Shader(const char* vertexFile, const char* fragmentFile){
    glAttachShader(ID, fragmentShader);
 
    glLinkProgram(ID);
+   GL_OBJECT_LABEL(GL_PROGRAM, ID, std::string(vertexFile) + " + " + fragmentFile);
 
    //for some reason a guy in the guide told me that the shaders are already in the program, and we can delete them
    glDeleteShader(vertexShader);
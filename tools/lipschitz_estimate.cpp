@@ -0,0 +1,277 @@
+#include "../include/EndTerrain.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// Usage: lipschitz_estimate [--samples N] [--rays N] [--octaves N] [--h D]
+//                           [--safety F] [--relaxation W] [--lipschitz L]
+// Estimates a Lipschitz bound of EndTerrain::Density (largest |dDensity| per
+// block) from finite differences at random points, then validates it by
+// sphere tracing random rays against a fine reference march. The bound goes
+// into RaymarchSettings::lipschitz. --lipschitz skips the estimate and only
+// validates the given value.
+
+static const float PI = 3.14159265f;
+
+// Smallest step at distance 0, grows by 0.1% per block like the shader
+static const float MIN_STEP = 1.0f;
+
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    float Next() {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<float>(state >> 40) / 16777216.0f;
+    }
+
+    float Range(float low, float high) { return low + (high - low) * Next(); }
+
+    void Direction(float out[3]) {
+        float z = Range(-1.0f, 1.0f);
+        float angle = Range(0.0f, 2.0f * PI);
+        float r = std::sqrt(1.0f - z * z);
+        out[0] = r * std::cos(angle);
+        out[1] = z;
+        out[2] = r * std::sin(angle);
+    }
+
+private:
+    uint64_t state;
+};
+
+enum Region { MAIN_ISLAND, EXCLUSION, OUTER_ISLANDS };
+
+static Region regionOf(float x, float z) {
+    float horizDist = std::sqrt(x * x + z * z);
+    if (horizDist < EndTerrain::EXCLUSION_ZONE_START) return MAIN_ISLAND;
+    if (horizDist < EndTerrain::EXCLUSION_ZONE_END) return EXCLUSION;
+    return OUTER_ISLANDS;
+}
+
+// Random point on the main island or around a random outer island
+static void samplePoint(const EndTerrain& terrain, Random& random, bool outer, float p[3]) {
+    if (!outer) {
+        float r = EndTerrain::MAIN_ISLAND_RADIUS * std::sqrt(random.Next());
+        float angle = random.Range(0.0f, 2.0f * PI);
+        p[0] = r * std::cos(angle);
+        p[1] = random.Range(EndTerrain::MIN_Y, EndTerrain::MAX_Y);
+        p[2] = r * std::sin(angle);
+        return;
+    }
+
+    EndTerrain::Island island;
+    for (;;) {
+        float r = random.Range(EndTerrain::EXCLUSION_ZONE_END + 64.0f, 6000.0f);
+        float angle = random.Range(0.0f, 2.0f * PI);
+        int chunkX = static_cast<int>(std::floor(r * std::cos(angle) / 16.0f));
+        int chunkZ = static_cast<int>(std::floor(r * std::sin(angle) / 16.0f));
+        if (terrain.IslandForChunk(chunkX, chunkZ, island)) break;
+    }
+    float r = island.radius * 1.5f * std::sqrt(random.Next());
+    float angle = random.Range(0.0f, 2.0f * PI);
+    p[0] = island.centerX + r * std::cos(angle);
+    p[1] = random.Range(EndTerrain::SEA_LEVEL - 32.0f, EndTerrain::SEA_LEVEL + 32.0f);
+    p[2] = island.centerZ + r * std::sin(angle);
+}
+
+static float percentile(std::vector<float>& values, double p) {
+    if (values.empty()) return 0.0f;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::min(values.size() - 1, index > 0 ? index - 1 : 0)];
+}
+
+struct TraceResult {
+    bool hit;
+    float tOutside;             // Last point known to be outside
+    int steps;
+    bool boundViolated = false; // A distance bound claimed the true surface was empty space
+};
+
+struct TraceStats {
+    long steps = 0;
+    int outOfSteps = 0;
+    int skips = 0;              // Stepped over terrain (minimum step or heuristic step)
+    int violations = 0;
+
+    void Add(const TraceResult& result, int maxSteps, float surface) {
+        steps += result.steps;
+        if (result.boundViolated) violations++;
+        else if (result.tOutside > surface) skips++;
+        else if (!result.hit && result.steps >= maxSteps) outOfSteps++;
+    }
+
+    void Print(const char* name, int rays) const {
+        std::printf("  %-12s %9.1f  %11.2f%%  %6.2f%%  %9.2f%%\n", name, static_cast<double>(steps) / rays,
+                    100.0 * outOfSteps / rays, 100.0 * skips / rays, 100.0 * violations / rays);
+    }
+};
+
+// Same loop as sphereTrace in end_raymarch.frag (stepMultiplier 1)
+static TraceResult sphereTrace(const EndTerrain& terrain, const float o[3], const float d[3],
+                               float lipschitz, float relaxation, int maxSteps, float maxDistance, float surface) {
+    float t = 0.0f, prevT = 0.0f, prevRadius = 0.0f;
+    float omega = relaxation;
+    bool violated = false;
+    for (int i = 0; i < maxSteps; i++) {
+        float x = o[0] + d[0] * t, y = o[1] + d[1] * t, z = o[2] + d[2] * t;
+        float density = terrain.Density(x, y, z);
+        if (density > 0.0f) return { true, prevT, i + 1, violated };
+
+        float radius = terrain.DistanceBound(x, y, z, density, lipschitz);
+        violated = violated || std::abs(surface - t) < radius - 0.05f;
+        if (omega > 1.0f && radius + prevRadius < t - prevT) {
+            t = prevT + std::max(prevRadius, MIN_STEP * (1.0f + prevT * 0.001f));
+            omega = 1.0f;
+            continue;
+        }
+
+        float minStep = MIN_STEP * (1.0f + t * 0.001f);
+        prevT = t;
+        prevRadius = radius;
+        if (t + std::max(radius, minStep) > maxDistance) return { false, prevT, i + 1, violated };
+        t += std::max(radius * omega, minStep);
+    }
+    return { false, prevT, maxSteps, violated };
+}
+
+// The heuristic march sphere tracing replaces
+static TraceResult heuristicMarch(const EndTerrain& terrain, const float o[3], const float d[3],
+                                  int maxSteps, float maxDistance) {
+    float t = 0.0f, prevT = 0.0f;
+    for (int i = 0; i < maxSteps; i++) {
+        float density = terrain.Density(o[0] + d[0] * t, o[1] + d[1] * t, o[2] + d[2] * t);
+        if (density > 0.0f) return { true, prevT, i + 1 };
+
+        float adaptiveFactor = 1.0f + std::clamp(-density * 0.1f, 0.0f, 5.0f);
+        float distanceFactor = 1.0f + t * 0.001f;
+        prevT = t;
+        t += adaptiveFactor * distanceFactor;
+        if (t > maxDistance) return { false, prevT, i + 1 };
+    }
+    return { false, prevT, maxSteps };
+}
+
+// First crossing with a fine fixed step, -1 if none
+static float referenceHit(const EndTerrain& terrain, const float o[3], const float d[3], float maxDistance) {
+    for (float t = 0.0f; t < maxDistance; t += 0.02f) {
+        if (terrain.Density(o[0] + d[0] * t, o[1] + d[1] * t, o[2] + d[2] * t) > 0.0f) return t;
+    }
+    return -1.0f;
+}
+
+int main(int argc, char** argv) {
+    int samples = 200000;
+    int rays = 2000;
+    int octaves = 4;
+    float h = 0.25f;
+    float safety = 1.2f;
+    float relaxation = 1.6f;
+    float lipschitz = 0.0f;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--samples") == 0 && hasValue) samples = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--rays") == 0 && hasValue) rays = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--octaves") == 0 && hasValue) octaves = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--h") == 0 && hasValue) h = std::strtof(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--safety") == 0 && hasValue) safety = std::strtof(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--relaxation") == 0 && hasValue) relaxation = std::strtof(argv[++i], nullptr);
+        else if (std::strcmp(argv[i], "--lipschitz") == 0 && hasValue) lipschitz = std::strtof(argv[++i], nullptr);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--samples N] [--rays N] [--octaves N] [--h D]"
+                      << " [--safety F] [--relaxation W] [--lipschitz L]" << std::endl;
+            return 1;
+        }
+    }
+
+    EndTerrain terrain(octaves);
+    Random random(0x5eedu);
+
+    if (lipschitz <= 0.0f) {
+        // |D(p + h u) - D(p)| / h never exceeds the Lipschitz constant, so the
+        // largest difference quotient is a lower bound for it. Pairs touching
+        // the piecewise constants (-1 outside islands, 0 past the edge
+        // falloff) or crossing a region boundary are discontinuities the
+        // distance bound handles separately.
+        const char* names[] = {"main island", "outer islands"};
+        float largest = 0.0f;
+        for (int outer = 0; outer < 2; outer++) {
+            std::vector<float> quotients;
+            quotients.reserve(samples);
+            for (int i = 0; i < samples; i++) {
+                float p[3], u[3];
+                samplePoint(terrain, random, outer == 1, p);
+                random.Direction(u);
+                float q[3] = {p[0] + u[0] * h, p[1] + u[1] * h, p[2] + u[2] * h};
+                if (regionOf(p[0], p[2]) != regionOf(q[0], q[2])) continue;
+
+                float a = terrain.Density(p[0], p[1], p[2]);
+                float b = terrain.Density(q[0], q[1], q[2]);
+                if (a == -1.0f || b == -1.0f || (a == 0.0f && b == 0.0f)) continue;
+                quotients.push_back(std::abs(b - a) / h);
+            }
+
+            float p50 = percentile(quotients, 50.0);
+            float p999 = percentile(quotients, 99.9);
+            float max = quotients.empty() ? 0.0f : quotients.back();
+            std::printf("%-14s %7zu pairs  p50 %.3f  p99.9 %.3f  max %.3f\n", names[outer], quotients.size(), p50, p999, max);
+            largest = std::max(largest, max);
+        }
+
+        // Rounded up to 0.05
+        lipschitz = std::ceil(largest * safety * 20.0f) / 20.0f;
+        std::printf("lipschitz = %.2f (max %.3f x safety %.2f)\n", lipschitz, largest, safety);
+    }
+
+    // Rays from above towards surface points, checked against the first
+    // crossing of a fine reference march. A violation is a distance bound
+    // that covered the true surface; a skip is a step over a feature thinner
+    // than the minimum step, which the heuristic march shares.
+    const int maxSteps = 256;
+    const float tolerance = 0.05f;
+    int validRays = 0;
+    TraceStats sphereStats, heuristicStats;
+    for (int i = 0; i < rays; i++) {
+        float target[3];
+        samplePoint(terrain, random, i % 2 == 1, target);
+        EndTerrain::Column column = terrain.SampleColumn(target[0], target[2]);
+        if (!column.solid) continue;
+        target[1] = column.topY;
+
+        float d[3];
+        random.Direction(d);
+        d[1] = -std::abs(d[1]) - 0.1f;
+        float length = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        float distance = random.Range(20.0f, 400.0f);
+        float o[3];
+        for (int k = 0; k < 3; k++) {
+            d[k] /= length;
+            o[k] = target[k] - d[k] * distance;
+        }
+
+        float maxDistance = distance + 50.0f;
+        float tRef = referenceHit(terrain, o, d, maxDistance);
+        if (tRef < 0.0f) continue;
+        validRays++;
+
+        sphereStats.Add(sphereTrace(terrain, o, d, lipschitz, relaxation, maxSteps, maxDistance, tRef),
+                        maxSteps, tRef + tolerance);
+        heuristicStats.Add(heuristicMarch(terrain, o, d, maxSteps, maxDistance), maxSteps, tRef + tolerance);
+    }
+
+    if (validRays == 0) {
+        std::cerr << "No validation rays hit the terrain" << std::endl;
+        return 1;
+    }
+    std::printf("validation: %d rays, relaxation %.2f\n", validRays, relaxation);
+    std::printf("                steps/ray  out of steps   skips  violations\n");
+    sphereStats.Print("sphere trace", validRays);
+    heuristicStats.Print("heuristic", validRays);
+    return 0;
+}
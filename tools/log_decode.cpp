@@ -0,0 +1,102 @@
+#include "../include/BinaryLog.h"
+#include "../include/LogArgs.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+// Usage: log_decode [--json] <file.blog[.gz]>
+// Prints the log in the same layout as the text log files, or as one JSON
+// object per line with --json.
+
+static const char* levelString(uint8_t level) {
+    // Same padding as Logger's plain text output
+    static const char* names[] = {"[DEBUG]  ", "[INFO]   ", "[WARNING]", "[ERROR]  ", "[FATAL]  ", "[TODO]   "};
+    return level < sizeof(names) / sizeof(names[0]) ? names[level] : "[UNKNOWN]";
+}
+
+static const char* levelName(uint8_t level) {
+    static const char* names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "FATAL", "TODO"};
+    return level < sizeof(names) / sizeof(names[0]) ? names[level] : "UNKNOWN";
+}
+
+static std::string jsonEscape(const std::string& text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    for (char c : text) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (path == nullptr) {
+        std::cerr << "Usage: " << argv[0] << " [--json] <file.blog[.gz]>" << std::endl;
+        return 1;
+    }
+
+    BinaryLogReader reader;
+    if (!reader.Open(path)) {
+        std::cerr << "Not a binary log file: " << path << std::endl;
+        return 1;
+    }
+
+    BinaryLogReader::Entry entry;
+    std::string message;
+    size_t count = 0;
+    while (reader.Next(entry)) {
+        LogArgs::Format(entry.format->c_str(), entry.packedArgs, message);
+        count++;
+
+        if (json) {
+            std::cout << "{\"time_ns\": " << entry.wallClockNs
+                      << ", \"monotonic_ns\": " << entry.monotonicNs
+                      << ", \"level\": \"" << levelName(entry.level) << "\"";
+            if (!entry.file->empty()) {
+                std::cout << ", \"file\": \"" << jsonEscape(*entry.file) << "\", \"line\": " << entry.line;
+            }
+            std::cout << ", \"message\": \"" << jsonEscape(message) << "\"}\n";
+            continue;
+        }
+
+        std::time_t seconds = static_cast<std::time_t>(entry.wallClockNs / 1000000000);
+        std::tm localTime = *std::localtime(&seconds);
+        char timestamp[16];
+        std::snprintf(timestamp, sizeof(timestamp), "[%02d:%02d:%02d]", localTime.tm_hour, localTime.tm_min, localTime.tm_sec);
+
+        std::cout << timestamp << " " << levelString(entry.level) << " ";
+        if (!entry.file->empty()) {
+            std::cout << "(" << *entry.file << ":" << entry.line << ") ";
+        }
+        std::cout << message << "\n";
+    }
+
+    std::cerr << count << " records decoded" << std::endl;
+    return 0;
+}